@@ -0,0 +1,108 @@
+/**
+ * @file axis_observer.h
+ * @brief 操舵軸の位置/速度/加速度推定 (固定小数点)
+ *
+ * Core1 が生成する steer 値を制御周期ごとに入力し、条件エフェクト
+ * (Spring/Damper/Inertia/Friction) が必要とする位置・速度・加速度を求める。
+ * 速度・加速度は差分を一次 IIR (シフト演算) で平滑化し、
+ * いずれも -32767..32767 のフルスケールへ正規化して出力する。
+ */
+
+#ifndef AXIS_OBSERVER_H
+#define AXIS_OBSERVER_H
+
+#include <stdint.h>
+
+#define AXIS_Q15_MAX 32767
+
+/**
+ * @brief 条件エフェクトが参照する軸状態 (いずれも -32767..32767)
+ */
+typedef struct {
+  int16_t position;     ///< 位置 (steer そのもの)
+  int16_t velocity;     ///< 速度 (velocity_fullscale でフルスケール)
+  int16_t acceleration; ///< 加速度 (accel_fullscale でフルスケール)
+} ffb_axis_state_t;
+
+class AxisObserver {
+public:
+  /**
+   * @param tick_us update() の呼び出し周期 [us]
+   * @param velocity_fullscale フルスケールとする速度 [steer単位/s]
+   * @param accel_fullscale フルスケールとする加速度 [steer単位/s^2]
+   * @param velocity_shift 速度の平滑化係数 (1/2^shift, 大きいほど平滑)
+   * @param accel_shift 加速度の平滑化係数 (1/2^shift)
+   */
+  AxisObserver(uint32_t tick_us, uint32_t velocity_fullscale,
+               uint32_t accel_fullscale, uint8_t velocity_shift = 2,
+               uint8_t accel_shift = 3)
+      : vel_shift(velocity_shift), acc_shift(accel_shift), prev_position(0),
+        vel_filtered_q8(0), prev_velocity_q8(0), acc_filtered_q8(0),
+        primed(false), state{0, 0, 0} {
+    uint32_t rate_hz = 1000000u / ((tick_us > 0) ? tick_us : 1);
+    // 1周期あたりの差分 -> 正規化値 の係数 (Q16)
+    vel_scale_q16 = ((int64_t)rate_hz * AXIS_Q15_MAX << 16) /
+                    ((velocity_fullscale > 0) ? velocity_fullscale : 1);
+    // 速度 [steer単位/周期] の差分 -> 正規化加速度 の係数 (Q16)
+    acc_scale_q16 = ((int64_t)rate_hz * rate_hz * AXIS_Q15_MAX << 16) /
+                    ((accel_fullscale > 0) ? accel_fullscale : 1);
+  }
+
+  /// @brief 推定値を初期化する (次の update() で位置のみ再取得)
+  void reset() {
+    primed = false;
+    vel_filtered_q8 = 0;
+    prev_velocity_q8 = 0;
+    acc_filtered_q8 = 0;
+    state = ffb_axis_state_t{0, 0, 0};
+  }
+
+  /**
+   * @brief 制御周期ごとに位置を入力し、推定値を更新する
+   * @param position 現在の steer 値 [-32767, 32767]
+   */
+  const ffb_axis_state_t &update(int16_t position) {
+    if (!primed) {
+      prev_position = position;
+      primed = true;
+    }
+    // 速度 [steer単位/周期] (Q8) を平滑化
+    int32_t delta_q8 = ((int32_t)position - prev_position) * 256;
+    prev_position = position;
+    vel_filtered_q8 += (delta_q8 - vel_filtered_q8) >> vel_shift;
+
+    // 加速度 [steer単位/周期^2] (Q8) を平滑化
+    int32_t dv_q8 = vel_filtered_q8 - prev_velocity_q8;
+    prev_velocity_q8 = vel_filtered_q8;
+    acc_filtered_q8 += (dv_q8 - acc_filtered_q8) >> acc_shift;
+
+    state.position = position;
+    state.velocity = saturate((vel_filtered_q8 * vel_scale_q16) >> 24);
+    state.acceleration = saturate((acc_filtered_q8 * acc_scale_q16) >> 24);
+    return state;
+  }
+
+  const ffb_axis_state_t &get() const { return state; }
+
+private:
+  static int16_t saturate(int64_t value) {
+    if (value > AXIS_Q15_MAX)
+      return AXIS_Q15_MAX;
+    if (value < -AXIS_Q15_MAX)
+      return -AXIS_Q15_MAX;
+    return (int16_t)value;
+  }
+
+  uint8_t vel_shift;
+  uint8_t acc_shift;
+  int64_t vel_scale_q16;
+  int64_t acc_scale_q16;
+  int16_t prev_position;
+  int32_t vel_filtered_q8;
+  int32_t prev_velocity_q8;
+  int32_t acc_filtered_q8;
+  bool primed;
+  ffb_axis_state_t state;
+};
+
+#endif // AXIS_OBSERVER_H
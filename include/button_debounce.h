@@ -0,0 +1,113 @@
+/**
+ * @file button_debounce.h
+ * @brief 16 ボタンのビット並列チャタリング除去 (垂直カウンタ) とエッジ検出
+ * @date 2026-10-16
+ *
+ * ボタンごとに「確定状態と異なる値が連続した回数」を数え、設定回数に
+ * 達したら確定状態を反転する。回数は各ボタンのビットを縦に並べた
+ * ビットプレーン (垂直カウンタ) で保持するため、16 ボタン分を数回の
+ * ビット演算でまとめて更新でき、ボタン数に依存しない一定時間で終わる。
+ *
+ * 即時押下 (eager) に指定したボタンは、押下を最初のサンプルで確定し、
+ * 解放のみ設定回数の連続を待つ。シフタのように押下の遅れを減らしたい
+ * ボタン向け。押下直後のチャタリングは解放の確定を待つ間に収まるため
+ * 二重押下にはならないが、1 サンプルだけのノイズも押下として扱われる。
+ */
+
+#ifndef BUTTON_DEBOUNCE_H
+#define BUTTON_DEBOUNCE_H
+
+#include <stdint.h>
+
+#define BUTTON_COUNTER_BITS 5 ///< 垂直カウンタのビット数
+#define BUTTON_DEBOUNCE_MAX_SAMPLES ((1u << BUTTON_COUNTER_BITS) - 1)
+
+class ButtonDebouncer {
+public:
+  /**
+   * @param tick_us update() の呼び出し周期 [us]
+   * @param debounce_us 確定に必要な連続時間 [us]
+   * @param eager_mask 押下を即時に確定するボタン (ビット)
+   */
+  ButtonDebouncer(uint32_t tick_us, uint32_t debounce_us,
+                  uint16_t eager_mask = 0)
+      : period_us(tick_us), eager(eager_mask) {
+    setDebounceTime(debounce_us);
+    reset(0);
+  }
+
+  /// @brief 確定に必要な連続時間を設定する (周期数へ切り上げ, 1..31 周期)
+  void setDebounceTime(uint32_t debounce_us) {
+    uint32_t samples =
+        (period_us > 0) ? (debounce_us + period_us - 1) / period_us : 1;
+    if (samples < 1)
+      samples = 1;
+    else if (samples > BUTTON_DEBOUNCE_MAX_SAMPLES)
+      samples = BUTTON_DEBOUNCE_MAX_SAMPLES;
+    threshold = (uint8_t)samples;
+  }
+  uint8_t debounceSamples() const { return threshold; }
+
+  void setEagerMask(uint16_t eager_mask) { eager = eager_mask; }
+  uint16_t eagerMask() const { return eager; }
+
+  /// @brief 確定状態を state とし、カウンタを 0 にする
+  void reset(uint16_t state) {
+    stable = state;
+    pressed_edges = released_edges = 0;
+    for (uint8_t k = 0; k < BUTTON_COUNTER_BITS; k++)
+      count[k] = 0;
+  }
+
+  /**
+   * @brief 1 サンプル分更新する
+   * @param raw 読み取った値 [1:Pressed, 0:Released]
+   * @return 確定状態
+   */
+  uint16_t update(uint16_t raw) {
+    uint16_t delta = raw ^ stable; // 確定状態と異なるボタン
+
+    // delta のビットのカウンタを +1、それ以外は 0 にする (リプルキャリー)
+    uint16_t carry = delta;
+    for (uint8_t k = 0; k < BUTTON_COUNTER_BITS; k++) {
+      uint16_t bit = count[k];
+      count[k] = (uint16_t)((bit ^ carry) & delta);
+      carry &= bit;
+    }
+
+    // カウンタが threshold に達したボタン
+    uint16_t reached = delta;
+    for (uint8_t k = 0; k < BUTTON_COUNTER_BITS; k++)
+      reached &= (threshold & (1u << k)) ? count[k] : (uint16_t)~count[k];
+
+    // 即時押下: 解放状態で押下を読んだら最初のサンプルで確定する
+    uint16_t toggle = reached | (delta & raw & eager);
+
+    uint16_t prev = stable;
+    stable ^= toggle;
+    for (uint8_t k = 0; k < BUTTON_COUNTER_BITS; k++)
+      count[k] &= (uint16_t)~toggle;
+
+    pressed_edges = stable & (uint16_t)~prev;
+    released_edges = prev & (uint16_t)~stable;
+    return stable;
+  }
+
+  /// @brief 確定状態 [1:Pressed, 0:Released]
+  uint16_t state() const { return stable; }
+  /// @brief 直前の update() で押下が確定したボタン
+  uint16_t pressed() const { return pressed_edges; }
+  /// @brief 直前の update() で解放が確定したボタン
+  uint16_t released() const { return released_edges; }
+
+private:
+  uint32_t period_us;
+  uint16_t eager;
+  uint8_t threshold; ///< 確定に必要な連続サンプル数
+  uint16_t stable;
+  uint16_t pressed_edges;
+  uint16_t released_edges;
+  uint16_t count[BUTTON_COUNTER_BITS]; ///< 垂直カウンタ (count[k] = 第 k ビット)
+};
+
+#endif // BUTTON_DEBOUNCE_H
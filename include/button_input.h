@@ -0,0 +1,42 @@
+/**
+ * @file button_input.h
+ * @brief ボタン (GPIO) の一括読み取り
+ * @date 2026-10-16
+ *
+ * 全 GPIO の入力レベルを1回の読み出し (gpio_get_all()) で取得し、
+ * 登録したピンを custom_gamepad_report_t.buttons のビット順へ並べ替える。
+ * 1回の読み出しで全ボタンを同時刻に取得するため、ボタン間で取得時刻が
+ * ずれない。チャタリング除去は button_debounce.h で行う。
+ *
+ * ボタンはプルアップ入力・押下で Low (GND へ短絡) の接続とする。
+ */
+
+#ifndef BUTTON_INPUT_H
+#define BUTTON_INPUT_H
+
+#include <stdint.h>
+
+#define BUTTON_MAX_COUNT 16 ///< buttons のビット数
+
+/**
+ * @brief ボタンのピンを設定する (読み取りを行うコアで呼ぶ)
+ * @param pins ボタン番号 (ビット位置) 順の GPIO 番号
+ * @param count ボタン数 (BUTTON_MAX_COUNT 以下)
+ */
+bool button_input_begin(const uint8_t *pins, uint8_t count);
+
+/**
+ * @brief 全ボタンの現在値を1回の読み出しで取得する (チャタリング除去前)
+ * @return ボタン番号順のビット [1:Pressed, 0:Released]
+ */
+uint16_t button_input_sample(void);
+
+#ifdef NATIVE_HOST
+/**
+ * @brief ホスト上で GPIO の入力レベルを与える (記録した波形の再生用)
+ * @param gpio_levels gpio_get_all() と同じ形式 (ビット n = GPIO n)
+ */
+void button_input_inject(uint32_t gpio_levels);
+#endif
+
+#endif // BUTTON_INPUT_H
@@ -0,0 +1,78 @@
+/**
+ * @file cobs.h
+ * @brief シリアルのバイナリフレーム用 COBS / CRC-16 (動的メモリ確保無し)
+ * @date 2026-10-16
+ *
+ * COBS (Consistent Overhead Byte Stuffing) はデータ中の 0x00 を除去するため、
+ * 0x00 をフレームの区切りとして使用できる。受信側は区切りで再同期できる。
+ * CRC は CRC-16/CCITT-FALSE (多項式 0x1021, 初期値 0xFFFF)。
+ * PC 側の実装: tools/python/telemetry.py
+ */
+
+#ifndef COBS_H
+#define COBS_H
+
+#include <stdint.h>
+
+/// @brief len バイトの COBS エンコード後の最大長 (区切りの 0x00 を除く)
+#define COBS_ENCODED_MAX(len) ((len) + (len) / 254 + 1)
+
+/// @brief CRC-16/CCITT-FALSE
+inline uint16_t crc16_ccitt(const uint8_t *data, uint16_t len) {
+  uint16_t crc = 0xFFFF;
+  for (uint16_t i = 0; i < len; i++) {
+    crc ^= (uint16_t)data[i] << 8;
+    for (uint8_t b = 0; b < 8; b++)
+      crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021)
+                           : (uint16_t)(crc << 1);
+  }
+  return crc;
+}
+
+/**
+ * @brief COBS エンコード (末尾に区切りの 0x00 を付加)
+ * @param dest 出力先 (COBS_ENCODED_MAX(len) + 1 バイト以上)
+ * @return 出力長 (区切りを含む)
+ */
+inline uint16_t cobs_encode(const uint8_t *src, uint16_t len, uint8_t *dest) {
+  uint16_t code_pos = 0;
+  uint16_t out = 1;
+  uint8_t code = 1;
+  for (uint16_t i = 0; i < len; i++) {
+    if (src[i] != 0) {
+      dest[out++] = src[i];
+      code++;
+    }
+    if (src[i] == 0 || code == 0xFF) {
+      dest[code_pos] = code;
+      code_pos = out++;
+      code = 1;
+    }
+  }
+  dest[code_pos] = code;
+  dest[out++] = 0x00;
+  return out;
+}
+
+/**
+ * @brief COBS デコード (src は区切りの 0x00 を含まないこと)
+ * @param dest 出力先 (len バイト以上)。src と同じ領域でもよい
+ * @return 出力長。不正なフレームの場合 -1
+ */
+inline int16_t cobs_decode(const uint8_t *src, uint16_t len, uint8_t *dest) {
+  uint16_t in = 0;
+  uint16_t out = 0;
+  while (in < len) {
+    uint8_t code = src[in];
+    if (code == 0 || in + code > len)
+      return -1;
+    in++;
+    for (uint8_t i = 1; i < code; i++)
+      dest[out++] = src[in++];
+    if (code < 0xFF && in < len)
+      dest[out++] = 0x00;
+  }
+  return (int16_t)out;
+}
+
+#endif // COBS_H
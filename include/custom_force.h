@@ -0,0 +1,40 @@
+/**
+ * @file custom_force.h
+ * @brief Custom Force のサンプル列の受け渡し (Core0 -> Core1)
+ * @date 2026-10-16
+ *
+ * ベンダ定義レポート (ID 2) で届いたサンプル列を、Core0 がチャネルごとの
+ * SpscRing へ積み、Core1 (EffectStore) が Set Custom Force (0x07) の
+ * サンプル周期で取り出して再生する。路面の細かな振動などを Constant Force
+ * の頻繁な更新で模擬せずに、高いレートのまま送ることができる。
+ *
+ * - チャネルは Set Custom Force の受信時にエフェクトブロックへ割り当て、
+ *   Block Free / 種類の変更 / Device Reset で解放する (Core0 のみが管理)。
+ * - チャネルの割当て時の書込位置を ffb_custom_block_t で Core1 へ渡し、
+ *   Core1 はそれより前 (以前の持ち主) のサンプルを読み捨てる。
+ *   リングの読込位置を動かすのはコンシューマ (Core1) のみである。
+ */
+
+#ifndef CUSTOM_FORCE_H
+#define CUSTOM_FORCE_H
+
+#include "hidwffb.h"
+#include "spsc_ring.h"
+#include <atomic>
+#include <stdint.h>
+
+typedef SpscRing<int16_t, FFB_CUSTOM_RING_SAMPLES> ffb_custom_ring_t;
+
+typedef struct {
+  ffb_custom_ring_t samples;       ///< Core0 が追加し、Core1 が取り出す
+  std::atomic<uint16_t> underruns; ///< サンプル不足の周期数 (Core1 のみ更新)
+} ffb_custom_channel_t;
+
+/**
+ * @brief チャネルを取得する (どちらのコアからも呼び出し可)
+ * @param channel 1..FFB_CUSTOM_CHANNELS
+ * @return 範囲外 (0: 未割当て を含む) の場合 NULL
+ */
+ffb_custom_channel_t *ffb_custom_channel(uint8_t channel);
+
+#endif // CUSTOM_FORCE_H
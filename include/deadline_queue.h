@@ -0,0 +1,139 @@
+/**
+ * @file deadline_queue.h
+ * @brief 固定長の期限付きイベントキュー (最小ヒープ)
+ * @date 2026-10-16
+ *
+ * スロット番号 (0..N-1) ごとに最大1件の期限 (周期カウンタ値) を保持し、
+ * 期限の近い順に取り出す。毎周期の確認は先頭の比較のみで済み、
+ * 期限を迎えたスロットだけを処理できる。
+ *
+ * - 動的メモリ確保は行わない。
+ * - 期限は 32bit の周期カウンタで表し、差分比較によりラップアラウンドを
+ *   扱う (2^31 周期以内の予定のみ有効)。
+ * - 単一コア (Core1) 専用。排他制御は行わない。
+ * - pos[] は heap[] と相互に参照している場合のみ有効とみなすため、
+ *   clear() は件数を 0 にするだけで済む (全停止を O(1) で行える)。
+ */
+
+#ifndef DEADLINE_QUEUE_H
+#define DEADLINE_QUEUE_H
+
+#include <cstdint>
+
+template <uint8_t N> class DeadlineQueue {
+  static_assert(N > 0 && N < 0xFF, "スロット数は 1..254 とすること");
+
+public:
+  static constexpr uint8_t NOT_QUEUED = 0xFF; ///< pos[] の未登録値
+
+  DeadlineQueue() : count(0) {
+    for (uint8_t i = 0; i < N; i++)
+      pos[i] = NOT_QUEUED;
+  }
+
+  /// @brief 全ての予定を取り消す (O(1), 残った pos[] は無効として扱う)
+  void clear() { count = 0; }
+
+  /**
+   * @brief スロットの期限を登録する (登録済みの場合は置き換える)
+   * @param slot スロット番号 (0..N-1)
+   * @param deadline 期限 (周期カウンタ値)
+   */
+  void schedule(uint8_t slot, uint32_t deadline) {
+    if (slot >= N)
+      return;
+    uint8_t i = pos[slot];
+    if (!contains(slot)) {
+      i = count++;
+      heap[i].slot = slot;
+      pos[slot] = i;
+    }
+    heap[i].deadline = deadline;
+    siftDown(siftUp(i));
+  }
+
+  /// @brief スロットの予定を取り消す (未登録なら何もしない)
+  void cancel(uint8_t slot) {
+    if (!contains(slot))
+      return;
+    uint8_t i = pos[slot];
+    pos[slot] = NOT_QUEUED;
+    if (--count == i)
+      return; // 末尾の要素
+    heap[i] = heap[count];
+    pos[heap[i].slot] = i;
+    siftDown(siftUp(i));
+  }
+
+  /**
+   * @brief 期限を迎えた予定を1件取り出す
+   * @param now 現在の周期カウンタ値
+   * @param slot 取り出したスロット番号
+   * @return 期限を迎えた予定があれば true
+   */
+  bool popExpired(uint32_t now, uint8_t &slot) {
+    if (count == 0 || before(now, heap[0].deadline))
+      return false;
+    slot = heap[0].slot;
+    cancel(slot);
+    return true;
+  }
+
+  bool contains(uint8_t slot) const {
+    if (slot >= N)
+      return false;
+    uint8_t i = pos[slot];
+    return i < count && heap[i].slot == slot;
+  }
+  uint8_t size() const { return count; }
+
+private:
+  typedef struct {
+    uint32_t deadline;
+    uint8_t slot;
+  } entry_t;
+
+  /// @brief a が b より前か (ラップアラウンド考慮)
+  static bool before(uint32_t a, uint32_t b) { return (int32_t)(a - b) < 0; }
+
+  void swap(uint8_t a, uint8_t b) {
+    entry_t tmp = heap[a];
+    heap[a] = heap[b];
+    heap[b] = tmp;
+    pos[heap[a].slot] = a;
+    pos[heap[b].slot] = b;
+  }
+
+  uint8_t siftUp(uint8_t i) {
+    while (i > 0) {
+      uint8_t parent = (uint8_t)((i - 1) / 2);
+      if (!before(heap[i].deadline, heap[parent].deadline))
+        break;
+      swap(i, parent);
+      i = parent;
+    }
+    return i;
+  }
+
+  void siftDown(uint8_t i) {
+    for (;;) {
+      uint16_t left = 2u * i + 1;
+      if (left >= count)
+        return;
+      uint8_t child = (uint8_t)left;
+      if (left + 1 < count &&
+          before(heap[left + 1].deadline, heap[left].deadline))
+        child = (uint8_t)(left + 1);
+      if (!before(heap[child].deadline, heap[i].deadline))
+        return;
+      swap(i, child);
+      i = child;
+    }
+  }
+
+  entry_t heap[N];
+  uint8_t pos[N]; ///< スロット -> heap[] の位置 (contains() が偽なら無効)
+  uint8_t count;
+};
+
+#endif // DEADLINE_QUEUE_H
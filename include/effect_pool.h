@@ -0,0 +1,90 @@
+/**
+ * @file effect_pool.h
+ * @brief エフェクトブロックの割当て (PID Create New Effect / Block Free)
+ * @date 2026-10-16
+ *
+ * Create New Effect は Feature Report のため、直後にホストが読む Block Load
+ * に結果を返せるよう USB コールバック内で割り当てる。一方 Block Free は
+ * Output Report として受信キューを経由し、先に届いたパラメータ設定との
+ * 順序を保つため Core0 のループで解放する。
+ *
+ * 空きブロック番号は SpscRing (ループ側が追加、コールバック側が取出し) で
+ * 保持するため、割当て・解放とも O(1) で、割込みを禁止せずに済む。
+ * 使用中の集合はループ側のみが管理し、割り当てたブロックはキュー経由の
+ * commit() で使用中とする (解放との順序が受信順と一致する)。
+ */
+
+#ifndef EFFECT_POOL_H
+#define EFFECT_POOL_H
+
+#include "spsc_ring.h"
+#include <stdint.h>
+
+template <uint8_t N> class EffectBlockPool {
+  static_assert(N > 0 && N <= 64, "ブロック数は 1..64 とすること");
+  // 空き番号のリングは 2 のべき乗の容量が必要
+  static constexpr uint16_t RING_SIZE = (N <= 8)    ? 8
+                                        : (N <= 16) ? 16
+                                        : (N <= 32) ? 32
+                                                    : 64;
+
+public:
+  /// @brief 全ブロックを空きとする (USB の開始前に構築されること)
+  EffectBlockPool() : used(0) {
+    for (uint8_t i = 0; i < N; i++)
+      free_blocks.push(i);
+  }
+
+  // --- USB コールバック側 ---
+
+  /**
+   * @brief 空きブロックを1つ取り出す
+   * @param index 取り出したブロック番号 (0..N-1)
+   * @return 空きが無い場合 false
+   */
+  bool allocate(uint8_t &index) { return free_blocks.pop(index); }
+
+  // --- Core0 ループ側 ---
+
+  /**
+   * @brief allocate() したブロックを使用中とする
+   * @return 既に使用中の場合 false (重複した割当て)
+   */
+  bool commit(uint8_t index) {
+    uint64_t bit = (uint64_t)1 << index;
+    if (index >= N || (used & bit) != 0)
+      return false;
+    used |= bit;
+    return true;
+  }
+
+  /**
+   * @brief 使用中のブロックを空きへ戻す
+   * @return 使用中でなかった場合 false (空きへは戻さない)
+   */
+  bool release(uint8_t index) {
+    uint64_t bit = (uint64_t)1 << index;
+    if (index >= N || (used & bit) == 0)
+      return false;
+    used &= ~bit;
+    free_blocks.push(index);
+    return true;
+  }
+
+  bool inUse(uint8_t index) const {
+    return index < N && (used & ((uint64_t)1 << index)) != 0;
+  }
+  /// @brief 使用中のブロック (bit i = ブロック i)
+  uint64_t usedMask() const { return used; }
+
+  // --- どちらの側からも参照可 ---
+
+  /// @brief 空きブロック数
+  uint8_t available() const { return (uint8_t)free_blocks.size(); }
+
+private:
+  SpscRing<uint8_t, RING_SIZE> free_blocks;
+  uint64_t used; ///< 使用中のブロック (ループ側のみ更新)
+};
+
+#endif // EFFECT_POOL_H
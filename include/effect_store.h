@@ -0,0 +1,620 @@
+/**
+ * @file effect_store.h
+ * @brief Core1 のエフェクト保持 (配列の構造体) と種類別の一括評価
+ * @date 2026-10-16
+ *
+ * Core0 から受け取った FFB_Shared_State_t (スロットごとの構造体) は、
+ * 受け取った時に load() で項目ごとの配列へ展開し、再生中のスロット番号を
+ * 種類ごとの一覧 (再生リスト) で保持する。evaluate() は種類ごとの専用の
+ * ループで再生リストだけを走査するため、
+ * - 停止中のスロットに触れない
+ * - スロットごとに種類で分岐しない
+ * - volatile を含む共有構造体を読まない
+ * 条件エフェクトの境界や飽和値など、パラメータだけで決まる値は
+ * load() で前計算する。再生リストへの追加/削除は開始/停止時のみで、
+ * 末尾との入替えにより O(1) で行う。list_pos[] は再生リストと相互に参照
+ * している場合のみ有効とみなすため、stopAll() はリストの長さを 0 にする
+ * だけで済む (Device Control の全停止がスロット数に依存しない)。
+ *
+ * 再生タイミング (開始遅延・duration・繰り返し) は ffb_engine.cpp が管理し、
+ * start() / stop() で再生リストを更新する。単一コア (Core1) 専用。
+ */
+
+#ifndef EFFECT_STORE_H
+#define EFFECT_STORE_H
+
+#include "custom_force.h"
+#include "ffb_engine.h"
+#include "ffb_waveform.h"
+#include <stdint.h>
+
+/// @brief 評価方法ごとの種類 (再生リストの番号)
+enum : uint8_t {
+  FFB_KIND_CONSTANT = 0,
+  FFB_KIND_RAMP,
+  FFB_KIND_SQUARE,
+  FFB_KIND_SINE,
+  FFB_KIND_TRIANGLE,
+  FFB_KIND_SAWTOOTH_UP,
+  FFB_KIND_SAWTOOTH_DOWN,
+  FFB_KIND_SPRING,
+  FFB_KIND_DAMPER,
+  FFB_KIND_INERTIA,
+  FFB_KIND_FRICTION,
+  FFB_KIND_CUSTOM,
+  FFB_KIND_COUNT,
+  FFB_KIND_NONE = 0xFF ///< 未対応の種類 (再生しても力は 0)
+};
+
+/// @brief Effect Type (HID_ET_*) -> 種類
+inline uint8_t ffb_kind_of(uint8_t type) {
+  switch (type) {
+  case HID_ET_CONSTANT:
+    return FFB_KIND_CONSTANT;
+  case HID_ET_RAMP:
+    return FFB_KIND_RAMP;
+  case HID_ET_SQUARE:
+    return FFB_KIND_SQUARE;
+  case HID_ET_SINE:
+    return FFB_KIND_SINE;
+  case HID_ET_TRIANGLE:
+    return FFB_KIND_TRIANGLE;
+  case HID_ET_SAWTOOTH_UP:
+    return FFB_KIND_SAWTOOTH_UP;
+  case HID_ET_SAWTOOTH_DOWN:
+    return FFB_KIND_SAWTOOTH_DOWN;
+  case HID_ET_SPRING:
+    return FFB_KIND_SPRING;
+  case HID_ET_DAMPER:
+    return FFB_KIND_DAMPER;
+  case HID_ET_INERTIA:
+    return FFB_KIND_INERTIA;
+  case HID_ET_FRICTION:
+    return FFB_KIND_FRICTION;
+  case HID_ET_CUSTOM:
+    return FFB_KIND_CUSTOM;
+  default:
+    return FFB_KIND_NONE;
+  }
+}
+
+/**
+ * @brief 開始/終了時のみ参照する項目 (周期ごとには読まない)
+ */
+typedef struct {
+  uint16_t duration_ms;
+  uint16_t startDelay_ms;
+  uint16_t triggerRepeatInterval_ms;
+  uint8_t loopCount;
+  int16_t rampStart;
+  int16_t rampEnd;
+  uint16_t periodicPhase;
+  uint16_t attackTime_ms;
+  uint16_t fadeTime_ms;
+} ffb_effect_setup_t;
+
+// Friction: 正規化速度 -> 向き の傾き (大きいほど速度ゼロ付近で急峻に反転)
+static constexpr int32_t FFB_FRICTION_VELOCITY_GAIN = 16;
+
+template <uint8_t N> class EffectStore {
+  static_assert(N > 0 && N < 0xFF, "スロット数は 1..254 とすること");
+
+public:
+  static constexpr uint8_t NOT_LISTED = 0xFF; ///< list_pos[] の初期値
+
+  EffectStore() : tick_us(1000) { clear(); }
+
+  /// @brief evaluate() の呼び出し周期 [us] を設定する
+  void setTick(uint32_t tick) { tick_us = (tick > 0) ? tick : 1; }
+
+  /// @brief duration [ms] を周期数へ変換する (開始時のみ使用)
+  uint32_t durationToTicks(uint16_t duration_ms) const {
+    return ((uint32_t)duration_ms * 1000u) / tick_us;
+  }
+
+  /// @brief 全スロットを停止し、パラメータを 0 にする
+  void clear() {
+    stopAll();
+    for (uint8_t i = 0; i < N; i++) {
+      kind[i] = FFB_KIND_NONE;
+      list_pos[i] = NOT_LISTED;
+      magnitude[i] = gain[i] = periodic_offset[i] = 0;
+      period_ms[i] = 0;
+      phase[i] = phase_step[i] = 0;
+      bound_upper[i] = bound_lower[i] = 0;
+      coef_pos[i] = coef_neg[i] = 0;
+      sat_pos[i] = sat_neg[i] = FFB_TORQUE_MAX;
+      attack_level[i] = fade_level[i] = 0;
+      elapsed[i] = 0;
+      env_stage[i] = ENV_NONE;
+      ramp_q16[i] = ramp_step_q16[i] = 0;
+      ramp_remaining[i] = 0;
+      custom_src[i] = NULL;
+      custom_channel[i] = 0;
+      custom_start[i] = 0;
+      custom_step_q16[i] = custom_acc_q16[i] = 0;
+      custom_value[i] = 0;
+      setup_params[i] = ffb_effect_setup_t();
+    }
+  }
+
+  /**
+   * @brief Core0 から受け取ったスロットの内容を展開する (更新時のみ呼ぶ)
+   * 再生中に種類が変わった場合は再生リストを移す。
+   */
+  void load(uint8_t slot, const FFB_Shared_State_t &effect) {
+    if (slot >= N)
+      return;
+    uint8_t k = ffb_kind_of(effect.type);
+    if (k != kind[slot]) {
+      bool listed = playing(slot);
+      if (listed)
+        unlist(slot);
+      kind[slot] = k;
+      if (listed)
+        enlist(slot);
+    }
+
+    magnitude[slot] = effect.magnitude;
+    gain[slot] = effect.gain;
+
+    ffb_effect_setup_t &s = setup_params[slot];
+    s = ffb_effect_setup_t();
+    s.duration_ms = effect.duration_ms;
+    s.startDelay_ms = effect.startDelay_ms;
+    s.triggerRepeatInterval_ms = effect.triggerRepeatInterval_ms;
+    s.loopCount = effect.loopCount;
+
+    // パラメータブロックは種類に応じた側のみを読む (共用体の他方は無効)
+    ffb_condition_block_t condition = ffb_condition_block_t();
+    int16_t offset = 0;
+    uint16_t period = 0;
+    attack_level[slot] = fade_level[slot] = 0;
+    if (ffb_type_is_condition(effect.type)) {
+      condition = effect.condition;
+    } else {
+      const ffb_force_block_t &force = effect.force;
+      attack_level[slot] = force.envelope.attackLevel;
+      fade_level[slot] = force.envelope.fadeLevel;
+      s.attackTime_ms = force.envelope.attackTime_ms;
+      s.fadeTime_ms = force.envelope.fadeTime_ms;
+      if (k == FFB_KIND_RAMP) {
+        s.rampStart = force.ramp.start;
+        s.rampEnd = force.ramp.end;
+      } else if (k >= FFB_KIND_SQUARE && k <= FFB_KIND_SAWTOOTH_DOWN) {
+        offset = force.periodic.offset;
+        s.periodicPhase = force.periodic.phase;
+        period = force.periodic.period_ms;
+      } else if (k == FFB_KIND_CUSTOM) {
+        loadCustom(slot, force.custom);
+      }
+    }
+
+    periodic_offset[slot] = offset;
+    if (period != period_ms[slot]) {
+      period_ms[slot] = period;
+      phase_step[slot] = wave_phase_step(period, tick_us);
+    }
+
+    // 条件エフェクト: 乗算が 32bit に収まるよう、境界をフルスケール内に制限する
+    int32_t center = condition.cpOffset;
+    bound_upper[slot] = clamp_torque(center + condition.deadBand);
+    bound_lower[slot] = clamp_torque(center - condition.deadBand);
+    coef_pos[slot] = condition.positiveCoefficient;
+    coef_neg[slot] = condition.negativeCoefficient;
+    // 飽和値 0 は「制限なし (フルスケール)」として扱う
+    sat_pos[slot] = condition.positiveSaturation ? condition.positiveSaturation
+                                                 : FFB_TORQUE_MAX;
+    sat_neg[slot] = condition.negativeSaturation ? condition.negativeSaturation
+                                                 : FFB_TORQUE_MAX;
+  }
+
+  const ffb_effect_setup_t &setup(uint8_t slot) const {
+    return setup_params[slot];
+  }
+
+  /// @brief 1回分の再生を開始する (前計算を行い、再生リストへ加える)
+  void start(uint8_t slot) {
+    if (slot >= N)
+      return;
+    const ffb_effect_setup_t &s = setup_params[slot];
+    elapsed[slot] = 0;
+
+    // 周期エフェクトは開始位相から始める
+    phase[slot] = wave_phase_from_pid(s.periodicPhase);
+    phase_step[slot] = wave_phase_step(period_ms[slot], tick_us);
+
+    envelopeStart(slot);
+
+    // Custom Force は最初の周期でサンプルを取り出す
+    custom_acc_q16[slot] = 0xFFFF;
+    custom_value[slot] = 0;
+
+    if (kind[slot] == FFB_KIND_RAMP) {
+      ramp_q16[slot] = (int32_t)s.rampStart * 65536;
+      ramp_step_q16[slot] = 0;
+      ramp_remaining[slot] = 0;
+      // 無期限の Ramp は開始値を維持する
+      if (s.duration_ms != FFB_DURATION_INFINITE) {
+        uint32_t ticks = durationToTicks(s.duration_ms);
+        if (ticks == 0) {
+          ramp_q16[slot] = (int32_t)s.rampEnd * 65536;
+        } else {
+          int64_t delta_q16 = ((int64_t)s.rampEnd - s.rampStart) * 65536;
+          ramp_step_q16[slot] = (int32_t)(delta_q16 / ticks);
+          ramp_remaining[slot] = ticks;
+        }
+      }
+    }
+
+    if (!playing(slot))
+      enlist(slot);
+  }
+
+  /// @brief 再生を止める (再生リストから外す)
+  void stop(uint8_t slot) {
+    if (playing(slot))
+      unlist(slot);
+  }
+
+  /// @brief 全スロットの再生を止める (O(1), パラメータは保持する)
+  void stopAll() {
+    for (uint8_t k = 0; k < LIST_COUNT; k++)
+      play_count[k] = 0;
+  }
+
+  bool playing(uint8_t slot) const {
+    if (slot >= N)
+      return false;
+    uint8_t k = list_of(kind[slot]);
+    uint8_t n = list_pos[slot];
+    return n < play_count[k] && play[k][n] == slot;
+  }
+  /// @brief 再生中のスロット数 (未対応の種類を含む)
+  uint8_t playingCount() const {
+    uint8_t n = 0;
+    for (uint8_t k = 0; k < LIST_COUNT; k++)
+      n += play_count[k];
+    return n;
+  }
+
+  /**
+   * @brief 再生中の全エフェクトを1周期分評価し、mixer へ積算する
+   */
+  void evaluate(const ffb_axis_state_t &axis, FfbMixer &mixer) {
+    evalConstant(mixer);
+    evalRamp(mixer);
+    evalPeriodic<wave_square_q15>(FFB_KIND_SQUARE, mixer);
+    evalPeriodic<wave_sine_q15>(FFB_KIND_SINE, mixer);
+    evalPeriodic<wave_triangle_q15>(FFB_KIND_TRIANGLE, mixer);
+    evalPeriodic<wave_sawtooth_up_q15>(FFB_KIND_SAWTOOTH_UP, mixer);
+    evalPeriodic<wave_sawtooth_down_q15>(FFB_KIND_SAWTOOTH_DOWN, mixer);
+    evalCondition(FFB_KIND_SPRING, axis.position, mixer);
+    evalCondition(FFB_KIND_DAMPER, axis.velocity, mixer);
+    evalCondition(FFB_KIND_INERTIA, axis.acceleration, mixer);
+    evalFriction(axis.velocity, mixer);
+    evalCustom(mixer);
+  }
+
+private:
+  // エンベロープの段階
+  enum : uint8_t {
+    ENV_NONE = 0, ///< エンベロープ無し (Attack/Fade 時間が共に 0)
+    ENV_ATTACK,
+    ENV_SUSTAIN,
+    ENV_FADE,
+    ENV_DONE
+  };
+  static constexpr uint32_t ENV_PROGRESS_ONE = 65536; ///< 進捗 1.0 (Q16)
+  static constexpr uint32_t ENV_NO_FADE = UINT32_MAX; ///< Fade 無し
+
+  static int32_t clamp_torque(int32_t value) {
+    if (value > FFB_TORQUE_MAX)
+      return FFB_TORQUE_MAX;
+    if (value < -FFB_TORQUE_MAX)
+      return -FFB_TORQUE_MAX;
+    return value;
+  }
+
+  // --- 再生リスト ---
+  // 未対応の種類は力を出さないため、評価しない末尾のリストへ入れる
+  static constexpr uint8_t LIST_COUNT = FFB_KIND_COUNT + 1;
+  static uint8_t list_of(uint8_t k) {
+    return (k == FFB_KIND_NONE) ? (uint8_t)FFB_KIND_COUNT : k;
+  }
+
+  void enlist(uint8_t slot) {
+    uint8_t k = list_of(kind[slot]);
+    uint8_t n = play_count[k]++;
+    play[k][n] = slot;
+    list_pos[slot] = n;
+  }
+
+  void unlist(uint8_t slot) {
+    uint8_t k = list_of(kind[slot]);
+    uint8_t n = list_pos[slot];
+    list_pos[slot] = NOT_LISTED;
+    // 末尾の要素を空いた位置へ移す
+    uint8_t last = --play_count[k];
+    if (n != last) {
+      uint8_t moved = play[k][last];
+      play[k][n] = moved;
+      list_pos[moved] = n;
+    }
+  }
+
+  // --- Custom Force ---
+  /**
+   * @brief サンプル周期からの前計算と、チャネルの割当て変更の反映
+   * 割当てが変わった場合は、割当て時の書込位置より前のサンプル (以前の
+   * 持ち主の残り) を読み捨てる
+   */
+  void loadCustom(uint8_t slot, const ffb_custom_block_t &custom) {
+    uint32_t period_us = custom.samplePeriod_us ? custom.samplePeriod_us
+                                                : tick_us;
+    if (period_us < FFB_CUSTOM_PERIOD_MIN_US)
+      period_us = FFB_CUSTOM_PERIOD_MIN_US;
+    custom_step_q16[slot] = (uint32_t)(((uint64_t)tick_us << 16) / period_us);
+
+    if (custom.channel == custom_channel[slot] &&
+        custom.startPosition == custom_start[slot])
+      return;
+    custom_channel[slot] = custom.channel;
+    custom_start[slot] = custom.startPosition;
+    custom_src[slot] = ffb_custom_channel(custom.channel);
+    if (custom_src[slot] != NULL)
+      custom_src[slot]->samples.discardUntil(custom.startPosition);
+  }
+
+  // --- エンベロープ ---
+  /// @brief エンベロープの開始 (進捗の増分を前計算し、周期ごとの除算を避ける)
+  void envelopeStart(uint8_t slot) {
+    const ffb_effect_setup_t &s = setup_params[slot];
+    if (s.attackTime_ms == 0 && s.fadeTime_ms == 0) {
+      env_stage[slot] = ENV_NONE;
+      return;
+    }
+
+    uint32_t attack_ticks = durationToTicks(s.attackTime_ms);
+    uint32_t fade_ticks = durationToTicks(s.fadeTime_ms);
+    env_fade_ticks[slot] = fade_ticks;
+    env_attack_step_q16[slot] =
+        (attack_ticks > 0) ? ENV_PROGRESS_ONE / attack_ticks : 0;
+    env_fade_step_q16[slot] =
+        (fade_ticks > 0) ? ENV_PROGRESS_ONE / fade_ticks : 0;
+
+    // Fade は duration の終端で終わるように開始する (無期限なら Fade 無し)
+    env_fade_start_tick[slot] = ENV_NO_FADE;
+    if (s.duration_ms != FFB_DURATION_INFINITE && fade_ticks > 0) {
+      uint32_t duration_ticks = durationToTicks(s.duration_ms);
+      uint32_t fade_start =
+          (duration_ticks > fade_ticks) ? duration_ticks - fade_ticks : 0;
+      env_fade_start_tick[slot] =
+          (fade_start > attack_ticks) ? fade_start : attack_ticks;
+    }
+
+    env_progress_q16[slot] = 0;
+    if (attack_ticks > 0) {
+      env_stage[slot] = ENV_ATTACK;
+      env_ticks_left[slot] = attack_ticks;
+    } else {
+      env_stage[slot] = ENV_SUSTAIN;
+    }
+  }
+
+  /**
+   * @brief 現在のエンベロープ適用後の強さを求め、1周期分進める
+   * @param sustain 定常時の強さ (|magnitude|, 0..32767)
+   */
+  int32_t envelopeStep(uint8_t slot, int32_t sustain) {
+    int32_t level;
+    switch (env_stage[slot]) {
+    case ENV_ATTACK:
+      level = attack_level[slot] +
+              ((((int32_t)sustain - attack_level[slot]) *
+                (int32_t)env_progress_q16[slot]) >>
+               16);
+      env_progress_q16[slot] += env_attack_step_q16[slot];
+      if (--env_ticks_left[slot] == 0) {
+        env_stage[slot] = ENV_SUSTAIN;
+        env_progress_q16[slot] = ENV_PROGRESS_ONE;
+      }
+      break;
+    case ENV_FADE:
+      level = sustain + ((((int32_t)fade_level[slot] - sustain) *
+                          (int32_t)env_progress_q16[slot]) >>
+                         16);
+      env_progress_q16[slot] += env_fade_step_q16[slot];
+      if (--env_ticks_left[slot] == 0)
+        env_stage[slot] = ENV_DONE;
+      break;
+    case ENV_DONE:
+      return fade_level[slot];
+    default: // ENV_NONE, ENV_SUSTAIN
+      level = sustain;
+      break;
+    }
+
+    // 次の周期から Fade に入る
+    if (env_stage[slot] == ENV_SUSTAIN &&
+        elapsed[slot] + 1 >= env_fade_start_tick[slot]) {
+      env_stage[slot] = ENV_FADE;
+      env_progress_q16[slot] = 0;
+      env_ticks_left[slot] = env_fade_ticks[slot];
+    }
+    return level;
+  }
+
+  // --- 種類別の評価ループ (力 [-32767, 32767] 相当を mixer へ積算) ---
+
+  void evalConstant(FfbMixer &mixer) {
+    const uint8_t *list = play[FFB_KIND_CONSTANT];
+    for (uint8_t n = 0; n < play_count[FFB_KIND_CONSTANT]; n++) {
+      uint8_t s = list[n];
+      int32_t force = magnitude[s];
+      if (env_stage[s] != ENV_NONE) {
+        // エンベロープは強さ (絶対値) に作用し、向きは magnitude の符号に従う
+        int32_t level = envelopeStep(s, (force < 0) ? -force : force);
+        force = (force < 0) ? -level : level;
+      }
+      mixer.add(force, gain[s]);
+      elapsed[s]++;
+    }
+  }
+
+  void evalRamp(FfbMixer &mixer) {
+    const uint8_t *list = play[FFB_KIND_RAMP];
+    for (uint8_t n = 0; n < play_count[FFB_KIND_RAMP]; n++) {
+      uint8_t s = list[n];
+      int32_t value = ramp_q16[s] >> 16;
+      if (ramp_remaining[s] > 0) {
+        ramp_q16[s] += ramp_step_q16[s];
+        if (--ramp_remaining[s] == 0) // 丸め誤差を除去
+          ramp_q16[s] = (int32_t)setup_params[s].rampEnd * 65536;
+      }
+      mixer.add(value, gain[s]);
+      elapsed[s]++;
+    }
+  }
+
+  /// @brief 周期エフェクト: offset + magnitude * wave(phase)
+  template <int16_t (*Wave)(uint32_t)>
+  void evalPeriodic(uint8_t k, FfbMixer &mixer) {
+    const uint8_t *list = play[k];
+    for (uint8_t n = 0; n < play_count[k]; n++) {
+      uint8_t s = list[n];
+      int32_t amplitude = (env_stage[s] == ENV_NONE)
+                              ? magnitude[s]
+                              : envelopeStep(s, magnitude[s]);
+      int32_t wave = Wave(phase[s]);
+      phase[s] += phase_step[s];
+      mixer.add(periodic_offset[s] + ((amplitude * wave) >> 15), gain[s]);
+      elapsed[s]++;
+    }
+  }
+
+  /**
+   * @brief 条件の力 (PID の Condition 定義に従う)
+   * 境界の外側で係数 (Q15) に比例した復元力を発生し、正負の飽和値で制限する
+   */
+  int32_t conditionForce(uint8_t s, int32_t metric, int32_t upper,
+                         int32_t lower) const {
+    int32_t force;
+    if (metric > upper)
+      force = -(((metric - upper) * coef_pos[s]) >> 15);
+    else if (metric < lower)
+      force = -(((metric - lower) * coef_neg[s]) >> 15);
+    else
+      return 0;
+    if (force > sat_pos[s])
+      return sat_pos[s];
+    if (force < -(int32_t)sat_neg[s])
+      return -(int32_t)sat_neg[s];
+    return force;
+  }
+
+  /// @brief Spring/Damper/Inertia: 中心 ± 不感帯 の外側で metric に作用する
+  void evalCondition(uint8_t k, int32_t metric, FfbMixer &mixer) {
+    const uint8_t *list = play[k];
+    for (uint8_t n = 0; n < play_count[k]; n++) {
+      uint8_t s = list[n];
+      mixer.add(conditionForce(s, metric, bound_upper[s], bound_lower[s]),
+                gain[s]);
+      elapsed[s]++;
+    }
+  }
+
+  /**
+   * @brief Friction: 速度の向きと逆向きに一定の力。速度ゼロ付近は
+   * 傾きを持たせて切り替え時の振動 (チャタリング) を防ぐ
+   */
+  void evalFriction(int32_t velocity, FfbMixer &mixer) {
+    int32_t direction = clamp_torque(velocity * FFB_FRICTION_VELOCITY_GAIN);
+    const uint8_t *list = play[FFB_KIND_FRICTION];
+    for (uint8_t n = 0; n < play_count[FFB_KIND_FRICTION]; n++) {
+      uint8_t s = list[n];
+      mixer.add(conditionForce(s, direction, 0, 0), gain[s]);
+      elapsed[s]++;
+    }
+  }
+
+  /**
+   * @brief Custom Force: サンプル周期に従ってチャネルから取り出す
+   * 1周期に複数のサンプルが来る場合は平均し (この場合のみ除算する)、
+   * サンプルが不足した場合は受け取れた分のみ (無ければ 0) とする
+   */
+  void evalCustom(FfbMixer &mixer) {
+    const uint8_t *list = play[FFB_KIND_CUSTOM];
+    for (uint8_t n = 0; n < play_count[FFB_KIND_CUSTOM]; n++) {
+      uint8_t s = list[n];
+      uint32_t acc = custom_acc_q16[s] + custom_step_q16[s];
+      uint32_t due = acc >> 16;
+      custom_acc_q16[s] = acc & 0xFFFF;
+      ffb_custom_channel_t *src = custom_src[s];
+      if (due > 0 && src != NULL) {
+        int32_t sum = 0;
+        uint32_t got = 0;
+        int16_t sample;
+        while (got < due && src->samples.pop(sample)) {
+          sum += sample;
+          got++;
+        }
+        if (got < due)
+          src->underruns.store(
+              src->underruns.load(std::memory_order_relaxed) + 1,
+              std::memory_order_relaxed);
+        custom_value[s] = (int16_t)((got > 1) ? sum / (int32_t)got : sum);
+      }
+      mixer.add(custom_value[s], gain[s]);
+      elapsed[s]++;
+    }
+  }
+
+  uint32_t tick_us;
+
+  // 再生リスト (種類ごとに再生中のスロット番号を詰めて保持する)
+  // 末尾 (FFB_KIND_COUNT) は未対応の種類 (評価しない)
+  uint8_t play[LIST_COUNT][N];
+  uint8_t play_count[LIST_COUNT];
+  uint8_t kind[N];
+  uint8_t list_pos[N]; ///< 再生リスト内の位置 (playing() が偽なら無効)
+
+  // 周期ごとに参照するパラメータ (load() で展開)
+  int16_t magnitude[N];
+  int16_t gain[N];
+  int16_t periodic_offset[N];
+  uint16_t period_ms[N];  ///< phase_step 算出時の周期
+  int32_t bound_upper[N]; ///< 条件: 中心 + 不感帯
+  int32_t bound_lower[N]; ///< 条件: 中心 - 不感帯
+  int16_t coef_pos[N];
+  int16_t coef_neg[N];
+  uint16_t sat_pos[N]; ///< 条件: 正方向の力の上限 (0 は変換済み)
+  uint16_t sat_neg[N];
+  uint16_t attack_level[N];
+  uint16_t fade_level[N];
+
+  // 再生中の状態
+  uint32_t elapsed[N];             ///< 開始からの経過周期数
+  uint32_t phase[N];               ///< 周期: 位相 (1周期 = 2^32)
+  uint32_t phase_step[N];          ///< 周期: 1周期あたりの位相増分
+  int32_t ramp_q16[N];             ///< Ramp: 現在値 (Q16.16)
+  int32_t ramp_step_q16[N];        ///< Ramp: 1周期あたりの増分 (Q16.16)
+  uint32_t ramp_remaining[N];      ///< Ramp: 終了値までの残り周期数
+  uint8_t env_stage[N];            ///< エンベロープの段階 (ENV_*)
+  uint32_t env_progress_q16[N];    ///< 段階内の進捗 (0..65536)
+  uint32_t env_ticks_left[N];      ///< 段階終了までの周期数
+  uint32_t env_attack_step_q16[N]; ///< Attack の1周期あたり進捗
+  uint32_t env_fade_step_q16[N];   ///< Fade の1周期あたり進捗
+  uint32_t env_fade_ticks[N];      ///< Fade の周期数
+  uint32_t env_fade_start_tick[N]; ///< Fade を開始する経過周期数
+  ffb_custom_channel_t *custom_src[N]; ///< Custom: サンプル列 (NULL: 無し)
+  uint8_t custom_channel[N];           ///< Custom: 反映済みの割当て
+  uint16_t custom_start[N];            ///< Custom: 反映済みの割当て時の位置
+  uint32_t custom_step_q16[N];         ///< Custom: 1周期あたりのサンプル数
+  uint32_t custom_acc_q16[N];          ///< Custom: 取り出すサンプル数の端数
+  int16_t custom_value[N];             ///< Custom: 現在の力
+
+  ffb_effect_setup_t setup_params[N]; ///< 開始時のみ参照する項目
+};
+
+#endif // EFFECT_STORE_H
@@ -0,0 +1,53 @@
+/**
+ * @file ffb_engine.h
+ * @brief Core1 用 FFB エフェクト演算エンジン
+ *
+ * Core0 から受け取った FFB_Shared_State_t を受信時に ffb_engine_load() で
+ * 種類別の配列 (EffectStore) へ展開し、制御周期ごとに再生中のエフェクトを
+ * 種類ごとに評価して FfbMixer へ Gain を掛けて積算する。
+ * Device Gain・飽和・出力は FfbMixer 側で処理する。
+ * RP2040 は FPU を持たないため、整数/固定小数点演算のみで構成する。
+ */
+
+#ifndef FFB_ENGINE_H
+#define FFB_ENGINE_H
+
+#include "axis_observer.h"
+#include "ffb_mixer.h"
+#include "hidwffb.h"
+#include <stdint.h>
+
+#define FFB_TORQUE_MAX 32767 ///< トルク指令値の上限 (下限は -FFB_TORQUE_MAX)
+
+/**
+ * @brief エンジンの初期化 (setup1() で呼び出す)
+ * @param tick_us ffb_engine_update() の呼び出し周期 [us]
+ */
+void ffb_engine_init(uint32_t tick_us);
+
+/**
+ * @brief Device Control (0x0B) の反映 (周期ごとに ffb_engine_load() より前に
+ * 呼び出す)。stop_epoch の比較1回のみで、変化した場合は全エフェクトを
+ * スロット数によらず O(1) で停止する
+ * @return 全停止した周期なら true (出力段の値を即座に 0 にすること)
+ */
+bool ffb_engine_control(const ffb_device_control_t &control);
+
+/**
+ * @brief Core0 から受け取ったスロットを反映する (受信した周期のみ呼び出す)
+ * active の変化と Start の再送 (startCount) もここで検出する
+ * @param effects Core1 ローカルのエフェクト配列 (MAX_EFFECTS 要素)
+ * @param changed 反映するスロット
+ */
+void ffb_engine_load(const FFB_Shared_State_t *effects,
+                     ffb_slot_mask_t changed);
+
+/**
+ * @brief 1周期分のエフェクト演算 (Core1 の制御周期ごとに呼び出す)
+ * @param axis 同じ周期で推定した操舵軸の状態 (条件エフェクト用)
+ * @param mixer 積算先。呼出し時に clear() し、再生中のエフェクトを add() する
+ * (Device Pause 中は何も積算せず、再生時間も進めない)
+ */
+void ffb_engine_update(const ffb_axis_state_t &axis, FfbMixer &mixer);
+
+#endif // FFB_ENGINE_H
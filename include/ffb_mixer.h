@@ -0,0 +1,139 @@
+/**
+ * @file ffb_mixer.h
+ * @brief エフェクトの合算とトルク出力段 (ゲイン, ソフトクリップ, 変化量の制限)
+ * @date 2026-10-16
+ *
+ * Core1 の周期ごとに
+ *   1. add()    : ffb_engine_update() が各エフェクトの力を Set Effect の
+ *                 Gain (Q15) を掛けて 32bit で積算する
+ *   2. mix()    : Device Gain (0x0D) を掛け、フルスケールの 3/4 を超える分を
+ *                 ソフトクリップで圧縮して -32767..32767 にする
+ *   3. output() : 1周期あたりの変化量を制限して TorqueOutput へ書き込む
+ * の順に処理する。2 と 3 の間には出力フィルタ等を挟める。
+ * 非常停止では output() の代わりに cutOff() で制限を通さずに 0 を書き込む。
+ *
+ * 多数のエフェクトの同時再生で飽和した回数を stats() で取得できる。
+ */
+
+#ifndef FFB_MIXER_H
+#define FFB_MIXER_H
+
+#include "torque_output.h"
+#include <stdint.h>
+
+#define MIXER_TORQUE_MAX 32767  ///< 出力の上限 (下限は -MIXER_TORQUE_MAX)
+#define MIXER_FORCE_LIMIT 65535 ///< 1エフェクトの力の制限 (Gain 乗算の範囲)
+#define MIXER_KNEE 24575        ///< ソフトクリップの開始点 (フルスケールの 3/4)
+
+/**
+ * @brief ミキサの統計 (起動後の累計, 単位はすべて周期)
+ */
+typedef struct {
+  uint32_t ticks;        ///< mix() の呼出し回数
+  uint32_t overflow;     ///< 合算値が 16bit の範囲を超えた
+  uint32_t soft_clipped; ///< Device Gain 後の値が圧縮域 (MIXER_KNEE 超)
+  uint32_t clipped;      ///< Device Gain 後の値がフルスケールを超えた
+  uint32_t slew_limited; ///< 変化量を制限した
+  uint32_t peak;         ///< Device Gain 後の値の絶対値の最大 (制限前)
+} mixer_stats_t;
+
+class FfbMixer {
+public:
+  /**
+   * @param output 書込先
+   * @param max_step 1周期あたりの出力の変化量の上限 (0: 制限なし)
+   */
+  FfbMixer(TorqueOutput &output, uint16_t max_step)
+      : out(output), step_limit(max_step), acc(0), last(0) {
+    resetStats();
+  }
+
+  /// @brief 周期の開始時に積算値を 0 にする
+  void clear() { acc = 0; }
+
+  /**
+   * @brief エフェクト1つ分の力を積算する
+   * @param force エフェクトの力 (周期エフェクトは offset を含め ±65534 まで)
+   * @param gain Set Effect の Gain (0..32767, 32767 で等倍)
+   */
+  void add(int32_t force, int16_t gain) {
+    if (gain <= 0)
+      return;
+    if (force > MIXER_FORCE_LIMIT)
+      force = MIXER_FORCE_LIMIT;
+    else if (force < -MIXER_FORCE_LIMIT)
+      force = -MIXER_FORCE_LIMIT;
+    // gain + 1 (1..32768) を掛けても 65535 * 32768 < 2^31 に収まる
+    acc += (force * ((int32_t)gain + 1)) >> 15;
+  }
+
+  /**
+   * @brief Device Gain とソフトクリップを適用した合算値を返す
+   * @param device_gain Device Gain (0..255, 255 で等倍)
+   */
+  int16_t mix(uint8_t device_gain) {
+    stat.ticks++;
+    if (acc > MIXER_TORQUE_MAX || acc < -MIXER_TORQUE_MAX)
+      stat.overflow++;
+
+    // 255 -> 256 として 8bit シフトで等倍にする
+    int32_t scaled =
+        (acc * ((int32_t)device_gain + (device_gain >> 7))) >> 8;
+    uint32_t magnitude = (uint32_t)((scaled < 0) ? -scaled : scaled);
+    if (magnitude > stat.peak)
+      stat.peak = magnitude;
+    if (magnitude <= MIXER_KNEE)
+      return (int16_t)scaled;
+
+    // 圧縮域: knee + R * d / (d + R) (R = MAX - knee)。knee で傾き 1 のまま
+    // 接続し、フルスケールへ漸近する
+    stat.soft_clipped++;
+    if (magnitude > MIXER_TORQUE_MAX)
+      stat.clipped++;
+    const uint32_t range = MIXER_TORQUE_MAX - MIXER_KNEE;
+    uint32_t over = magnitude - MIXER_KNEE;
+    if (over > (1u << 18)) // range * over を 32bit に収める (出力は 99% 超)
+      over = 1u << 18;
+    uint32_t level = MIXER_KNEE + (range * over) / (over + range);
+    return (int16_t)((scaled < 0) ? -(int32_t)level : (int32_t)level);
+  }
+
+  /**
+   * @brief 変化量を制限して出力へ書き込む
+   * @return 書き込んだ値
+   */
+  int16_t output(int16_t torque) {
+    int32_t delta = (int32_t)torque - last;
+    if (step_limit > 0 && (delta > step_limit || delta < -step_limit)) {
+      stat.slew_limited++;
+      torque = (int16_t)(last + ((delta > 0) ? step_limit : -step_limit));
+    }
+    last = torque;
+    out.write(torque);
+    return torque;
+  }
+
+  /**
+   * @brief 変化量の制限を適用せず、出力を即座に 0 にする
+   * (Device Control の全停止 / アクチュエータ無効時)
+   */
+  void cutOff() {
+    last = 0;
+    out.write(0);
+  }
+
+  /// @brief 最後に書き込んだ値
+  int16_t lastOutput() const { return last; }
+  void setMaxStep(uint16_t max_step) { step_limit = max_step; }
+  const mixer_stats_t &stats() const { return stat; }
+  void resetStats() { stat = mixer_stats_t(); }
+
+private:
+  TorqueOutput &out;
+  uint16_t step_limit;
+  int32_t acc; ///< 周期内の積算値 (Gain 適用後)
+  int16_t last;
+  mixer_stats_t stat;
+};
+
+#endif // FFB_MIXER_H
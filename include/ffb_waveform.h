@@ -0,0 +1,128 @@
+/**
+ * @file ffb_waveform.h
+ * @brief 周期エフェクト用の波形生成 (Q15, 位相アキュムレータ方式)
+ *
+ * 位相は 32bit 符号無し整数で 1 周期 = 2^32 とする。周期ごとに加算するだけで
+ * 自然に折り返すため、剰余演算が不要となる。
+ *
+ * - 正弦波: コンパイル時に生成した 256 分割テーブル + 線形補間。
+ *   倍精度 sin() に対する誤差は最大 ±4 LSB (Q15, 約 1.2e-4) 以内。
+ * - 矩形波/三角波/のこぎり波: 位相からの整数演算で厳密に求まるため
+ *   テーブルを持たない (テーブル参照より命令数が少ない)。
+ *
+ * sinf() 等の浮動小数点ライブラリは実行時に一切使用しない。
+ */
+
+#ifndef FFB_WAVEFORM_H
+#define FFB_WAVEFORM_H
+
+#include <array>
+#include <stdint.h>
+
+#define WAVE_Q15_MAX 32767
+#define WAVE_SINE_TABLE_BITS 8 ///< 正弦波テーブルの分割数 (2^8 = 256)
+#define WAVE_SINE_TABLE_SIZE (1 << WAVE_SINE_TABLE_BITS)
+
+namespace wave_detail {
+
+constexpr double PI = 3.14159265358979323846;
+
+/// @brief コンパイル時用 sin (テイラー展開, |x| <= PI で十分な精度)
+constexpr double cx_sin(double x) {
+  // [-PI, PI] へ畳み込む
+  while (x > PI)
+    x -= 2.0 * PI;
+  while (x < -PI)
+    x += 2.0 * PI;
+  double term = x;
+  double sum = x;
+  for (int n = 1; n < 12; n++) {
+    term *= -x * x / ((2.0 * n) * (2.0 * n + 1.0));
+    sum += term;
+  }
+  return sum;
+}
+
+constexpr double cx_cos(double x) { return cx_sin(x + PI / 2.0); }
+
+constexpr int16_t cx_round_q15(double v) {
+  double scaled = v * WAVE_Q15_MAX;
+  return (int16_t)(scaled >= 0 ? scaled + 0.5 : scaled - 0.5);
+}
+
+/// @brief 補間用に 1 要素多く持つ正弦波テーブル (Q15)
+constexpr std::array<int16_t, WAVE_SINE_TABLE_SIZE + 1> make_sine_table() {
+  std::array<int16_t, WAVE_SINE_TABLE_SIZE + 1> table{};
+  for (int i = 0; i <= WAVE_SINE_TABLE_SIZE; i++) {
+    table[i] = cx_round_q15(cx_sin(2.0 * PI * i / WAVE_SINE_TABLE_SIZE));
+  }
+  return table;
+}
+
+constexpr std::array<int16_t, WAVE_SINE_TABLE_SIZE + 1> sine_table =
+    make_sine_table();
+
+static_assert(sine_table[0] == 0, "sine table: 0deg");
+static_assert(sine_table[WAVE_SINE_TABLE_SIZE / 4] == WAVE_Q15_MAX,
+              "sine table: 90deg");
+static_assert(sine_table[WAVE_SINE_TABLE_SIZE * 3 / 4] == -WAVE_Q15_MAX,
+              "sine table: 270deg");
+
+} // namespace wave_detail
+
+/// @brief 正弦波 (Q15)。位相 0 で 0、1/4 周期で +32767
+inline int16_t wave_sine_q15(uint32_t phase) {
+  uint32_t index = phase >> (32 - WAVE_SINE_TABLE_BITS);
+  int32_t frac = (int32_t)((phase >> (16 - WAVE_SINE_TABLE_BITS)) & 0xFFFF);
+  int32_t a = wave_detail::sine_table[index];
+  int32_t b = wave_detail::sine_table[index + 1];
+  return (int16_t)(a + (((b - a) * frac) >> 16));
+}
+
+/// @brief 矩形波 (Q15)。前半周期 +32767、後半周期 -32767
+inline int16_t wave_square_q15(uint32_t phase) {
+  return (phase < 0x80000000u) ? WAVE_Q15_MAX : -WAVE_Q15_MAX;
+}
+
+/// @brief 三角波 (Q15)。正弦波と同じ位相関係 (0 から上昇)
+inline int16_t wave_triangle_q15(uint32_t phase) {
+  int32_t u = (int32_t)(phase >> 15); // 0..131071 (1周期)
+  int32_t v;
+  if (u < 32768)
+    v = u;
+  else if (u < 98304)
+    v = 65536 - u;
+  else
+    v = u - 131072;
+  return (int16_t)((v > WAVE_Q15_MAX) ? WAVE_Q15_MAX
+                   : (v < -WAVE_Q15_MAX) ? -WAVE_Q15_MAX
+                                         : v);
+}
+
+/// @brief のこぎり波 (上昇, Q15)。-32767 から +32767 へ
+inline int16_t wave_sawtooth_up_q15(uint32_t phase) {
+  int32_t v = (int32_t)(phase >> 16) - 32768;
+  return (int16_t)((v < -WAVE_Q15_MAX) ? -WAVE_Q15_MAX : v);
+}
+
+/// @brief のこぎり波 (下降, Q15)。+32767 から -32767 へ
+inline int16_t wave_sawtooth_down_q15(uint32_t phase) {
+  return (int16_t)-wave_sawtooth_up_q15(phase);
+}
+
+/**
+ * @brief 周期 [ms] と演算周期 [us] から 1 周期あたりの位相増分を求める
+ * (除算を含むため、周期の変更時のみ呼び出すこと)
+ */
+inline uint32_t wave_phase_step(uint16_t period_ms, uint32_t tick_us) {
+  if (period_ms == 0)
+    return 0;
+  return (uint32_t)(((uint64_t)tick_us << 32) / ((uint64_t)period_ms * 1000u));
+}
+
+/// @brief PID の位相 (0..32767 = 0..360deg) を 32bit 位相へ変換する
+inline uint32_t wave_phase_from_pid(uint16_t phase) {
+  return (uint32_t)(phase & 0x7FFF) << 17;
+}
+
+#endif // FFB_WAVEFORM_H
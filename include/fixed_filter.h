@@ -0,0 +1,315 @@
+/**
+ * @file fixed_filter.h
+ * @brief 軸入力・トルク出力用の固定小数点フィルタ (双二次, メディアン, 1€)
+ * @date 2026-10-16
+ *
+ * 係数はすべてコンパイル時に求め (constexpr)、フィルタはその係数オブジェクトを
+ * テンプレート引数として受け取る。係数は即値として展開され、
+ * 実行時に浮動小数点演算は行わない。
+ *
+ *   static constexpr biquad_coeffs_t TORQUE_LP =
+ *       biquad_lowpass_q15(500.0, 4000.0);
+ *   BiquadQ15<TORQUE_LP> torque_filter;
+ *
+ * - BiquadQ15: 16bit データ, Q14 係数, 32bit 積算 (誤差フィードバック付き)。
+ *   係数の絶対値の合計が 4 未満のもの (低域通過等) のみ使用可 (static_assert)。
+ * - BiquadQ31: 32bit データ, Q29 係数, 64bit 積算。ノッチ等にも使用可。
+ * - MedianFilter: 小さい窓 (3..7) のメディアン。突発的な外れ値の除去用。
+ * - OneEuroFilter: 変化速度に応じて遮断周波数を上げる一次低域通過。
+ *   静止時は強く平滑化し、操作時は遅れを小さくする。
+ *
+ * 各フィルタの1サンプルあたりの処理時間と群遅延は src/native_bench.cpp で計測する。
+ */
+
+#ifndef FIXED_FILTER_H
+#define FIXED_FILTER_H
+
+#include "ffb_waveform.h"
+#include <stdint.h>
+
+// --- 双二次 (biquad) フィルタ ---
+
+/**
+ * @brief 双二次フィルタの係数 (直接形 I)
+ * y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2]
+ */
+typedef struct {
+  int32_t b0, b1, b2, a1, a2;
+  uint8_t frac_bits; ///< 係数の小数部ビット数
+} biquad_coeffs_t;
+
+namespace filter_detail {
+
+constexpr int32_t cx_round(double v) {
+  return (int32_t)(v >= 0 ? v + 0.5 : v - 0.5);
+}
+
+constexpr double cx_abs(double v) { return v < 0 ? -v : v; }
+
+/// @brief 正規化済み (a0 = 1) の係数を固定小数点へ変換する
+constexpr biquad_coeffs_t quantize(double b0, double b1, double b2, double a0,
+                                   double a1, double a2, uint8_t frac_bits) {
+  double scale = (double)(1ll << frac_bits) / a0;
+  return biquad_coeffs_t{cx_round(b0 * scale), cx_round(b1 * scale),
+                         cx_round(b2 * scale), cx_round(a1 * scale),
+                         cx_round(a2 * scale), frac_bits};
+}
+
+/// @brief 低域通過 (RBJ Audio EQ Cookbook)
+constexpr biquad_coeffs_t lowpass(double fc_hz, double fs_hz, double q,
+                                  uint8_t frac_bits) {
+  double w0 = 2.0 * wave_detail::PI * fc_hz / fs_hz;
+  double cw = wave_detail::cx_cos(w0);
+  double alpha = wave_detail::cx_sin(w0) / (2.0 * q);
+  return quantize((1.0 - cw) / 2.0, 1.0 - cw, (1.0 - cw) / 2.0, 1.0 + alpha,
+                  -2.0 * cw, 1.0 - alpha, frac_bits);
+}
+
+/// @brief ノッチ (RBJ Audio EQ Cookbook)
+constexpr biquad_coeffs_t notch(double f0_hz, double fs_hz, double q,
+                                uint8_t frac_bits) {
+  double w0 = 2.0 * wave_detail::PI * f0_hz / fs_hz;
+  double cw = wave_detail::cx_cos(w0);
+  double alpha = wave_detail::cx_sin(w0) / (2.0 * q);
+  return quantize(1.0, -2.0 * cw, 1.0, 1.0 + alpha, -2.0 * cw, 1.0 - alpha,
+                  frac_bits);
+}
+
+/// @brief 係数の絶対値の合計 (積算のオーバーフロー判定用, 係数の単位)
+constexpr int64_t abs_sum(const biquad_coeffs_t &c) {
+  return (int64_t)cx_abs(c.b0) + (int64_t)cx_abs(c.b1) +
+         (int64_t)cx_abs(c.b2) + (int64_t)cx_abs(c.a1) + (int64_t)cx_abs(c.a2);
+}
+
+} // namespace filter_detail
+
+#define FILTER_Q15_COEFF_BITS 14 ///< BiquadQ15 の係数の小数部
+#define FILTER_Q31_COEFF_BITS 29 ///< BiquadQ31 の係数の小数部
+
+/// @brief 低域通過の係数 (BiquadQ15 用)。q = 0.7071 でバターワース
+constexpr biquad_coeffs_t biquad_lowpass_q15(double fc_hz, double fs_hz,
+                                             double q = 0.70710678) {
+  return filter_detail::lowpass(fc_hz, fs_hz, q, FILTER_Q15_COEFF_BITS);
+}
+/// @brief 低域通過の係数 (BiquadQ31 用)
+constexpr biquad_coeffs_t biquad_lowpass_q31(double fc_hz, double fs_hz,
+                                             double q = 0.70710678) {
+  return filter_detail::lowpass(fc_hz, fs_hz, q, FILTER_Q31_COEFF_BITS);
+}
+/// @brief ノッチの係数 (BiquadQ31 用)。機構の共振の除去等
+constexpr biquad_coeffs_t biquad_notch_q31(double f0_hz, double fs_hz,
+                                           double q = 2.0) {
+  return filter_detail::notch(f0_hz, fs_hz, q, FILTER_Q31_COEFF_BITS);
+}
+
+/**
+ * @brief 16bit データの双二次フィルタ (32bit 積算)
+ * 出力の丸め誤差は次のサンプルへ持ち越し (誤差フィードバック)、
+ * 低い遮断周波数でのリミットサイクルと直流誤差を抑える。
+ */
+template <const biquad_coeffs_t &C> class BiquadQ15 {
+  static_assert(C.frac_bits == FILTER_Q15_COEFF_BITS,
+                "biquad_*_q15() で求めた係数を使用すること");
+  static_assert(filter_detail::abs_sum(C) * 32768 < INT32_MAX,
+                "32bit 積算があふれる係数。BiquadQ31 を使用すること");
+
+public:
+  BiquadQ15() { reset(0); }
+
+  /// @brief 内部状態を value で定常とみなして初期化する
+  void reset(int16_t value) {
+    x1 = x2 = y1 = y2 = value;
+    err = 0;
+  }
+
+  int16_t process(int16_t x) {
+    int32_t acc = err + C.b0 * x + C.b1 * x1 + C.b2 * x2 - C.a1 * y1 -
+                  C.a2 * y2;
+    int32_t y = acc >> C.frac_bits;
+    err = acc - (y << C.frac_bits);
+    if (y > 32767)
+      y = 32767;
+    else if (y < -32768)
+      y = -32768;
+    x2 = x1;
+    x1 = x;
+    y2 = y1;
+    y1 = (int16_t)y;
+    return (int16_t)y;
+  }
+
+private:
+  int16_t x1, x2, y1, y2;
+  int32_t err; ///< 前サンプルの丸め誤差
+};
+
+/**
+ * @brief 32bit データの双二次フィルタ (64bit 積算)
+ */
+template <const biquad_coeffs_t &C> class BiquadQ31 {
+  static_assert(C.frac_bits == FILTER_Q31_COEFF_BITS,
+                "biquad_*_q31() で求めた係数を使用すること");
+  static_assert(filter_detail::abs_sum(C) < (8ll << FILTER_Q31_COEFF_BITS),
+                "64bit 積算があふれる係数");
+
+public:
+  BiquadQ31() { reset(0); }
+
+  void reset(int32_t value) {
+    x1 = x2 = y1 = y2 = value;
+    err = 0;
+  }
+
+  int32_t process(int32_t x) {
+    int64_t acc = err + (int64_t)C.b0 * x + (int64_t)C.b1 * x1 +
+                  (int64_t)C.b2 * x2 - (int64_t)C.a1 * y1 -
+                  (int64_t)C.a2 * y2;
+    int64_t y = acc >> C.frac_bits;
+    err = acc - (y << C.frac_bits);
+    if (y > INT32_MAX)
+      y = INT32_MAX;
+    else if (y < INT32_MIN)
+      y = INT32_MIN;
+    x2 = x1;
+    x1 = x;
+    y2 = y1;
+    y1 = (int32_t)y;
+    return (int32_t)y;
+  }
+
+  /// @brief 16bit の軸/トルクを Q31 へ拡張して処理する
+  int16_t process16(int16_t x) {
+    return (int16_t)(process((int32_t)x << 16) >> 16);
+  }
+
+private:
+  int32_t x1, x2, y1, y2;
+  int64_t err;
+};
+
+// --- メディアンフィルタ ---
+
+/**
+ * @brief 小さい窓のメディアンフィルタ (群遅延 (N-1)/2 サンプル)
+ * 整列済みの窓を保持し、最古の値を除いて新しい値を挿入する (O(N))。
+ */
+template <typename T, uint8_t N> class MedianFilter {
+  static_assert(N >= 3 && N <= 15 && (N & 1) == 1,
+                "窓の大きさは 3..15 の奇数とすること");
+
+public:
+  MedianFilter() { reset(0); }
+
+  void reset(T value) {
+    for (uint8_t i = 0; i < N; i++)
+      history[i] = sorted[i] = value;
+    oldest = 0;
+  }
+
+  T process(T x) {
+    T removed = history[oldest];
+    history[oldest] = x;
+    oldest = (uint8_t)((oldest + 1 < N) ? oldest + 1 : 0);
+
+    // 除く値の位置を探し、新しい値の位置まで要素をずらして挿入する
+    uint8_t i = 0;
+    while (sorted[i] != removed)
+      i++;
+    while (i > 0 && sorted[i - 1] > x) {
+      sorted[i] = sorted[i - 1];
+      i--;
+    }
+    while (i < N - 1 && sorted[i + 1] < x) {
+      sorted[i] = sorted[i + 1];
+      i++;
+    }
+    sorted[i] = x;
+    return sorted[N / 2];
+  }
+
+private:
+  T history[N]; ///< 入力順 (リング)
+  T sorted[N];  ///< 昇順
+  uint8_t oldest;
+};
+
+// --- 1€ (One Euro) フィルタ ---
+
+/**
+ * @brief 1€ フィルタの係数 (角周波数は 1 サンプルあたり, Q16)
+ */
+typedef struct {
+  uint32_t w_min_q16;   ///< 最小遮断周波数
+  uint32_t w_beta_q16;  ///< 速度 1 [LSB/サンプル] あたりの増分
+  uint32_t d_alpha_q16; ///< 速度推定の平滑化係数
+} one_euro_coeffs_t;
+
+namespace filter_detail {
+constexpr uint32_t cx_alpha_q16(double w) {
+  return (uint32_t)cx_round(w / (1.0 + w) * 65536.0);
+}
+} // namespace filter_detail
+
+/**
+ * @brief 1€ フィルタの係数を求める
+ * @param fs_hz サンプリング周波数
+ * @param min_cutoff_hz 静止時の遮断周波数 (小さいほど静止時のノイズが減る)
+ * @param beta 速度 1 [LSB/s] あたりの遮断周波数の増分 [Hz] (大きいほど遅れが減る)
+ * @param d_cutoff_hz 速度推定の遮断周波数。低すぎると速度の推定が遅れ、
+ *                    操作開始時の遅れが大きくなる (4kHz では 20Hz 程度)
+ */
+constexpr one_euro_coeffs_t one_euro_coeffs(double fs_hz, double min_cutoff_hz,
+                                            double beta, double d_cutoff_hz) {
+  return one_euro_coeffs_t{
+      (uint32_t)filter_detail::cx_round(2.0 * wave_detail::PI * min_cutoff_hz /
+                                        fs_hz * 65536.0),
+      // w = 2π (min + beta |dx/dt|) / fs, dx/dt = dx [LSB/サンプル] * fs
+      (uint32_t)filter_detail::cx_round(2.0 * wave_detail::PI * beta *
+                                        65536.0),
+      filter_detail::cx_alpha_q16(2.0 * wave_detail::PI * d_cutoff_hz /
+                                  fs_hz)};
+}
+
+/**
+ * @brief 1€ フィルタ (16bit データ)
+ * 平滑化係数 alpha = w / (1 + w) の算出に 32bit 除算を1回行う
+ * (RP2040 はハードウェア除算器を持つ)。内部値は Q8 で保持する。
+ */
+template <const one_euro_coeffs_t &C> class OneEuroFilter {
+public:
+  OneEuroFilter() { reset(0); }
+
+  void reset(int16_t value) {
+    y_q8 = (int32_t)value << 8;
+    dx_q8 = 0;
+    prev = value;
+  }
+
+  int16_t process(int16_t x) {
+    // 速度 [LSB/サンプル] を一次低域通過で推定する
+    int32_t dx = (int32_t)x - prev;
+    prev = x;
+    dx_q8 += (int32_t)(((int64_t)((dx << 8) - dx_q8) * C.d_alpha_q16) >> 16);
+
+    // 速度に応じた遮断周波数 -> 平滑化係数
+    uint32_t speed_q8 = (uint32_t)((dx_q8 < 0) ? -dx_q8 : dx_q8);
+    uint64_t w = C.w_min_q16 + (((uint64_t)C.w_beta_q16 * speed_q8) >> 8);
+    if (w > W_MAX_Q16)
+      w = W_MAX_Q16;
+    // alpha = w / (1 + w) = 1 - 1 / (1 + w)
+    uint32_t alpha_q16 =
+        65536u - (uint32_t)(0xFFFFFFFFu / (65536u + (uint32_t)w));
+
+    y_q8 += (int32_t)(((int64_t)(((int32_t)x << 8) - y_q8) * alpha_q16) >> 16);
+    return (int16_t)((y_q8 + 128) >> 8);
+  }
+
+private:
+  static constexpr uint32_t W_MAX_Q16 = 64u << 16; ///< alpha ≒ 0.985 で飽和
+
+  int32_t y_q8;  ///< 出力 (Q8)
+  int32_t dx_q8; ///< 速度の推定値 (Q8)
+  int16_t prev;
+};
+
+#endif // FIXED_FILTER_H
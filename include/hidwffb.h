@@ -6,7 +6,6 @@
 #ifndef HIDWFFB_H
 #define HIDWFFB_H
 
-#include "pico/mutex.h"
 #include <Adafruit_TinyUSB.h>
 #include <Arduino.h>
 #include <stdbool.h>
@@ -14,36 +13,107 @@
 
 // --- 定数定義 ---
 #define HID_FFB_REPORT_SIZE 64 ///< FFB受信用レポートのバッファサイズ
-#define MAX_EFFECTS 10         // 必要に応じて調整
+#define MAX_EFFECTS 40         ///< エフェクトブロック数 (Block Index 1..40)
+#define HID_RX_QUEUE_DEPTH 16  ///< Output Report 受信キュー段数 (2のべき乗)
+#define FFB_DURATION_INFINITE 0xFFFF ///< duration: 無期限
+#define FFB_LOOP_INFINITE 0xFF       ///< loopCount: 無限に繰り返す
+#define FFB_CUSTOM_CHANNELS 4          ///< Custom Force を同時に受信できる数
+#define FFB_CUSTOM_RING_SAMPLES 512    ///< 1チャネルのサンプル数 (2のべき乗)
+#define FFB_CUSTOM_CHUNK_SAMPLES 29    ///< ID 2 の1レポートで送るサンプル数
+#define FFB_CUSTOM_PERIOD_MIN_US 50    ///< サンプル周期の下限 [us]
+#define HID_HIRES_MAX_SAMPLES 5 ///< 高分解能入力の1レポートのサンプル数
+#define HID_HIRES_INTERFACES 2  ///< 高分解能入力のインタフェース数
+#define HID_HIRES_QUEUE_DEPTH 64 ///< Core1 -> Core0 のサンプル数 (2のべき乗)
 
 // --- Report IDs (Host to Device) ---
 #define HID_ID_SET_EFFECT 0x01
-#define HID_ID_SET_ENVELOPE 0x02
+#define HID_ID_VENDOR_FFB 0x02 ///< 汎用 FFB データ (ベンダ定義, 64byte)
 #define HID_ID_SET_CONDITION 0x03
 #define HID_ID_SET_PERIODIC 0x04
 #define HID_ID_SET_CONSTANT_FORCE 0x05
 #define HID_ID_SET_RAMP_FORCE 0x06
 #define HID_ID_SET_CUSTOM_FORCE 0x07
-// ...
+// 0x02 はベンダ定義レポートが使用済みのため、Set Envelope は空き ID を使う
+#define HID_ID_SET_ENVELOPE 0x08
 #define HID_ID_EFFECT_OPERATION 0x0A // エフェクトのStart/Stop
-#define HID_ID_DEVICE_CONTROL 0x0B   // 全停止/リセット
+#define HID_ID_DEVICE_CONTROL 0x0B   // 全停止/リセット/一時停止
+#define HID_ID_BLOCK_FREE 0x0C       // エフェクトブロックの解放
 #define HID_ID_DEVICE_GAIN 0x0D      // 全体ゲイン
 
+// --- Report IDs (Feature) ---
+#define HID_ID_CREATE_NEW_EFFECT 0x11 ///< Set: エフェクトブロックの確保要求
+#define HID_ID_BLOCK_LOAD 0x12        ///< Get: 確保の結果
+#define HID_ID_POOL 0x13              ///< Get: ブロック数・管理方式
+#define HID_ID_CUSTOM_FORCE_STATUS 0x14 ///< Get: Custom Force の受信状況
+
+// --- Report IDs (Device to Host, 高分解能入力インタフェース) ---
+#define HID_ID_HIRES_INPUT 0x15 ///< 周期ごとのサンプルを1フレーム分まとめる
+
+// --- ベンダ定義レポート (ID 2) の先頭バイト ---
+// これ以外の内容は従来どおり hidwffb_get_ffb_data() で取得できる
+#define HID_VENDOR_CMD_CUSTOM_FORCE 0xCF ///< Custom Force のサンプル列
+
+// --- Output Report のペイロード長 (Report ID を除く = 記述子の Report Count) ---
+// 記述子と構造体の整合は下記の static_assert で保証する
+#define PID_RC_SET_EFFECT 14
+#define PID_RC_SET_ENVELOPE 9
+#define PID_RC_SET_CONDITION 14
+#define PID_RC_SET_PERIODIC 9
+#define PID_RC_SET_CONSTANT_FORCE 3
+#define PID_RC_SET_RAMP_FORCE 5
+#define PID_RC_SET_CUSTOM_FORCE 3
+#define PID_RC_EFFECT_OPERATION 3
+#define PID_RC_DEVICE_GAIN 1
+#define PID_RC_DEVICE_CONTROL 1
+#define PID_RC_BLOCK_FREE 1
+#define PID_RC_CREATE_NEW_EFFECT 3
+#define PID_RC_BLOCK_LOAD 4
+#define PID_RC_POOL 4
+#define PID_RC_CUSTOM_FORCE_STATUS (FFB_CUSTOM_CHANNELS * 7)
+#define HID_RC_HIRES_INPUT (8 + HID_HIRES_MAX_SAMPLES * 10)
+#define PID_DISPATCH_TABLE_SIZE 0x12 ///< 振り分け表の大きさ (最大ID + 1)
+
+// --- Block Load Status ---
+#define PID_BLOCK_LOAD_SUCCESS 0x01
+#define PID_BLOCK_LOAD_FULL 0x02
+#define PID_BLOCK_LOAD_ERROR 0x03
+
+// --- Pool Report のフラグ ---
+#define PID_POOL_DEVICE_MANAGED 0x01 ///< ブロックの割当てをデバイスが行う
+#define PID_POOL_SHARED_PARAMS 0x02  ///< パラメータブロックの共有 (未対応)
+
 // --- Effect Types (ET) ---
 #define HID_ET_CONSTANT 0x26 // Constant Force
 #define HID_ET_RAMP 0x27
+#define HID_ET_CUSTOM 0x28 ///< Custom Force (サンプル列は ID 2 で受信)
 #define HID_ET_SQUARE 0x30
 #define HID_ET_SINE 0x31
+#define HID_ET_TRIANGLE 0x32
+#define HID_ET_SAWTOOTH_UP 0x33
+#define HID_ET_SAWTOOTH_DOWN 0x34
 #define HID_ET_SPRING 0x40 // Spring
 #define HID_ET_DAMPER 0x41 // Damper
 #define HID_ET_INERTIA 0x42
 #define HID_ET_FRICTION 0x43
 
+/// @brief 条件エフェクト (Set Condition のパラメータブロックを使う種類) か
+inline bool ffb_type_is_condition(uint8_t type) {
+  return type >= HID_ET_SPRING && type <= HID_ET_FRICTION;
+}
+
 // --- Effect Operations ---
 #define HID_OP_START 0x01
 #define HID_OP_SOLO 0x02
 #define HID_OP_STOP 0x03
 
+// --- Device Control (0x0B) ---
+#define HID_DC_ENABLE_ACTUATORS 0x01
+#define HID_DC_DISABLE_ACTUATORS 0x02
+#define HID_DC_STOP_ALL_EFFECTS 0x03
+#define HID_DC_DEVICE_RESET 0x04
+#define HID_DC_DEVICE_PAUSE 0x05
+#define HID_DC_DEVICE_CONTINUE 0x06
+
 /**
  * @brief カスタム HID レポート構造体 (16bit 軸 x 3, Button x 16)
  * Core 1 -> Core 0 (物理入力/レポート用)を兼ねる
@@ -55,6 +125,37 @@ typedef struct {
   uint16_t buttons; ///< ボタン (16ビット分) [1:Pressed, 0:Released]
 } custom_gamepad_report_t;
 
+/**
+ * @brief 高分解能入力の1サンプル (Core1 の1周期分)
+ */
+typedef struct {
+  uint16_t offset_us; ///< 先頭サンプルの取得時刻からの経過時間
+  int16_t steer;      ///< 操舵 (ゲームパッドレポートと同じ値)
+  int16_t accel;      ///< アクセル
+  int16_t brake;      ///< ブレーキ
+  int16_t torque;     ///< 同じ周期に出力したトルク指令値
+} __attribute__((packed)) hidwffb_hires_sample_t;
+
+/**
+ * @brief 高分解能入力レポート (ID: 0x15, Report ID を除く)
+ * ゲームパッドとは別のインタフェース (別のエンドポイント) で送るため、
+ * ゲーム向けのレポートの送信周期・内容には影響しない。
+ * Core1 が周期ごとに取得したサンプルを、USB フレームごとにまとめて送る。
+ * 1フレームに HID_HIRES_INTERFACES 個のインタフェースから1レポートずつ
+ * 送るため、ホストは sequence の順に並べ直して連結する
+ */
+typedef struct {
+  uint8_t sampleCount;   ///< 0..HID_HIRES_MAX_SAMPLES
+  uint8_t pending;       ///< 送信時点でキューに残っていたサンプル数
+  uint16_t sequence;     ///< 先頭サンプルの通番 (キュー満杯で捨てても加算)
+  uint32_t timestamp_us; ///< 先頭サンプルの取得時刻 (Core1 の micros())
+  hidwffb_hires_sample_t samples[HID_HIRES_MAX_SAMPLES];
+} __attribute__((packed)) hidwffb_hires_report_t;
+static_assert(sizeof(hidwffb_hires_report_t) == HID_RC_HIRES_INPUT,
+              "hidwffb_hires_report_t のサイズが記述子と一致しません");
+static_assert(1 + sizeof(hidwffb_hires_report_t) <= 64,
+              "高分解能入力レポートがエンドポイントの 64byte を超えています");
+
 // --- PID (Force Feedback) レポート構造体定義 ---
 // 扱うデータが密なため、__attribute__((packed)) を使用する
 /**
@@ -92,6 +193,148 @@ typedef struct {
   int16_t magnitude;        ///< -32767..32767
 } __attribute__((packed)) USB_FFB_Report_SetConstantForce_t;
 
+/**
+ * @brief Set Envelope Output Report (ID: 0x08)
+ * Constant/Periodic エフェクトの立ち上がり (Attack) と立ち下がり (Fade)
+ */
+typedef struct {
+  uint8_t reportId;         ///< = 0x08
+  uint8_t effectBlockIndex; ///< 1..40
+  uint16_t attackLevel;     ///< 0..32767 (開始時の強さ)
+  uint16_t fadeLevel;       ///< 0..32767 (終了時の強さ)
+  uint16_t attackTime;      ///< 0..65535 (ms, 開始から定常値までの時間)
+  uint16_t fadeTime;        ///< 0..65535 (ms, 減衰開始から終了までの時間)
+} __attribute__((packed)) USB_FFB_Report_SetEnvelope_t;
+
+/**
+ * @brief Set Condition Output Report (ID: 0x03)
+ * Spring/Damper/Inertia/Friction の特性。係数は -32767..32767 を -1.0..1.0
+ * とし、Spring は位置、Damper/Friction は速度、Inertia は加速度に作用する
+ */
+typedef struct {
+  uint8_t reportId;             ///< = 0x03
+  uint8_t effectBlockIndex;     ///< 1..40
+  uint8_t parameterBlockOffset; ///< 軸番号 (0 = 操舵軸のみ対応)
+  int16_t cpOffset;             ///< -32767..32767 (中心位置)
+  int16_t positiveCoefficient;  ///< -32767..32767 (中心より正側の係数)
+  int16_t negativeCoefficient;  ///< -32767..32767 (中心より負側の係数)
+  uint16_t positiveSaturation;  ///< 0..32767 (正方向の力の上限)
+  uint16_t negativeSaturation;  ///< 0..32767 (負方向の力の上限)
+  uint16_t deadBand;            ///< 0..32767 (中心からの不感帯幅)
+} __attribute__((packed)) USB_FFB_Report_SetCondition_t;
+
+/**
+ * @brief Set Periodic Output Report (ID: 0x04)
+ */
+typedef struct {
+  uint8_t reportId;         ///< = 0x04
+  uint8_t effectBlockIndex; ///< 1..40
+  uint16_t magnitude;       ///< 0..32767 (振幅)
+  int16_t offset;           ///< -32767..32767 (中心値)
+  uint16_t phase;           ///< 0..32767 (0..359.99 deg, 開始位相)
+  uint16_t period;          ///< 0..65535 (ms, 1周期の長さ)
+} __attribute__((packed)) USB_FFB_Report_SetPeriodic_t;
+
+/**
+ * @brief Set Ramp Force Output Report (ID: 0x06)
+ */
+typedef struct {
+  uint8_t reportId;         ///< = 0x06
+  uint8_t effectBlockIndex; ///< 1..40
+  int16_t rampStart;        ///< -32767..32767 (開始時の力)
+  int16_t rampEnd;          ///< -32767..32767 (duration 経過時の力)
+} __attribute__((packed)) USB_FFB_Report_SetRampForce_t;
+
+/**
+ * @brief Set Custom Force Output Report (ID: 0x07)
+ * 受信時にサンプル列のチャネルを割り当て、チャンク番号を 0 に戻す
+ */
+typedef struct {
+  uint8_t reportId;         ///< = 0x07
+  uint8_t effectBlockIndex; ///< 1..40
+  uint16_t samplePeriod_us; ///< 1サンプルの時間 [us] (0: Core1 の周期)
+} __attribute__((packed)) USB_FFB_Report_SetCustomForce_t;
+
+/**
+ * @brief Custom Force のサンプル列 (ベンダ定義 Output Report ID: 0x02)
+ * チャンク番号が期待値と異なるもの、リングに全て入らないものは破棄する
+ * (部分的には取り込まない)。ホストは Custom Force Status を読み、
+ * nextSequence から再送する
+ */
+typedef struct {
+  uint8_t reportId;         ///< = 0x02
+  uint8_t command;          ///< = HID_VENDOR_CMD_CUSTOM_FORCE
+  uint8_t effectBlockIndex; ///< 1..40
+  uint16_t sequence;        ///< チャンク番号 (0x07 受信後 0 から)
+  uint8_t sampleCount;      ///< 有効なサンプル数 (1..29)
+  int16_t samples[FFB_CUSTOM_CHUNK_SAMPLES]; ///< 力 (-32767..32767)
+} __attribute__((packed)) USB_FFB_Report_CustomForceData_t;
+static_assert(sizeof(USB_FFB_Report_CustomForceData_t) - 1 <=
+                  HID_FFB_REPORT_SIZE,
+              "Custom Force のチャンクが ID 2 のレポートを超えています");
+
+/**
+ * @brief Device Control Output Report (ID: 0x0B)
+ */
+typedef struct {
+  uint8_t reportId; ///< = 0x0B
+  uint8_t control;  ///< HID_DC_*
+} __attribute__((packed)) USB_FFB_Report_DeviceControl_t;
+
+/**
+ * @brief Block Free Output Report (ID: 0x0C)
+ */
+typedef struct {
+  uint8_t reportId;         ///< = 0x0C
+  uint8_t effectBlockIndex; ///< 1..40
+} __attribute__((packed)) USB_FFB_Report_BlockFree_t;
+
+/**
+ * @brief Create New Effect Feature Report (ID: 0x11, Host -> Device)
+ */
+typedef struct {
+  uint8_t reportId;   ///< = 0x11
+  uint8_t effectType; ///< HID_ET_*
+  uint16_t byteCount; ///< Custom Force のバイト数 (未対応, 無視)
+} __attribute__((packed)) USB_FFB_Report_CreateNewEffect_t;
+
+/**
+ * @brief Block Load Feature Report (ID: 0x12, Device -> Host)
+ * 直前の Create New Effect の結果
+ */
+typedef struct {
+  uint8_t reportId;          ///< = 0x12
+  uint8_t effectBlockIndex;  ///< 確保したブロック (1..40, 失敗時 0)
+  uint8_t loadStatus;        ///< PID_BLOCK_LOAD_*
+  uint16_t ramPoolAvailable; ///< 残りのブロック領域 [byte]
+} __attribute__((packed)) USB_FFB_Report_BlockLoad_t;
+
+/**
+ * @brief Pool Feature Report (ID: 0x13, Device -> Host)
+ */
+typedef struct {
+  uint8_t reportId;               ///< = 0x13
+  uint16_t ramPoolSize;           ///< ブロック領域の大きさ [byte]
+  uint8_t simultaneousEffectsMax; ///< 同時に確保できるブロック数
+  uint8_t memoryManagement;       ///< PID_POOL_* のビット
+} __attribute__((packed)) USB_FFB_Report_Pool_t;
+
+/// @brief Custom Force の1チャネル分の受信状況
+typedef struct {
+  uint8_t effectBlockIndex; ///< 割当て先 (0: 空き)
+  uint16_t nextSequence;    ///< 次に受け付けるチャンク番号
+  uint16_t freeSamples;     ///< リングの空き [サンプル]
+  uint16_t underruns;       ///< 再生時にサンプルが不足した周期数
+} __attribute__((packed)) ffb_custom_stream_status_t;
+
+/**
+ * @brief Custom Force Status Feature Report (ID: 0x14, Device -> Host)
+ */
+typedef struct {
+  uint8_t reportId; ///< = 0x14
+  ffb_custom_stream_status_t channel[FFB_CUSTOM_CHANNELS];
+} __attribute__((packed)) USB_FFB_Report_CustomForceStatus_t;
+
 /**
  * @brief Device Gain Output Report (ID: 0x0D)
  */
@@ -100,6 +343,46 @@ typedef struct {
   uint8_t deviceGain; ///< 0..255
 } __attribute__((packed)) USB_FFB_Report_DeviceGain_t;
 
+// 構造体サイズ (Report ID 含む) と記述子の Report Count の整合チェック
+static_assert(sizeof(USB_FFB_Report_SetEffect_t) - 1 == PID_RC_SET_EFFECT,
+              "Set Effect: 構造体と記述子の Report Count が不一致");
+static_assert(sizeof(USB_FFB_Report_EffectOperation_t) - 1 ==
+                  PID_RC_EFFECT_OPERATION,
+              "Effect Operation: 構造体と記述子の Report Count が不一致");
+static_assert(sizeof(USB_FFB_Report_SetConstantForce_t) - 1 ==
+                  PID_RC_SET_CONSTANT_FORCE,
+              "Set Constant Force: 構造体と記述子の Report Count が不一致");
+static_assert(sizeof(USB_FFB_Report_SetEnvelope_t) - 1 == PID_RC_SET_ENVELOPE,
+              "Set Envelope: 構造体と記述子の Report Count が不一致");
+static_assert(sizeof(USB_FFB_Report_SetCondition_t) - 1 ==
+                  PID_RC_SET_CONDITION,
+              "Set Condition: 構造体と記述子の Report Count が不一致");
+static_assert(sizeof(USB_FFB_Report_SetPeriodic_t) - 1 == PID_RC_SET_PERIODIC,
+              "Set Periodic: 構造体と記述子の Report Count が不一致");
+static_assert(sizeof(USB_FFB_Report_SetRampForce_t) - 1 ==
+                  PID_RC_SET_RAMP_FORCE,
+              "Set Ramp Force: 構造体と記述子の Report Count が不一致");
+static_assert(sizeof(USB_FFB_Report_SetCustomForce_t) - 1 ==
+                  PID_RC_SET_CUSTOM_FORCE,
+              "Set Custom Force: 構造体と記述子の Report Count が不一致");
+static_assert(sizeof(USB_FFB_Report_CustomForceStatus_t) - 1 ==
+                  PID_RC_CUSTOM_FORCE_STATUS,
+              "Custom Force Status: 構造体と記述子の Report Count が不一致");
+static_assert(sizeof(USB_FFB_Report_DeviceGain_t) - 1 == PID_RC_DEVICE_GAIN,
+              "Device Gain: 構造体と記述子の Report Count が不一致");
+static_assert(sizeof(USB_FFB_Report_DeviceControl_t) - 1 ==
+                  PID_RC_DEVICE_CONTROL,
+              "Device Control: 構造体と記述子の Report Count が不一致");
+static_assert(sizeof(USB_FFB_Report_BlockFree_t) - 1 == PID_RC_BLOCK_FREE,
+              "Block Free: 構造体と記述子の Report Count が不一致");
+static_assert(sizeof(USB_FFB_Report_CreateNewEffect_t) - 1 ==
+                  PID_RC_CREATE_NEW_EFFECT,
+              "Create New Effect: 構造体と記述子の Report Count が不一致");
+static_assert(sizeof(USB_FFB_Report_BlockLoad_t) - 1 == PID_RC_BLOCK_LOAD,
+              "Block Load: 構造体と記述子の Report Count が不一致");
+static_assert(sizeof(USB_FFB_Report_Pool_t) - 1 == PID_RC_POOL,
+              "Pool: 構造体と記述子の Report Count が不一致");
+
 /**
  * @brief パースされたPIDデータの要約（デバッグ出力用）
  */
@@ -113,34 +396,173 @@ typedef struct {
   bool updated;
 } pid_debug_info_t;
 
+/**
+ * @brief 受信した Output Report 1件分 (受信キューの要素)
+ */
+typedef struct {
+  uint32_t timestamp_us; ///< 受信時刻 (micros())
+  uint16_t len;          ///< data の有効長 (Report ID を除く)
+  uint8_t reportId;
+  uint8_t data[HID_FFB_REPORT_SIZE]; ///< Report ID を除くペイロード
+} hidwffb_rx_report_t;
+
+/**
+ * @brief 受信キューの統計 (キュー段数の設計用)
+ */
+typedef struct {
+  uint16_t queued;         ///< 現在の滞留数
+  uint16_t high_water;     ///< 起動後の最大滞留数
+  uint16_t capacity;       ///< キュー段数
+  uint32_t overflow_count; ///< キュー満杯で破棄したレポート数
+} hidwffb_rx_stats_t;
+
+// --- エフェクトブロック (Core 0 -> Core 1 の受け渡し単位) ---
+// 種類ごとのパラメータブロックは同時に使われないため共用体で重ね、
+// 全ブロックを同じ固定長とする (40 ブロック分を Core 間で受け渡す)
+
+/// @brief Set Condition (0x03) のパラメータ (Spring/Damper/Inertia/Friction)
+typedef struct {
+  int16_t cpOffset;            ///< 中心位置
+  int16_t positiveCoefficient; ///< 正側の係数
+  int16_t negativeCoefficient; ///< 負側の係数
+  uint16_t positiveSaturation; ///< 正方向の力の上限
+  uint16_t negativeSaturation; ///< 負方向の力の上限
+  uint16_t deadBand;           ///< 不感帯幅
+} ffb_condition_block_t;
+
+/// @brief Set Envelope (0x08) のパラメータ
+typedef struct {
+  uint16_t attackLevel;   ///< 開始時の強さ
+  uint16_t fadeLevel;     ///< 終了時の強さ
+  uint16_t attackTime_ms; ///< Attack 時間
+  uint16_t fadeTime_ms;   ///< Fade 時間
+} ffb_envelope_block_t;
+
+/// @brief Set Periodic (0x04) のパラメータ (振幅は magnitude)
+typedef struct {
+  int16_t offset;     ///< 中心値
+  uint16_t phase;     ///< 開始位相 (0..32767)
+  uint16_t period_ms; ///< 周期
+} ffb_periodic_block_t;
+
+/// @brief Set Ramp Force (0x06) のパラメータ
+typedef struct {
+  int16_t start; ///< 開始時の力
+  int16_t end;   ///< 終了時の力
+} ffb_ramp_block_t;
+
+/// @brief Set Custom Force (0x07) のパラメータ (サンプル列はチャネルで渡す)
+typedef struct {
+  uint16_t samplePeriod_us; ///< 1サンプルの時間 [us] (0: Core1 の周期)
+  uint16_t startPosition; ///< チャネル割当て時のリングの書込位置
+  uint8_t channel;        ///< 1..FFB_CUSTOM_CHANNELS (0: 未割当て)
+} ffb_custom_block_t;
+
+/// @brief Constant/Ramp/周期/Custom Force のパラメータ
+typedef struct {
+  ffb_envelope_block_t envelope;
+  union {
+    ffb_periodic_block_t periodic; ///< Square..Sawtooth Down
+    ffb_ramp_block_t ramp;         ///< Ramp
+    ffb_custom_block_t custom;     ///< Custom Force
+  };
+} ffb_force_block_t;
+
 // Core間通信用構造体
 // Core 0 -> Core 1 (FFB命令)
 typedef struct {
-  int16_t magnitude;
-  int16_t gain; ///< 0x01 で設定される Gain
-  uint8_t type;
-  volatile bool active;
-  volatile bool isCoolBackTest; ///< 5秒間のテストモードフラグ
+  int16_t magnitude; ///< 0x05: 力, 0x04: 振幅 (0..32767)
+  int16_t gain;      ///< 0x01 で設定される Gain
+  uint8_t type;      ///< 0x11 / 0x01 で設定される Effect Type (0: 未設定)
+  uint16_t duration_ms;              ///< 0x01 で設定される duration (0xFFFF: 無期限)
+  uint16_t startDelay_ms;            ///< 0x01 で設定される開始遅延
+  uint16_t triggerRepeatInterval_ms; ///< 0x01 で設定される繰り返し間隔
+  uint8_t loopCount;                 ///< 0x0A (Start) で設定される再生回数 (0xFF: 無限)
+  uint8_t startCount;                ///< Start 操作ごとに加算 (Core1 での再始動検出用)
+  bool active;
+  bool isCoolBackTest; ///< 5秒間のテストモードフラグ
+  // type が条件エフェクトなら condition、それ以外は force を使う
+  union {
+    ffb_condition_block_t condition;
+    ffb_force_block_t force;
+  };
 } FFB_Shared_State_t;
 
+// スロットの集合を示すビットマスク (bit i = スロット i)
+typedef uint64_t ffb_slot_mask_t;
+static_assert(MAX_EFFECTS <= 64, "ffb_slot_mask_t のビット数を超えています");
+static constexpr ffb_slot_mask_t FFB_SLOT_MASK_ALL =
+    (MAX_EFFECTS == 64) ? ~(ffb_slot_mask_t)0
+                        : (((ffb_slot_mask_t)1 << MAX_EFFECTS) - 1);
+
+/**
+ * @brief デバイス全体の状態 (Device Control 0x0B, Core 0 -> Core 1)
+ * 全停止はスロットを走査せず、stop_epoch の変化として伝える。
+ * Core1 は周期ごとに stop_epoch を1回比較するだけで全停止を検出できる
+ */
+typedef struct {
+  uint32_t stop_epoch;    ///< Stop All / Reset / Solo ごとに加算
+  bool actuators_enabled; ///< false: 演算は続けるがトルクを出さない
+  bool paused;            ///< true: 再生時間を止め、トルクを出さない
+} ffb_device_control_t;
+
 // --- 公開関数 ---
 
-void hidwffb_begin(uint8_t poll_interval_ms = 1);
+/**
+ * @param hires_input 高分解能入力のインタフェースを追加する
+ */
+void hidwffb_begin(uint8_t poll_interval_ms = 1, bool hires_input = false);
 bool hidwffb_send_report(custom_gamepad_report_t *report);
+/**
+ * @brief 高分解能入力のサンプルを積む (Core1 の周期ごとに呼ぶ)
+ * キューが満杯の場合は捨てる (通番は進むため、ホストで欠落を検出できる)
+ * @param time_us 入力を取得した時刻 (micros())
+ */
+void hidwffb_hires_push(uint32_t time_us, const custom_gamepad_report_t &input,
+                        int16_t torque);
+/**
+ * @brief キューのサンプルを、インタフェースごとに最大 HID_HIRES_MAX_SAMPLES
+ * 個まとめて送る (Core0, USB フレームごと)。送信できなかった分は次の
+ * 呼び出しで送り直す
+ * @return 1レポート以上送信した場合 true
+ */
+bool hidwffb_send_hires_report(void);
 bool hidwffb_is_mounted(void);
 void hidwffb_wait_for_mount(void);
 bool hidwffb_ready(void);
 bool hidwffb_get_ffb_data(uint8_t *buffer);
+uint16_t hidwffb_process_reports(uint16_t max_reports);
+void hidwffb_get_rx_stats(hidwffb_rx_stats_t *stats);
 void hidwffb_clear_ffb_flag(void);
 
+/**
+ * @brief USB SOF (1ms ごとのフレーム開始) の観測を有効/無効にする
+ */
+void hidwffb_sof_enable(bool enable);
+/**
+ * @brief 前回から新しい SOF を観測したか判定する (任意のコアから呼び出し可)
+ * @param last_count 呼び出し側が保持する観測済みの SOF 数 (更新される)
+ * @param sof_us 最新の SOF の観測時刻 (micros())
+ */
+bool hidwffb_poll_sof(uint32_t *last_count, uint32_t *sof_us);
+
 void PID_ParseReport(uint8_t const *buffer, uint16_t bufsize);
+void PID_DispatchReport(uint8_t report_id, uint8_t const *payload,
+                        uint16_t len);
 bool hidwffb_get_pid_debug_info(pid_debug_info_t *info);
 
 void ffb_shared_memory_init(); // Core間通信用構造体の初期化
 void ffb_core0_update_shared(pid_debug_info_t *info);
 void ffb_core0_get_input_report(custom_gamepad_report_t *dest);
-void ffb_core1_update_shared(custom_gamepad_report_t *new_input,
-                             FFB_Shared_State_t *local_effects_dest);
-void hidwffb_loopback_test_sync(custom_gamepad_report_t *new_input,
-                                FFB_Shared_State_t *local_effects_dest);
+/// @return local_effects_dest のうち今回書き換えたスロット
+ffb_slot_mask_t ffb_core1_update_shared(custom_gamepad_report_t *new_input,
+                                        FFB_Shared_State_t *local_effects_dest);
+/// @brief FFB命令を受け取り、ループバック後の入力を周期ごとに1回だけ公開する
+ffb_slot_mask_t
+hidwffb_loopback_test_sync(custom_gamepad_report_t *new_input,
+                           FFB_Shared_State_t *local_effects_dest);
+/// @brief Core1 が最後に受け取った Device Gain (0x0D, 0..255)
+uint8_t ffb_core1_device_gain(void);
+/// @brief Core1 が最後に受け取った Device Control (0x0B) の状態
+const ffb_device_control_t &ffb_core1_device_control(void);
 #endif // HIDWFFB_H
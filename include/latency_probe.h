@@ -0,0 +1,93 @@
+/**
+ * @file latency_probe.h
+ * @brief ホットパスの遅延計測 (ビルドフラグ LATENCY_PROBE_ENABLE で有効化)
+ * @date 2026-10-16
+ *
+ * 各段階の所要時間 [us] を micros() (1us タイマ) で計測し、
+ * 2 のべき乗幅の固定バケットのヒストグラムへ集計する。
+ *
+ * - 計測点ごとに書込側のコアは1つに固定する (単一ライタ)。
+ *   ヒストグラムは SeqLock で保持するため、書込側は待たず、
+ *   読出側はどちらのコアからでも一貫したスナップショットを得られる。
+ * - 無効時はマクロが空になり、計測処理は一切生成されない。
+ */
+
+#ifndef LATENCY_PROBE_H
+#define LATENCY_PROBE_H
+
+#include <stdint.h>
+
+#define LATENCY_HIST_BUCKETS 16 ///< バケット数 (最終バケットは 2^14us 以上)
+
+/// @brief 計測点 (括弧内は書込側のコア)
+typedef enum {
+  LAT_RX_TO_DISPATCH = 0,  ///< USB 受信 → PID パース (Core0)
+  LAT_DISPATCH_TO_PUBLISH, ///< PID パース → 共有メモリへ反映 (Core0)
+  LAT_PUBLISH_TO_CORE1,    ///< 共有メモリへ反映 → Core1 が取得 (Core1)
+  LAT_USB_TO_CORE1,        ///< USB 受信 → Core1 が取得 (トルク演算直前, Core1)
+  LAT_SENSOR_TO_HOST,      ///< Core1 の入力書込 → HID 送信 (Core0)
+  LAT_LOOP0_BODY,          ///< Core0 ループ1周期の処理時間 (Core0)
+  LAT_LOOP1_BODY,          ///< Core1 ループ1周期の処理時間 (Core1)
+  LAT_PROBE_COUNT
+} latency_probe_t;
+
+/**
+ * @brief 遅延ヒストグラム
+ * bucket[0] は 0us、bucket[k] (k >= 1) は [2^(k-1), 2^k) us を数える
+ */
+typedef struct {
+  uint32_t count;                        ///< 計測回数
+  uint32_t max_us;                       ///< 最大値
+  uint32_t over_budget;                  ///< 許容時間の超過回数 (周期超過)
+  uint32_t bucket[LATENCY_HIST_BUCKETS]; ///< 区間ごとの回数
+} latency_hist_t;
+
+#ifdef LATENCY_PROBE_ENABLE
+
+/**
+ * @brief 1件の計測値を集計する (計測点の書込側コアのみ呼び出し可)
+ * @param probe 計測点
+ * @param elapsed_us 所要時間 [us]
+ * @param budget_us 許容時間 [us]。超過時は over_budget を加算 (0: 判定無し)
+ */
+void latency_record(latency_probe_t probe, uint32_t elapsed_us,
+                    uint32_t budget_us = 0);
+
+/**
+ * @brief ヒストグラムのスナップショットを取得する (どちらのコアからも可)
+ * @return 一貫した値を取得できた場合 true
+ */
+bool latency_get_hist(latency_probe_t probe, latency_hist_t *dest);
+
+/// @brief 計測点の表示名
+const char *latency_probe_name(latency_probe_t probe);
+
+/**
+ * @brief 全体の permille (‰) 番目が含まれるバケットの上限値 [us]
+ * @return 上限値。最終バケットの場合は max_us
+ */
+uint32_t latency_percentile_us(const latency_hist_t *hist, uint16_t permille);
+
+/**
+ * @brief 計測結果をテレメトリ (TLM_TYPE_LATENCY) へ出力する
+ * Core0 ループから毎周期呼び出す。1回の呼び出しで1計測点分のみ積み、
+ * テレメトリのリングを溢れさせない
+ * @param start true で全計測点の出力を開始する
+ */
+void latency_report_step(bool start);
+
+#define LATENCY_STAMP() micros()
+#define LATENCY_RECORD(probe, start_us)                                        \
+  latency_record((probe), micros() - (start_us))
+#define LATENCY_RECORD_BUDGET(probe, start_us, budget_us)                      \
+  latency_record((probe), micros() - (start_us), (budget_us))
+
+#else
+
+#define LATENCY_STAMP() 0u
+#define LATENCY_RECORD(probe, start_us) ((void)(start_us))
+#define LATENCY_RECORD_BUDGET(probe, start_us, budget_us) ((void)(start_us))
+
+#endif // LATENCY_PROBE_ENABLE
+
+#endif // LATENCY_PROBE_H
@@ -0,0 +1,59 @@
+/**
+ * @file pedal_adc.h
+ * @brief ペダル (アクセル/ブレーキ) の ADC 取得 (DMA リングバッファ)
+ * @date 2026-10-16
+ *
+ * ADC をラウンドロビン・フリーランで変換させ、結果を DMA でリングバッファへ
+ * 書き込み続ける (CPU は介在しない)。Core1 は周期ごとに pedal_adc_read() で
+ * DMA の書込位置の直前にあるサンプルを合算 (pedal_filter.h) するだけのため、
+ * 取得コストは周期あたり数 us で、変換完了を待つことも無い。
+ *
+ * - 変換レート: PEDAL_ADC_SAMPLE_RATE_HZ (全チャネル合計)
+ * - 1回の読出しで各ペダルの最新 16 サンプルを使用する
+ *   (48kHz 時は約 0.67ms 分の移動平均)
+ */
+
+#ifndef PEDAL_ADC_H
+#define PEDAL_ADC_H
+
+#include "pedal_filter.h"
+#include <stdint.h>
+
+#define PEDAL_ADC_SAMPLE_RATE_HZ 48000 ///< 全チャネル合計の変換レート
+#define PEDAL_ADC_RING_BITS 9          ///< リングの大きさ (2^9 = 512 バイト)
+#define PEDAL_ADC_RING_LEN ((1u << PEDAL_ADC_RING_BITS) / sizeof(uint16_t))
+
+/// @brief ペダルの番号
+typedef enum { PEDAL_ACCEL = 0, PEDAL_BRAKE = 1, PEDAL_COUNT } pedal_id_t;
+
+/**
+ * @brief ADC と DMA を設定し、変換を開始する (Core1 の setup1() で呼ぶ)
+ * @param accel_pin アクセルの ADC 入力ピン (GP26..GP29)
+ * @param brake_pin ブレーキの ADC 入力ピン (GP26..GP29, accel_pin と異なること)
+ * @return ピンが ADC 入力でない、または DMA チャネルが確保できない場合 false
+ */
+bool pedal_adc_begin(uint8_t accel_pin, uint8_t brake_pin);
+
+/**
+ * @brief 各ペダルの最新値を取得する (Core1 の周期ごとに呼ぶ)
+ * @param out -32767 (離した状態) .. 32767 (踏み切った状態)
+ * @return 変換開始前 (リングが埋まる前を含む) は false
+ */
+bool pedal_adc_read(int16_t out[PEDAL_COUNT]);
+
+/// @brief デシメーション後の値 (0..PEDAL_RAW_MAX) を取得する (校正用)
+bool pedal_adc_read_raw(uint16_t raw[PEDAL_COUNT]);
+
+/// @brief 校正値を設定する (pedal_adc_read() と同じコアから呼ぶこと)
+void pedal_adc_set_calibration(pedal_id_t pedal,
+                               const pedal_calibration_t &calibration);
+
+#ifdef NATIVE_HOST
+/**
+ * @brief ホスト上で DMA の書込を模擬する (記録したサンプル列の再生用)
+ * @param samples ラウンドロビン順 (ADC チャネル番号順) に並んだ 12bit 値
+ */
+void pedal_adc_inject(const uint16_t *samples, uint16_t count);
+#endif
+
+#endif // PEDAL_ADC_H
@@ -0,0 +1,110 @@
+/**
+ * @file pedal_filter.h
+ * @brief ペダル ADC 値のデシメーションと校正 (固定小数点)
+ * @date 2026-10-16
+ *
+ * ADC のラウンドロビン変換結果 (チャネルが交互に並ぶリングバッファ) から
+ * チャネルごとに最新 2^k 個の 12bit サンプルを合算し (オーバーサンプリング)、
+ * 16bit の値へデシメーションする。さらに校正値と不感帯を適用して
+ * custom_gamepad_report_t の軸範囲 (-32767..32767) へ変換する。
+ *
+ * ハードウェアに依存しないため、記録したサンプル列をホスト上で与えて
+ * 検証できる (src/native_bench.cpp)。
+ */
+
+#ifndef PEDAL_FILTER_H
+#define PEDAL_FILTER_H
+
+#include <stdint.h>
+
+#define PEDAL_ADC_BITS 12       ///< ADC の分解能
+#define PEDAL_OVERSAMPLE_LOG2 4 ///< 合算するサンプル数 (2^4 = 16) -> 16bit
+#define PEDAL_RAW_MAX 65520     ///< デシメーション後の最大値 (4095 * 16)
+#define PEDAL_AXIS_MIN (-32767)
+#define PEDAL_AXIS_MAX 32767
+
+/**
+ * @brief ペダル1本の校正値 (いずれもデシメーション後の 0..65520)
+ */
+typedef struct {
+  uint16_t raw_released;      ///< 離した状態の値
+  uint16_t raw_pressed;       ///< 踏み切った状態の値 (released 未満も可)
+  uint16_t deadzone_released; ///< 離した側の不感帯 (この範囲は -32767)
+  uint16_t deadzone_pressed;  ///< 踏み切った側の不感帯 (この範囲は 32767)
+} pedal_calibration_t;
+
+/**
+ * @brief インターリーブされたリングから1チャネル分の最新サンプルを合算する
+ * @param ring サンプルのリング (チャネル 0, 1, .., channels-1 の順に並ぶ)
+ * @param ring_mask リング長 - 1 (リング長は 2 のべき乗かつ channels の倍数)
+ * @param end 次に書き込まれる位置 (これより前のサンプルが有効)
+ * @param channel 対象チャネル (リング内の並び順)
+ * @param channels チャネル数
+ * @return 最新 2^PEDAL_OVERSAMPLE_LOG2 個の合計 (0..PEDAL_RAW_MAX)
+ */
+inline uint32_t pedal_decimate(const volatile uint16_t *ring,
+                               uint16_t ring_mask, uint16_t end,
+                               uint8_t channel, uint8_t channels) {
+  // end の直前にある対象チャネルのサンプル位置
+  uint16_t last_slot = (uint16_t)((end + ring_mask) & ring_mask); // end - 1
+  uint16_t back = (uint16_t)((last_slot % channels + channels - channel) %
+                             channels);
+  uint16_t pos = (uint16_t)((last_slot - back) & ring_mask);
+  uint32_t sum = 0;
+  for (uint8_t i = 0; i < (1u << PEDAL_OVERSAMPLE_LOG2); i++) {
+    sum += ring[pos] & ((1u << PEDAL_ADC_BITS) - 1);
+    pos = (uint16_t)((pos - channels) & ring_mask);
+  }
+  return sum;
+}
+
+class PedalChannel {
+public:
+  PedalChannel() {
+    pedal_calibration_t cal = {0, PEDAL_RAW_MAX, 0, 0};
+    setCalibration(cal);
+  }
+
+  /// @brief 校正値を設定し、スケール係数を求める
+  void setCalibration(const pedal_calibration_t &cal) {
+    calibration = cal;
+    inverted = cal.raw_pressed < cal.raw_released;
+    // 踏み込み量 (離した状態が 0) に換算した有効範囲
+    uint32_t span = inverted ? cal.raw_released - cal.raw_pressed
+                             : cal.raw_pressed - cal.raw_released;
+    lower = cal.deadzone_released;
+    upper = (span > cal.deadzone_pressed) ? span - cal.deadzone_pressed : 0;
+    uint32_t range = (upper > lower) ? upper - lower : 1;
+    scale_q16 = ((uint32_t)(PEDAL_AXIS_MAX - PEDAL_AXIS_MIN) << 16) / range;
+  }
+
+  const pedal_calibration_t &getCalibration() const { return calibration; }
+
+  /**
+   * @brief デシメーション後の値を軸の値へ変換する
+   * @param raw pedal_decimate() の結果 (0..PEDAL_RAW_MAX)
+   * @return -32767 (離した状態) .. 32767 (踏み切った状態)
+   */
+  int16_t scale(uint32_t raw) const {
+    // 踏み込み量へ換算 (校正範囲外は端に制限)
+    int32_t released = (int32_t)calibration.raw_released;
+    int32_t travel = inverted ? released - (int32_t)raw
+                              : (int32_t)raw - released;
+    if (travel <= (int32_t)lower)
+      return PEDAL_AXIS_MIN;
+    if (travel >= (int32_t)upper)
+      return PEDAL_AXIS_MAX;
+    int32_t out = PEDAL_AXIS_MIN +
+                  (int32_t)(((uint64_t)(travel - lower) * scale_q16) >> 16);
+    return (int16_t)((out > PEDAL_AXIS_MAX) ? PEDAL_AXIS_MAX : out);
+  }
+
+private:
+  pedal_calibration_t calibration;
+  bool inverted;
+  uint32_t lower;     ///< 不感帯を除いた有効範囲の下端 (踏み込み量)
+  uint32_t upper;     ///< 不感帯を除いた有効範囲の上端 (踏み込み量)
+  uint32_t scale_q16; ///< 踏み込み量 -> 軸の値 の係数 (Q16)
+};
+
+#endif // PEDAL_FILTER_H
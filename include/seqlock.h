@@ -0,0 +1,99 @@
+/**
+ * @file seqlock.h
+ * @brief Core 間 (単一ライタ/単一リーダ) のロックフリー値受け渡し
+ * @date 2026-10-16
+ *
+ * RP2040 (Cortex-M0+) には LDREX/STREX が無く、アトミックな
+ * Read-Modify-Write を使えない。そのため 32bit
+ * のロード/ストアとメモリバリアのみで構成できるシーケンスロックを採用する。
+ *
+ * - ライタ: シーケンス番号を奇数にする → データ書込 → 偶数に戻す。
+ *   ライタは一切待たない (wait-free)。
+ * - リーダ: 書込中 (奇数) または読込前後で番号が変化した場合は読み直す。
+ *   再試行回数に上限を設け、上限到達時は false を返して前回値を使い続ける。
+ *   (最新値のみが意味を持つ状態共有のため、次周期で取りこぼしは解消される)
+ */
+
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <atomic>
+#include <cstdint>
+
+template <typename T> class SeqLock {
+public:
+  static constexpr uint8_t MAX_READ_RETRIES = 4; ///< 読込再試行の上限
+
+  SeqLock() : seq(0), data() {}
+
+  /**
+   * @brief 値を書き込む (ライタ側のみ呼び出し可)
+   * @param value 書き込む値
+   */
+  void write(const T &value) {
+    T *dest = beginWrite();
+    *dest = value;
+    endWrite();
+  }
+
+  /**
+   * @brief 書込区間の開始。戻り値のポインタ経由で部分更新できる
+   * @return 共有データへのポインタ (endWrite() まで有効)
+   */
+  T *beginWrite() {
+    uint32_t s = seq.load(std::memory_order_relaxed);
+    seq.store(s + 1, std::memory_order_relaxed); // 奇数: 書込中
+    std::atomic_thread_fence(std::memory_order_release);
+    return &data;
+  }
+
+  /// @brief 書込区間の終了
+  void endWrite() {
+    uint32_t s = seq.load(std::memory_order_relaxed);
+    seq.store(s + 1, std::memory_order_release); // 偶数: 書込完了
+  }
+
+  /**
+   * @brief 一貫したスナップショットを読み出す (リーダ側のみ呼び出し可)
+   * @param dest 読み出し先。失敗時は内容を保証しない
+   * @return 一貫した値を取得できた場合 true
+   */
+  bool tryRead(T &dest) const {
+    for (uint8_t retry = 0; retry < MAX_READ_RETRIES; retry++) {
+      uint32_t s;
+      const T *src = readBegin(s);
+      if (src == nullptr)
+        continue; // 書込中
+      dest = *src;
+      if (readValidate(s))
+        return true;
+    }
+    return false;
+  }
+
+  /**
+   * @brief 読込区間の開始。必要な部分だけを読み出す場合に使用する
+   * @param s 開始時のシーケンス番号 (readValidate() へ渡す)
+   * @return 書込中の場合 nullptr。読み出した値は readValidate()
+   * が true を返すまで使用してはならない
+   */
+  const T *readBegin(uint32_t &s) const {
+    s = seq.load(std::memory_order_acquire);
+    return (s & 1u) ? nullptr : &data;
+  }
+
+  /// @brief 読込区間の終了。読込中に書込が無ければ true
+  bool readValidate(uint32_t s) const {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return seq.load(std::memory_order_relaxed) == s;
+  }
+
+  /// @brief 現在のシーケンス番号 (更新有無の確認用)
+  uint32_t sequence() const { return seq.load(std::memory_order_acquire); }
+
+private:
+  std::atomic<uint32_t> seq;
+  T data;
+};
+
+#endif // SEQLOCK_H
@@ -0,0 +1,203 @@
+/**
+ * @file serial_command.h
+ * @brief シリアルコマンド (HID 入力の注入) の逐次パーサ
+ * @date 2026-10-16
+ *
+ * 1バイトずつ与える状態遷移型のパーサで、固定長バッファのみを使用する
+ * (ブロッキング・動的メモリ確保無し)。1ms 周期の中で受信済みの分だけ処理できる。
+ *
+ * 対応する形式 (どちらも同じストリームに混在可):
+ * - テキスト: "HID:S<Steer>,A<Accel>,B<Brake>,BTN<Buttons>\n"
+ * - バイナリ: 0x00 | COBS( type | custom_gamepad_report_t | crc16(LE) ) | 0x00
+ *   type = SERIAL_CMD_TYPE_HID_INPUT。CRC は cobs.h と同じ CRC-16/CCITT-FALSE。
+ *   先頭の区切りを含め1フレーム 14 バイトのため、1kHz で入力を注入できる
+ *   (PC 側: tools/python/telemetry.py の encode_hid_input())。
+ */
+
+#ifndef SERIAL_COMMAND_H
+#define SERIAL_COMMAND_H
+
+#include "cobs.h"
+#include "hidwffb.h"
+#include <stdint.h>
+#include <string.h>
+
+#define SERIAL_CMD_LINE_MAX 48         ///< テキスト1行の最大長
+#define SERIAL_CMD_TYPE_HID_INPUT 0x10 ///< バイナリ: HID 入力フレーム
+#define SERIAL_CMD_BYTES_PER_LOOP 64   ///< 1周期あたりに処理する最大バイト数
+
+/// @brief feed() の結果
+typedef enum {
+  SERIAL_CMD_NONE = 0,         ///< 受信途中 (または空行)
+  SERIAL_CMD_HID_INPUT_TEXT,   ///< テキストの HID 入力を受信 (input() で取得)
+  SERIAL_CMD_HID_INPUT_BINARY, ///< バイナリの HID 入力を受信 (input() で取得)
+  SERIAL_CMD_ERROR             ///< 書式/CRC 異常、または長さ超過で破棄
+} serial_cmd_result_t;
+
+class SerialCommandParser {
+public:
+  SerialCommandParser() : state(STATE_IDLE), len(0), errors(0), report() {}
+
+  void reset() {
+    state = STATE_IDLE;
+    len = 0;
+  }
+
+  /**
+   * @brief 受信した1バイトを処理する
+   * @return コマンドの完成/異常を示す結果
+   */
+  serial_cmd_result_t feed(uint8_t byte) {
+    switch (state) {
+    case STATE_IDLE:
+      if (byte == 0x00) {
+        state = STATE_BINARY; // バイナリフレームの開始
+        len = 0;
+      } else if (byte != '\r' && byte != '\n') {
+        state = STATE_TEXT;
+        len = 0;
+        return appendText(byte);
+      }
+      return SERIAL_CMD_NONE;
+
+    case STATE_TEXT:
+      if (byte == '\n') {
+        state = STATE_IDLE;
+        return parseText();
+      }
+      if (byte == 0x00) { // テキスト途中でバイナリが始まった場合は再同期
+        state = STATE_BINARY;
+        len = 0;
+        return fail();
+      }
+      return appendText(byte);
+
+    case STATE_BINARY:
+      if (byte == 0x00) {
+        if (len == 0)
+          return SERIAL_CMD_NONE; // 連続した区切り
+        state = STATE_IDLE;
+        return parseBinary();
+      }
+      if (len >= sizeof(buf)) {
+        state = STATE_DISCARD_BINARY;
+        return fail();
+      }
+      buf[len++] = byte;
+      return SERIAL_CMD_NONE;
+
+    case STATE_DISCARD_TEXT:
+      if (byte == '\n')
+        state = STATE_IDLE;
+      return SERIAL_CMD_NONE;
+
+    default: // STATE_DISCARD_BINARY
+      if (byte == 0x00)
+        state = STATE_IDLE;
+      return SERIAL_CMD_NONE;
+    }
+  }
+
+  /// @brief 最後に受信した HID 入力
+  const custom_gamepad_report_t &input() const { return report; }
+  /// @brief 書式/CRC 異常・長さ超過で破棄したコマンド数
+  uint32_t errorCount() const { return errors; }
+
+private:
+  enum : uint8_t {
+    STATE_IDLE = 0,
+    STATE_TEXT,
+    STATE_BINARY,
+    STATE_DISCARD_TEXT,  ///< 長すぎる行を改行まで読み捨てる
+    STATE_DISCARD_BINARY ///< 長すぎるフレームを区切りまで読み捨てる
+  };
+  // バイナリフレーム (COBS デコード後): type | report | crc16
+  static constexpr uint16_t BINARY_FRAME_LEN =
+      1 + sizeof(custom_gamepad_report_t) + 2;
+
+  serial_cmd_result_t fail() {
+    errors++;
+    return SERIAL_CMD_ERROR;
+  }
+
+  serial_cmd_result_t appendText(uint8_t byte) {
+    if (byte == '\r')
+      return SERIAL_CMD_NONE;
+    if (len >= SERIAL_CMD_LINE_MAX) {
+      state = STATE_DISCARD_TEXT;
+      return fail();
+    }
+    buf[len++] = byte;
+    return SERIAL_CMD_NONE;
+  }
+
+  /// @brief 期待する文字列と一致すれば読み進める
+  bool expect(uint16_t &pos, const char *literal) const {
+    size_t n = strlen(literal);
+    if (pos + n > len || memcmp(&buf[pos], literal, n) != 0)
+      return false;
+    pos += (uint16_t)n;
+    return true;
+  }
+
+  /// @brief 10進整数 (符号付き) を読み、[min, max] に制限する
+  bool parseInt(uint16_t &pos, int32_t min, int32_t max,
+                int32_t &value) const {
+    bool negative = false;
+    if (pos < len && (buf[pos] == '-' || buf[pos] == '+'))
+      negative = (buf[pos++] == '-');
+    uint16_t start = pos;
+    int32_t v = 0;
+    while (pos < len && buf[pos] >= '0' && buf[pos] <= '9') {
+      if (v < 1000000) // 桁あふれ防止 (範囲外は下で制限)
+        v = v * 10 + (buf[pos] - '0');
+      pos++;
+    }
+    if (pos == start)
+      return false;
+    v = negative ? -v : v;
+    value = (v < min) ? min : (v > max) ? max : v;
+    return true;
+  }
+
+  serial_cmd_result_t parseText() {
+    if (len == 0)
+      return SERIAL_CMD_NONE;
+    uint16_t pos = 0;
+    int32_t steer, accel, brake, buttons;
+    if (!expect(pos, "HID:S") || !parseInt(pos, -32767, 32767, steer) ||
+        !expect(pos, ",A") || !parseInt(pos, -32767, 32767, accel) ||
+        !expect(pos, ",B") || !parseInt(pos, -32767, 32767, brake) ||
+        !expect(pos, ",BTN") || !parseInt(pos, 0, 65535, buttons))
+      return fail();
+    while (pos < len && buf[pos] == ' ')
+      pos++;
+    if (pos != len)
+      return fail();
+
+    report.steer = (int16_t)steer;
+    report.accel = (int16_t)accel;
+    report.brake = (int16_t)brake;
+    report.buttons = (uint16_t)buttons;
+    return SERIAL_CMD_HID_INPUT_TEXT;
+  }
+
+  serial_cmd_result_t parseBinary() {
+    int16_t n = cobs_decode(buf, len, buf);
+    if (n != (int16_t)BINARY_FRAME_LEN || buf[0] != SERIAL_CMD_TYPE_HID_INPUT)
+      return fail();
+    uint16_t crc = (uint16_t)(buf[n - 2] | (buf[n - 1] << 8));
+    if (crc16_ccitt(buf, (uint16_t)(n - 2)) != crc)
+      return fail();
+    memcpy(&report, &buf[1], sizeof(custom_gamepad_report_t));
+    return SERIAL_CMD_HID_INPUT_BINARY;
+  }
+
+  uint8_t state;
+  uint16_t len;
+  uint32_t errors;
+  custom_gamepad_report_t report;
+  uint8_t buf[SERIAL_CMD_LINE_MAX]; ///< テキスト行/COBS フレーム共用
+};
+
+#endif // SERIAL_COMMAND_H
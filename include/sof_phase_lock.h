@@ -0,0 +1,113 @@
+/**
+ * @file sof_phase_lock.h
+ * @brief USB SOF (Start of Frame) への周期実行の位相同期
+ * @date 2026-10-16
+ *
+ * ホストは 1ms ごとに SOF を送り、その後の IN トークンで Input Report を
+ * 読み出す。周期実行の位相が SOF に対して自由に流れていると、送信した
+ * レポートが読み出されるまでの経過時間は 0..1 フレームの間でばらつく。
+ * 本クラスは SOF を観測した時刻と直前の周期実行の予定時刻から位相誤差を求め、
+ * 予定時刻を「SOF の lead_us 前」へ寄せる補正量を返す (比例制御)。
+ *
+ * 時刻はすべて引数で与えるため、ホスト上で仮想の SOF を与えて検証できる
+ * (src/native_bench.cpp)。補正は PeriodicTrigger_u::shiftPhase() で適用する。
+ */
+
+#ifndef SOF_PHASE_LOCK_H
+#define SOF_PHASE_LOCK_H
+
+#include <stdint.h>
+
+/// @brief 位相同期の統計
+typedef struct {
+  uint32_t sof_count;      ///< 観測した SOF 数
+  uint32_t locked_count;   ///< 同期状態で観測した SOF 数
+  int32_t phase_err_us;    ///< 最新の位相誤差 (正: 予定より遅い)
+  uint32_t phase_err_max;  ///< 同期状態での位相誤差の絶対値の最大値
+  uint32_t age_last_us;    ///< 最新の入力の経過時間 (取得から SOF まで)
+  uint32_t age_max_us;     ///< 同期状態での経過時間の最大値
+  uint64_t age_sum_us;     ///< 同期状態での経過時間の合計 (平均の算出用)
+} sof_lock_stats_t;
+
+class SofPhaseLock {
+public:
+  /**
+   * @param period_us 同期させる周期実行の周期 [us] (SOF 周期の約数)
+   * @param lead_us 周期実行を SOF の何 us 前に行うか
+   * @param gain_shift 補正のゲイン (誤差の 1/2^shift を補正)
+   * @param max_step_us 1回の補正量の上限 [us]
+   * @param lock_window_us 誤差がこの範囲内で同期状態とみなす [us]
+   */
+  SofPhaseLock(uint32_t period_us, uint32_t lead_us, uint8_t gain_shift = 2,
+               uint32_t max_step_us = 50, uint32_t lock_window_us = 20)
+      : period((period_us > 0) ? period_us : 1), lead(lead_us % period),
+        shift(gain_shift), max_step((int32_t)max_step_us),
+        window((int32_t)lock_window_us), lock_streak(0), stat() {}
+
+  /**
+   * @brief SOF を観測した時に呼ぶ
+   * @param sof_us SOF の観測時刻
+   * @param run_us SOF 直前の周期実行の予定時刻
+   * @param sample_us SOF 直前に送信した入力を取得した時刻
+   * @return 次の予定時刻へ加える補正量 [us]
+   */
+  int32_t update(uint32_t sof_us, uint32_t run_us, uint32_t sample_us) {
+    // 目標は run_us == sof_us - lead (周期を法とする)。[-P/2, P/2) へ折返す
+    int32_t err = (int32_t)(run_us + lead - sof_us) % (int32_t)period;
+    if (err >= (int32_t)(period + 1) / 2)
+      err -= (int32_t)period;
+    else if (err < -(int32_t)period / 2)
+      err += (int32_t)period;
+
+    stat.sof_count++;
+    stat.phase_err_us = err;
+    stat.age_last_us = sof_us - sample_us;
+
+    int32_t abs_err = (err < 0) ? -err : err;
+    if (abs_err <= window) {
+      if (lock_streak < LOCK_STREAK)
+        lock_streak++;
+    } else {
+      lock_streak = 0;
+    }
+    if (locked()) {
+      stat.locked_count++;
+      if ((uint32_t)abs_err > stat.phase_err_max)
+        stat.phase_err_max = (uint32_t)abs_err;
+      if (stat.age_last_us > stat.age_max_us)
+        stat.age_max_us = stat.age_last_us;
+      stat.age_sum_us += stat.age_last_us;
+    }
+
+    // 遅れている (err > 0) 場合は予定時刻を早める。小さな誤差も 1us ずつ補正
+    int32_t step = (err >= 0) ? (err + (1 << shift) - 1) >> shift
+                              : -((-err + (1 << shift) - 1) >> shift);
+    if (step > max_step)
+      step = max_step;
+    else if (step < -max_step)
+      step = -max_step;
+    return -step;
+  }
+
+  /// @brief 位相誤差が一定回数続けて lock_window_us 以内の場合 true
+  bool locked() const { return lock_streak >= LOCK_STREAK; }
+
+  /// @brief SOF が途絶えた場合などに同期状態を解除する
+  void reset() { lock_streak = 0; }
+
+  const sof_lock_stats_t &stats() const { return stat; }
+  void resetStats() { stat = sof_lock_stats_t(); }
+
+private:
+  static constexpr uint8_t LOCK_STREAK = 8; ///< 同期判定に必要な連続回数
+
+  uint32_t period;
+  uint32_t lead;
+  uint8_t shift;
+  int32_t max_step;
+  int32_t window;
+  uint8_t lock_streak;
+  sof_lock_stats_t stat;
+};
+
+#endif // SOF_PHASE_LOCK_H
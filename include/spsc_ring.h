@@ -0,0 +1,150 @@
+/**
+ * @file spsc_ring.h
+ * @brief 単一プロデューサ/単一コンシューマの固定長リングバッファ
+ * @date 2026-10-16
+ *
+ * 動的メモリ確保を行わず、32bit のロード/ストアとメモリバリアのみで構成する
+ * (Cortex-M0+ でもロックフリー)。割り込み/USB タスク → メインループ、
+ * Core 間などの一方向キューとして使用する。
+ *
+ * - 満杯時は新しい要素を破棄し、オーバーフロー回数を記録する。
+ * - 最大滞留数 (ハイウォーターマーク) を記録し、容量設計の根拠とする。
+ * - 統計値はプロデューサ側のみが更新する。
+ */
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <cstdint>
+
+template <typename T, uint16_t N> class SpscRing {
+  static_assert(N > 0 && (N & (N - 1)) == 0, "容量は 2 のべき乗とすること");
+
+public:
+  static constexpr uint16_t CAPACITY = N;
+
+  SpscRing() : head(0), tail(0), high_water(0), overflow_count(0) {}
+
+  // --- プロデューサ側 ---
+
+  /**
+   * @brief 書込先スロットを確保する (コピー無しで直接書き込む場合に使用)
+   * @return 空きスロット。満杯の場合 nullptr (オーバーフローを記録)
+   */
+  T *acquireWrite() {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) >= N) {
+      overflow_count.store(overflow_count.load(std::memory_order_relaxed) + 1,
+                           std::memory_order_relaxed);
+      return nullptr;
+    }
+    return &buf[h & (N - 1)];
+  }
+
+  /// @brief acquireWrite() で確保したスロットを公開する
+  void commitWrite() {
+    uint32_t h = head.load(std::memory_order_relaxed) + 1;
+    head.store(h, std::memory_order_release);
+    uint16_t depth = (uint16_t)(h - tail.load(std::memory_order_relaxed));
+    if (depth > high_water.load(std::memory_order_relaxed))
+      high_water.store(depth, std::memory_order_relaxed);
+  }
+
+  /// @brief 要素を追加する。満杯の場合 false
+  bool push(const T &value) {
+    T *slot = acquireWrite();
+    if (slot == nullptr)
+      return false;
+    *slot = value;
+    commitWrite();
+    return true;
+  }
+
+  /**
+   * @brief count 個の要素をまとめて追加する (全て入らない場合は何もしない)
+   * 一部だけを追加しないため、呼出し側は同じ内容を後で再送できる
+   * @return 追加した場合 true (満杯の場合はオーバーフローを記録)
+   */
+  bool pushBulk(const T *values, uint16_t count) {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    if (count > N - (h - tail.load(std::memory_order_acquire))) {
+      overflow_count.store(overflow_count.load(std::memory_order_relaxed) + 1,
+                           std::memory_order_relaxed);
+      return false;
+    }
+    for (uint16_t i = 0; i < count; i++)
+      buf[(h + i) & (N - 1)] = values[i];
+    h += count;
+    head.store(h, std::memory_order_release);
+    uint16_t depth = (uint16_t)(h - tail.load(std::memory_order_relaxed));
+    if (depth > high_water.load(std::memory_order_relaxed))
+      high_water.store(depth, std::memory_order_relaxed);
+    return true;
+  }
+
+  /// @brief 次に書き込む位置 (下位 16bit, discardUntil() に渡す)
+  uint16_t writePosition() const {
+    return (uint16_t)head.load(std::memory_order_relaxed);
+  }
+
+  // --- コンシューマ側 ---
+
+  /// @brief 先頭要素を参照する (コピー無し)。空の場合 nullptr
+  const T *front() const {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    if (t == head.load(std::memory_order_acquire))
+      return nullptr;
+    return &buf[t & (N - 1)];
+  }
+
+  /// @brief front() で参照した先頭要素を解放する
+  void popFront() {
+    tail.store(tail.load(std::memory_order_relaxed) + 1,
+               std::memory_order_release);
+  }
+
+  /// @brief 先頭要素を取り出す。空の場合 false
+  bool pop(T &dest) {
+    const T *src = front();
+    if (src == nullptr)
+      return false;
+    dest = *src;
+    popFront();
+    return true;
+  }
+
+  /**
+   * @brief writePosition() で得た位置より前の要素を捨てる
+   * 位置が読込位置より前 (既に読んだ) の場合は何もしない
+   */
+  void discardUntil(uint16_t position) {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    uint32_t h = head.load(std::memory_order_acquire);
+    uint16_t skip = (uint16_t)(position - (uint16_t)t);
+    if (skip <= (uint16_t)(h - t))
+      tail.store(t + skip, std::memory_order_release);
+  }
+
+  // --- 状態・統計 (どちらの側からも参照可) ---
+
+  uint16_t size() const {
+    return (uint16_t)(head.load(std::memory_order_acquire) -
+                      tail.load(std::memory_order_acquire));
+  }
+  uint16_t highWater() const {
+    return high_water.load(std::memory_order_relaxed);
+  }
+  uint32_t overflowCount() const {
+    return overflow_count.load(std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<uint32_t> head; ///< 書込位置 (プロデューサのみ更新)
+  std::atomic<uint32_t> tail; ///< 読込位置 (コンシューマのみ更新)
+  std::atomic<uint16_t> high_water;
+  std::atomic<uint32_t> overflow_count;
+  T buf[N];
+};
+
+#endif // SPSC_RING_H
@@ -0,0 +1,165 @@
+/**
+ * @file steer_sensor.h
+ * @brief 操舵軸センサ (アブソリュートエンコーダ) の抽象化と多回転の展開
+ * @date 2026-10-16
+ *
+ * センサの取得はパイプライン化する。Core1 は周期ごとに
+ *   1. poll()      : 前周期に開始した転送の結果 (1回転内の角度) を取り出す
+ *   2. startRead() : 次の転送を開始する (DMA 等で Core1 の処理と並行に進む)
+ *   3. 取り出した角度を EncoderUnwrapper で 32bit 位置へ展開し、
+ *      SteerMapper で steer へ変換する
+ * の順に処理する。実機の実装は steer_sensor_spi.h、ホスト用には
+ * 記録したトレースを再生する TraceSteerSensor を用意する。
+ */
+
+#ifndef STEER_SENSOR_H
+#define STEER_SENSOR_H
+
+#include <stdint.h>
+
+/**
+ * @brief 操舵軸センサのインターフェース
+ */
+class SteerSensor {
+public:
+  virtual ~SteerSensor() {}
+  /// @brief センサを初期化する (Core1 の setup1() で呼ぶ)
+  virtual bool begin() = 0;
+  /// @brief 次の取得を開始する (完了を待たない)
+  virtual void startRead() = 0;
+  /**
+   * @brief 前回 startRead() で開始した取得の結果を取り出す
+   * @param angle 1回転内の角度 (0 .. 2^resolutionBits() - 1)
+   * @return 取得中、通信異常、センサ異常の場合 false
+   */
+  virtual bool poll(uint16_t *angle) = 0;
+  /// @brief 1回転あたりの分解能 [bit]
+  virtual uint8_t resolutionBits() const = 0;
+};
+
+/**
+ * @brief 1回転内の角度を 32bit の多回転位置へ展開する
+ *
+ * 前回値との差分を分解能のビット幅で符号拡張して積算する。
+ * 取得周期の間に半回転以上動かない限り正しく展開できる。
+ */
+class EncoderUnwrapper {
+public:
+  explicit EncoderUnwrapper(uint8_t resolution_bits)
+      : shift((uint8_t)(32 - resolution_bits)), prev(0), pos(0),
+        primed(false) {}
+
+  /// @brief 角度を与え、展開した位置を返す (初回は角度そのもの)
+  int32_t update(uint16_t angle) {
+    if (!primed) {
+      pos = angle;
+      primed = true;
+    } else {
+      // 分解能のビット幅で差分を符号拡張する ([-半回転, 半回転) に折返す)
+      int32_t delta = (int32_t)((uint32_t)(angle - prev) << shift) >> shift;
+      pos += delta;
+    }
+    prev = angle;
+    return pos;
+  }
+
+  int32_t position() const { return pos; }
+  /// @brief 次の update() で現在の角度から展開し直す
+  void reset() { primed = false; }
+
+private:
+  uint8_t shift;
+  uint16_t prev;
+  int32_t pos;
+  bool primed;
+};
+
+/**
+ * @brief 多回転位置を steer (-32767..32767) へ変換する
+ *
+ * ロック間 (lock-to-lock) の回転角を -32767..32767 に割り当て、
+ * 範囲外は端に制限する。
+ */
+class SteerMapper {
+public:
+  /**
+   * @param counts_per_rev 1回転あたりのカウント数 (2^分解能)
+   * @param lock_to_lock_deg ロック間の回転角 [deg] (例: 900)
+   */
+  SteerMapper(uint32_t counts_per_rev, uint16_t lock_to_lock_deg)
+      : cpr(counts_per_rev), center(0) {
+    setLockToLock(lock_to_lock_deg);
+  }
+
+  void setLockToLock(uint16_t lock_to_lock_deg) {
+    lock_deg = (lock_to_lock_deg > 0) ? lock_to_lock_deg : 1;
+    // 中心から片側ロックまでのカウント数
+    half_range = (uint32_t)(((uint64_t)cpr * lock_deg) / 720);
+    if (half_range == 0)
+      half_range = 1;
+    scale_q16 = ((uint64_t)32767 << 16) / half_range;
+  }
+  uint16_t getLockToLock() const { return lock_deg; }
+
+  /// @brief 中心 (steer = 0) とする位置を設定する
+  void setCenter(int32_t position) { center = position; }
+  int32_t getCenter() const { return center; }
+
+  int16_t map(int32_t position) const {
+    int32_t offset = position - center;
+    if (offset >= (int32_t)half_range)
+      return 32767;
+    if (offset <= -(int32_t)half_range)
+      return -32767;
+    int64_t v = ((int64_t)offset * (int64_t)scale_q16) >> 16;
+    return (int16_t)v;
+  }
+
+private:
+  uint32_t cpr;
+  int32_t center;
+  uint16_t lock_deg;
+  uint32_t half_range; ///< 中心から片側ロックまでのカウント数
+  uint64_t scale_q16;  ///< カウント -> steer の係数 (Q16)
+};
+
+#ifdef NATIVE_HOST
+/**
+ * @brief 記録したエンコーダのトレースを再生するセンサ (ホスト用)
+ *
+ * startRead() した時点のサンプルを次の poll() で返す (実機と同じ1周期遅れ)。
+ * トレースの末尾に達すると先頭へ戻る。
+ */
+class TraceSteerSensor : public SteerSensor {
+public:
+  TraceSteerSensor(const uint16_t *trace, uint32_t length,
+                   uint8_t resolution_bits)
+      : samples(trace), len(length), bits(resolution_bits), next(0),
+        pending(false), latched(0) {}
+
+  bool begin() override { return samples != nullptr && len > 0; }
+  void startRead() override {
+    latched = samples[next];
+    next = (next + 1 < len) ? next + 1 : 0;
+    pending = true;
+  }
+  bool poll(uint16_t *angle) override {
+    if (!pending)
+      return false;
+    *angle = latched;
+    pending = false;
+    return true;
+  }
+  uint8_t resolutionBits() const override { return bits; }
+
+private:
+  const uint16_t *samples;
+  uint32_t len;
+  uint8_t bits;
+  uint32_t next;
+  bool pending;
+  uint16_t latched;
+};
+#endif
+
+#endif // STEER_SENSOR_H
@@ -0,0 +1,61 @@
+/**
+ * @file steer_sensor_spi.h
+ * @brief SPI 接続の操舵軸エンコーダ (AS5047P 互換, 14bit) の DMA 取得
+ * @date 2026-10-16
+ *
+ * 16bit の SPI フレーム1つで ANGLECOM の読出しコマンドを送り、同時に
+ * 前のフレームで要求した角度を受け取る (センサ側もパイプライン動作)。
+ * 転送は DMA で行い、startRead() は CS を下げて送受信の DMA を起動するだけ、
+ * poll() は受信 DMA の完了を確認して CS を上げるだけのため、
+ * Core1 は転送の完了を待たない。
+ *
+ * 受信データはパリティ (bit15, 偶数) とエラーフラグ (bit14) を検査し、
+ * 異常時は poll() が false を返す (errorCount() で件数を取得)。
+ */
+
+#ifndef STEER_SENSOR_SPI_H
+#define STEER_SENSOR_SPI_H
+
+#include "steer_sensor.h"
+#include <stdint.h>
+
+#define STEER_SPI_BAUD_HZ 4000000 ///< SPI クロック (AS5047P は最大 10MHz)
+#define STEER_SPI_BITS 14         ///< 1回転あたりの分解能
+
+class SpiSteerSensor : public SteerSensor {
+public:
+  /**
+   * @param cs_pin CS ピン (GPIO として制御する)
+   * @param sck_pin SCK ピン (SPI0)
+   * @param tx_pin TX (MOSI) ピン (SPI0)
+   * @param rx_pin RX (MISO) ピン (SPI0)
+   */
+  SpiSteerSensor(uint8_t cs_pin, uint8_t sck_pin, uint8_t tx_pin,
+                 uint8_t rx_pin)
+      : cs(cs_pin), sck(sck_pin), tx(tx_pin), rx(rx_pin), tx_chan(-1),
+        rx_chan(-1), busy(false), discard(true), tx_word(0), rx_word(0),
+        errors(0) {}
+
+  bool begin() override;
+  void startRead() override;
+  bool poll(uint16_t *angle) override;
+  uint8_t resolutionBits() const override { return STEER_SPI_BITS; }
+
+  /// @brief パリティ異常/センサのエラーフラグで破棄した数
+  uint32_t errorCount() const { return errors; }
+
+private:
+  uint8_t cs;
+  uint8_t sck;
+  uint8_t tx;
+  uint8_t rx;
+  int tx_chan;  ///< tx_word -> SPI の DMA チャネル
+  int rx_chan;  ///< SPI -> rx_word の DMA チャネル
+  bool busy;    ///< 転送中 (CS を下げている)
+  bool discard; ///< 初回の応答 (要求前の内容) を破棄する
+  uint16_t tx_word;
+  volatile uint16_t rx_word;
+  uint32_t errors;
+};
+
+#endif // STEER_SENSOR_SPI_H
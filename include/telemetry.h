@@ -0,0 +1,132 @@
+/**
+ * @file telemetry.h
+ * @brief デバッグ情報のバイナリ送信 (ノンブロッキング)
+ * @date 2026-10-16
+ *
+ * 各コアは記録を自コア専用のリングバッファ (SpscRing) へ積むだけで、
+ * シリアルへは一切書き込まない。Core0 ループが telemetry_drain() で
+ * CDC の送信バッファに空きがある分だけフレーム化して送信する。
+ * そのため、デバッグビルドでも 1ms 周期の処理時間はリリースビルドと変わらない。
+ *
+ * フレーム形式 (PC 側のデコーダ: tools/python/telemetry.py):
+ *   COBS( type | core | seq | payload[0..TLM_MAX_PAYLOAD] | crc16(LE) ) | 0x00
+ * - crc16: CRC-16/CCITT-FALSE (多項式 0x1021, 初期値 0xFFFF)。
+ *   対象は type から payload の末尾まで。
+ * - seq: コアごとの通し番号。リング満杯で破棄した記録は番号の欠落として
+ *   PC 側で検出できる。
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+
+#define TLM_MAX_PAYLOAD 24 ///< 1記録のペイロード最大長
+#define TLM_RING_DEPTH 16  ///< コアごとのリング段数 (2 のべき乗)
+
+/// @brief 記録を積むコア (リングバッファの選択)
+typedef enum { TLM_CORE0 = 0, TLM_CORE1 = 1, TLM_CORE_COUNT } tlm_core_t;
+
+// --- 記録の種類 (フレームの type) ---
+#define TLM_TYPE_TEXT 0x01        ///< 文字列 (終端無し)
+#define TLM_TYPE_PID_DEBUG 0x02   ///< tlm_pid_debug_t
+#define TLM_TYPE_CORE1_DEBUG 0x03 ///< tlm_core1_debug_t
+#define TLM_TYPE_LATENCY 0x04     ///< tlm_latency_t
+#define TLM_TYPE_SCHED 0x05       ///< tlm_sched_t
+#define TLM_TYPE_SOF_LOCK 0x06    ///< tlm_sof_lock_t
+#define TLM_TYPE_MIXER 0x07       ///< tlm_mixer_t
+
+// --- ペイロード (リトルエンディアン, PC 側で同じ形式を定義すること) ---
+typedef struct {
+  uint8_t reportId;
+  uint8_t isConstantForce;
+  int16_t magnitude;
+  uint8_t deviceGain;
+  uint8_t operation;
+  uint8_t effectBlockIndex;
+} __attribute__((packed)) tlm_pid_debug_t;
+
+typedef struct {
+  int16_t magnitude;
+  uint8_t coolBack;
+} __attribute__((packed)) tlm_core1_debug_t;
+
+typedef struct {
+  uint8_t probe; ///< latency_probe_t
+  uint32_t count;
+  uint32_t max_us;
+  uint32_t p50_us;
+  uint32_t p99_us;
+  uint32_t over_budget;
+} __attribute__((packed)) tlm_latency_t;
+
+static_assert(sizeof(tlm_latency_t) <= TLM_MAX_PAYLOAD,
+              "tlm_latency_t がペイロード最大長を超えています");
+
+typedef struct {
+  uint16_t period_us;
+  uint32_t runs;
+  uint32_t overruns;
+  uint32_t skipped;
+  uint32_t late_max_us;
+  uint32_t late_mean_us;
+} __attribute__((packed)) tlm_sched_t;
+
+static_assert(sizeof(tlm_sched_t) <= TLM_MAX_PAYLOAD,
+              "tlm_sched_t がペイロード最大長を超えています");
+
+typedef struct {
+  uint8_t locked;
+  int16_t phase_err_us;
+  uint16_t phase_err_max;
+  uint32_t sof_count;
+  uint32_t locked_count;
+  uint16_t age_mean_us;
+  uint16_t age_max_us;
+} __attribute__((packed)) tlm_sof_lock_t;
+
+static_assert(sizeof(tlm_sof_lock_t) <= TLM_MAX_PAYLOAD,
+              "tlm_sof_lock_t がペイロード最大長を超えています");
+
+typedef struct {
+  uint32_t ticks;
+  uint32_t overflow;
+  uint32_t soft_clipped;
+  uint32_t clipped;
+  uint32_t slew_limited;
+  uint16_t peak; ///< 65535 で飽和
+  int16_t torque;
+} __attribute__((packed)) tlm_mixer_t;
+
+static_assert(sizeof(tlm_mixer_t) <= TLM_MAX_PAYLOAD,
+              "tlm_mixer_t がペイロード最大長を超えています");
+
+/// @brief 送信統計 (コアごと)
+typedef struct {
+  uint16_t high_water;  ///< リングの最大滞留数
+  uint32_t dropped;     ///< リング満杯で破棄した記録数
+  uint32_t frames_sent; ///< 送信したフレーム数 (Core0 が更新)
+} tlm_stats_t;
+
+/**
+ * @brief 記録をリングへ積む (各コアは自コアの core のみ指定可)
+ * @param len ペイロード長。TLM_MAX_PAYLOAD を超える分は切り捨てる
+ * @return リング満杯で破棄した場合 false
+ */
+bool telemetry_emit(tlm_core_t core, uint8_t type, const void *payload,
+                    uint8_t len);
+
+/// @brief 文字列の記録を積む (TLM_MAX_PAYLOAD 文字まで)
+bool telemetry_text(tlm_core_t core, const char *text);
+
+/**
+ * @brief 溜まった記録をフレーム化してシリアルへ送信する (Core0 ループ用)
+ * 送信バッファの空きが1フレームに満たない場合は待たずに戻る
+ * @param max_frames 1回の呼び出しで送信する最大フレーム数
+ * @return 送信したフレーム数
+ */
+uint16_t telemetry_drain(uint16_t max_frames);
+
+void telemetry_get_stats(tlm_core_t core, tlm_stats_t *stats);
+
+#endif // TELEMETRY_H
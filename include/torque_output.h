@@ -0,0 +1,74 @@
+/**
+ * @file torque_output.h
+ * @brief トルク指令値の出力先 (モータドライバ等) の抽象化
+ * @date 2026-10-16
+ *
+ * FfbMixer は合算・制限後のトルク指令値をこのインターフェースへ書き込む。
+ * 実機の実装は torque_output_pwm.h (PWM + 方向ピン)、ホスト用には
+ * 書き込まれた値を記録する CaptureTorqueOutput を用意する。
+ */
+
+#ifndef TORQUE_OUTPUT_H
+#define TORQUE_OUTPUT_H
+
+#include <stdint.h>
+
+/**
+ * @brief トルク出力のインターフェース
+ */
+class TorqueOutput {
+public:
+  virtual ~TorqueOutput() {}
+  /// @brief 出力を初期化し、トルク 0 の状態にする (Core1 の setup1() で呼ぶ)
+  virtual bool begin() = 0;
+  /**
+   * @brief トルク指令値を出力する (Core1 の周期ごとに呼ぶ)
+   * @param torque -32767..32767 (正: steer の正方向へ回す向き)
+   */
+  virtual void write(int16_t torque) = 0;
+};
+
+#ifdef NATIVE_HOST
+/**
+ * @brief 書き込まれたトルク指令値を記録する出力 (ホスト用)
+ *
+ * 記録領域が一杯になった後の書込は記録せず、件数のみ数える。
+ */
+class CaptureTorqueOutput : public TorqueOutput {
+public:
+  CaptureTorqueOutput(int16_t *buffer, uint32_t capacity)
+      : samples(buffer), cap(capacity), len(0), total(0), last(0) {}
+
+  bool begin() override {
+    clear();
+    return samples != nullptr;
+  }
+  void write(int16_t torque) override {
+    if (len < cap)
+      samples[len++] = torque;
+    total++;
+    last = torque;
+  }
+
+  void clear() {
+    len = 0;
+    total = 0;
+    last = 0;
+  }
+  const int16_t *data() const { return samples; }
+  /// @brief 記録した数
+  uint32_t size() const { return len; }
+  /// @brief 書込の総数 (記録できなかった分を含む)
+  uint32_t writes() const { return total; }
+  int16_t lastValue() const { return last; }
+
+private:
+  int16_t *samples;
+  uint32_t cap;
+  uint32_t len;
+  uint32_t total;
+  int16_t last;
+};
+#endif
+
+#endif // TORQUE_OUTPUT_H
@@ -0,0 +1,42 @@
+/**
+ * @file torque_output_pwm.h
+ * @brief PWM + 方向ピンによるトルク出力 (符号/絶対値方式のモータドライバ用)
+ * @date 2026-10-16
+ *
+ * トルク指令値の絶対値を PWM のデューティ比、符号を方向ピンで出力する。
+ * PWM の周波数は可聴域外の 20kHz とし、分解能 (wrap) は begin() で
+ * システムクロックから求める。write() は比較値を書き換えるだけで、
+ * 新しいデューティ比は PWM の次の周期の先頭から反映される。
+ */
+
+#ifndef TORQUE_OUTPUT_PWM_H
+#define TORQUE_OUTPUT_PWM_H
+
+#include "torque_output.h"
+#include <stdint.h>
+
+#define TORQUE_PWM_FREQ_HZ 20000 ///< PWM 周波数
+
+class PwmTorqueOutput : public TorqueOutput {
+public:
+  /**
+   * @param pwm_pin PWM 出力ピン (デューティ比 = |トルク|)
+   * @param dir_pin 方向ピン (High: 正方向)
+   */
+  PwmTorqueOutput(uint8_t pwm_pin, uint8_t dir_pin)
+      : pwm(pwm_pin), dir(dir_pin), wrap(0), started(false) {}
+
+  bool begin() override;
+  void write(int16_t torque) override;
+
+  /// @brief PWM の最大比較値 (デューティ比 100% に相当)
+  uint16_t pwmWrap() const { return wrap; }
+
+private:
+  uint8_t pwm;
+  uint8_t dir;
+  uint16_t wrap;
+  bool started;
+};
+
+#endif // TORQUE_OUTPUT_PWM_H
@@ -0,0 +1,107 @@
+/**
+ * @file triple_buffer.h
+ * @brief Core 間 (単一ライタ/単一リーダ) の最新値受け渡し (トリプルバッファ)
+ * @date 2026-10-17
+ *
+ * RP2040 (Cortex-M0+) には LDREX/STREX が無いため、バッファの交換を
+ * アトミックな交換命令ではなく、各側が自分だけで書き込む 2 つの変数で行う。
+ *
+ * - ライタ: 最新 (published) とリーダの使用中 (reading) 以外のバッファへ
+ *   書き込み、published を更新して公開する。ライタは一切待たない。
+ * - リーダ: published のバッファを reading に登録し、その間に公開が無ければ
+ *   そのバッファを直接参照する。ライタは登録済みのバッファへ書き込まない
+ *   ため、読込は失敗せず、値が破損することもない。
+ *   登録と確認の間 (数命令) に公開があった場合のみ、新しいバッファで登録し
+ *   直す。続けて登録し直すにはライタが次のバッファを書き終える必要があり、
+ *   ライタの公開が 1 周期に 1 回であれば登録し直しは高々 1 回である。
+ *
+ * ライタのバッファは 2 回前以前に公開した内容を保持している。部分的に
+ * 更新する場合、ライタは前回の公開以降の変更だけでなく、そのバッファが
+ * 最後に公開された後の変更も書き込むこと (世代番号の比較等で判断する)。
+ */
+
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+template <typename T> class TripleBuffer {
+public:
+  TripleBuffer() : published(0), reading(0), writing(1), retries(0), buf() {}
+
+  // --- ライタ側 ---
+
+  /**
+   * @brief 書込先のバッファを取得する (endWrite() で公開するまで有効)
+   * 内容は以前に公開した値のまま (全体を上書きしない場合は注意)
+   */
+  T *beginWrite() {
+    uint8_t latest = (uint8_t)(published.load(std::memory_order_relaxed) & 3u);
+    uint8_t held = reading.load(std::memory_order_seq_cst);
+    // 3 つのうち、最新でもリーダの使用中でもないもの
+    uint8_t w = 0;
+    while (w == latest || w == held)
+      w++;
+    writing = w;
+    return &buf[w];
+  }
+
+  /// @brief beginWrite() で取得したバッファを公開する
+  void endWrite() {
+    uint32_t count = (published.load(std::memory_order_relaxed) >> 2) + 1;
+    published.store((count << 2) | writing, std::memory_order_seq_cst);
+  }
+
+  /// @brief 値全体を書き込んで公開する
+  void write(const T &value) {
+    *beginWrite() = value;
+    endWrite();
+  }
+
+  // --- リーダ側 ---
+
+  /**
+   * @brief 最新の値を参照する (失敗しない)
+   * @param seq 参照する値の公開回数 (sequence() と比較する。不要なら nullptr)
+   * @return 次に read() を呼ぶまで有効なポインタ
+   */
+  const T *read(uint32_t *seq = nullptr) {
+    uint32_t p = published.load(std::memory_order_seq_cst);
+    for (;;) {
+      reading.store((uint8_t)(p & 3u), std::memory_order_seq_cst);
+      uint32_t check = published.load(std::memory_order_seq_cst);
+      if (check == p) {
+        if (seq != nullptr)
+          *seq = p >> 2;
+        return &buf[p & 3u];
+      }
+      p = check; // 登録の間に公開された: 新しいバッファで登録し直す
+      retries.store(retries.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_relaxed);
+    }
+  }
+
+  /// @brief 最新の値をコピーする
+  void read(T &dest) { dest = *read(); }
+
+  // --- 状態 (どちらの側からも参照可) ---
+
+  /// @brief 公開した回数 (更新有無の確認用)
+  uint32_t sequence() const {
+    return published.load(std::memory_order_acquire) >> 2;
+  }
+  /// @brief リーダが登録し直した回数 (起動後の累計)
+  uint32_t readRetries() const {
+    return retries.load(std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<uint32_t> published; ///< 公開回数 << 2 | バッファ (ライタのみ)
+  std::atomic<uint8_t> reading;    ///< 使用中のバッファ (リーダのみ更新)
+  uint8_t writing;                 ///< 書込中のバッファ (ライタのみ参照)
+  std::atomic<uint32_t> retries;   ///< リーダのみ更新
+  T buf[3];
+};
+
+#endif // TRIPLE_BUFFER_H
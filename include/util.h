@@ -98,6 +98,96 @@ private:
   bool running;
 };
 
+/// @brief PeriodicTrigger_u の周期超過 (オーバーラン) 時の動作
+typedef enum {
+  SCHED_SKIP = 0, ///< 超過した周期は実行せず、次の周期境界へ揃える
+  SCHED_CATCH_UP  ///< 超過した周期を続けて実行する (最大 catch_up_max 回)
+} sched_policy_t;
+
+/// @brief PeriodicTrigger_u の実行統計 (遅れ = 実行時刻 - 予定時刻)
+typedef struct {
+  uint32_t runs;        ///< 実行回数
+  uint32_t overruns;    ///< 1周期以上遅れて実行した回数
+  uint32_t skipped;     ///< 実行しなかった周期数
+  uint32_t late_max_us; ///< 遅れの最大値
+  uint64_t late_sum_us; ///< 遅れの合計 (平均の算出用)
+} sched_stats_t;
+
+/**
+ * 周期実行の判定 マイクロ秒版 (遅れの統計・オーバーラン時の動作指定付き)
+ *
+ * 予定時刻は周期の整数倍で進めるため、判定の遅れが累積しない。
+ * 判定が1周期以上遅れた場合 (オーバーラン) の動作は policy で指定する。
+ * - SCHED_SKIP: 遅れた分の周期を破棄し、次の周期境界で再開する。
+ *   最新の状態のみが意味を持つ処理 (HID 送信、トルク出力) 向け。
+ * - SCHED_CATCH_UP: 遅れた分を続けて実行し、実行回数を時間と一致させる。
+ *   ただし連続実行は catch_up_max 回までとし、それ以上は破棄する。
+ * @param PeriodicTrigger_u 実行周期（マイクロ秒）
+ */
+class PeriodicTrigger_u {
+public:
+  PeriodicTrigger_u(uint32_t period_us,
+                    sched_policy_t overrun_policy = SCHED_SKIP,
+                    uint8_t max_catch_up = 4)
+      : period(period_us > 0 ? period_us : 1), policy(overrun_policy),
+        catch_up_max(max_catch_up), running(false), stat() {}
+
+  void init() { // 周期判定を開始する (初回は1周期後)
+    next = micros() + period;
+    running = true;
+  }
+
+  bool hasExpired() { // 周期判定を行う
+    if (!running)
+      return false;
+    uint32_t late = micros() - next;
+    if ((int32_t)late < 0)
+      return false;
+
+    stat.runs++;
+    stat.late_sum_us += late;
+    if (late > stat.late_max_us)
+      stat.late_max_us = late;
+    if (late >= period) {
+      stat.overruns++;
+      uint32_t missed = late / period; // 実行されなかった周期数
+      uint32_t skip = missed;
+      if (policy == SCHED_CATCH_UP)
+        skip = (missed > catch_up_max) ? missed - catch_up_max : 0;
+      stat.skipped += skip;
+      next += skip * period;
+    }
+    next += period;
+    return true;
+  }
+
+  /// @brief 次の予定時刻までの時間 [us] (既に過ぎている場合 0)
+  uint32_t untilNext_us() const {
+    int32_t remain = (int32_t)(next - micros());
+    return (remain > 0) ? (uint32_t)remain : 0;
+  }
+
+  /// @brief 次の予定時刻をずらす (正: 遅らせる)。位相同期の補正に使用する
+  void shiftPhase(int32_t delta_us) { next += (uint32_t)delta_us; }
+  /// @brief 直前の実行の予定時刻
+  uint32_t lastDeadline() const { return next - period; }
+
+  /// @brief 周期を変更する (次の予定時刻から適用)
+  void setPeriod(uint32_t period_us) { period = period_us > 0 ? period_us : 1; }
+  uint32_t getPeriod() const { return period; }
+
+  const sched_stats_t &stats() const { return stat; }
+  void resetStats() { stat = sched_stats_t(); }
+
+private:
+  uint32_t period;
+  sched_policy_t policy;
+  uint8_t catch_up_max;
+  uint32_t next; ///< 次の予定時刻
+  bool running;
+  sched_stats_t stat;
+};
+
 /**
  * 非ブロッキング・ワンショット判定 マイクロ秒版 クラス版
  * @param OneShotTrigger_u 実行遅延（マイクロ秒）
@@ -0,0 +1,68 @@
+/**
+ * @file Adafruit_TinyUSB.h
+ * @brief ホスト (native) ビルド用 Adafruit TinyUSB の最小代替
+ *
+ * USB 通信は行わない。Output Report の受信は native_shim_inject_report()
+ * で登録済みコールバックを直接呼び出して模擬し、送信した Input Report は
+ * native_shim_last_input_report() で参照できる。複数のインタフェースから
+ * 続けて送る場合は native_shim_set_input_hook() で送信ごとに受け取る。
+ */
+
+#ifndef NATIVE_SHIM_ADAFRUIT_TINYUSB_H
+#define NATIVE_SHIM_ADAFRUIT_TINYUSB_H
+
+#include <Arduino.h>
+
+typedef enum {
+  HID_REPORT_TYPE_INVALID = 0,
+  HID_REPORT_TYPE_INPUT,
+  HID_REPORT_TYPE_OUTPUT,
+  HID_REPORT_TYPE_FEATURE
+} hid_report_type_t;
+
+class Adafruit_USBD_HID {
+public:
+  typedef uint16_t (*get_report_callback_t)(uint8_t report_id,
+                                            hid_report_type_t report_type,
+                                            uint8_t *buffer, uint16_t reqlen);
+  typedef void (*set_report_callback_t)(uint8_t report_id,
+                                        hid_report_type_t report_type,
+                                        uint8_t const *buffer,
+                                        uint16_t bufsize);
+
+  void setPollInterval(uint8_t interval_ms) { (void)interval_ms; }
+  void setReportDescriptor(uint8_t const *desc, uint16_t len) {
+    (void)desc;
+    (void)len;
+  }
+  void setReportCallback(get_report_callback_t get_cb,
+                         set_report_callback_t set_cb);
+  bool begin(void) { return true; }
+  bool ready(void) { return true; }
+  bool sendReport(uint8_t report_id, void const *report, uint8_t len);
+};
+
+class NativeTinyUSBDevice {
+public:
+  bool mounted(void) { return true; }
+  bool suspended(void) { return false; }
+};
+
+extern NativeTinyUSBDevice TinyUSBDevice;
+
+// SOF コールバックは呼ばれない (SOF の模擬は SofPhaseLock へ直接時刻を与える)
+inline void tud_sof_cb_enable(bool en) { (void)en; }
+
+// --- ホスト側テスト/ベンチマーク用フック ---
+void native_shim_inject_report(uint8_t report_id, hid_report_type_t type,
+                               uint8_t const *buffer, uint16_t bufsize);
+uint16_t native_shim_get_report(uint8_t report_id, hid_report_type_t type,
+                                uint8_t *buffer, uint16_t reqlen);
+uint16_t native_shim_last_input_report(uint8_t *report_id, uint8_t *buffer,
+                                       uint16_t buflen);
+/// @brief Input Report の送信ごとに呼ぶ関数 (nullptr で解除)
+typedef void (*native_shim_input_hook_t)(uint8_t report_id,
+                                         uint8_t const *report, uint16_t len);
+void native_shim_set_input_hook(native_shim_input_hook_t hook);
+
+#endif // NATIVE_SHIM_ADAFRUIT_TINYUSB_H
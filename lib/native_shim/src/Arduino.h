@@ -0,0 +1,75 @@
+/**
+ * @file Arduino.h
+ * @brief ホスト (native) ビルド用 Arduino API の最小代替
+ *
+ * hidwffb / util.h をボード無しで Linux 上でビルド・計測するためのもの。
+ * 実機ビルドでは使用しない (platformio.ini の lib_ignore で除外)。
+ */
+
+#ifndef NATIVE_SHIM_ARDUINO_H
+#define NATIVE_SHIM_ARDUINO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+// --- 時間 ---
+uint32_t micros(void);
+uint32_t millis(void);
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+// --- GPIO (何もしない) ---
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+#define LOW 0x0
+#define HIGH 0x1
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t) { return HIGH; }
+
+/**
+ * @brief Serial の代替。文字列出力は標準出力へ、入力は常に空
+ * バイナリ出力 (write) はベンチマーク出力を乱さないよう破棄し、バイト数と
+ * 最後の1回分 (先頭 last_write のサイズまで) のみ残す
+ */
+class NativeSerial {
+public:
+  void begin(unsigned long) {}
+  int available(void) { return 0; }
+  int read(void) { return -1; }
+  int availableForWrite(void) { return 256; }
+  size_t write(const uint8_t *buf, size_t len) {
+    bytes_written += len;
+    last_write_len = (len < sizeof(last_write)) ? len : sizeof(last_write);
+    memcpy(last_write, buf, last_write_len);
+    return len;
+  }
+
+  size_t print(const char *s) { return (size_t)printf("%s", s); }
+  size_t print(char c) { return (size_t)printf("%c", c); }
+  size_t print(int v) { return (size_t)printf("%d", v); }
+  size_t print(unsigned int v) { return (size_t)printf("%u", v); }
+  size_t print(long v) { return (size_t)printf("%ld", v); }
+  size_t print(unsigned long v) { return (size_t)printf("%lu", v); }
+  size_t print(double v) { return (size_t)printf("%.2f", v); }
+  size_t println(void) { return print("\n"); }
+  template <typename T> size_t println(T v) {
+    size_t n = print(v);
+    return n + println();
+  }
+  template <typename... Args> size_t printf(const char *fmt, Args... args) {
+    return (size_t)std::printf(fmt, args...);
+  }
+  operator bool() const { return true; }
+
+  uint32_t bytes_written = 0; ///< write() で破棄したバイト数
+  uint8_t last_write[64];     ///< 最後の write() の内容 (検証用)
+  size_t last_write_len = 0;
+};
+
+extern NativeSerial Serial;
+
+#endif // NATIVE_SHIM_ARDUINO_H
@@ -0,0 +1,19 @@
+/**
+ * @file SPI.h
+ * @brief ホスト (native) ビルド用 SPI の最小代替 (何もしない)
+ */
+
+#ifndef NATIVE_SHIM_SPI_H
+#define NATIVE_SHIM_SPI_H
+
+#include <Arduino.h>
+
+class NativeSPI {
+public:
+  void begin(void) {}
+  void end(void) {}
+};
+
+extern NativeSPI SPI;
+
+#endif // NATIVE_SHIM_SPI_H
@@ -0,0 +1,89 @@
+/**
+ * @file native_shim.cpp
+ * @brief ホスト (native) ビルド用代替 API の実装
+ */
+
+#include "Adafruit_TinyUSB.h"
+#include "Arduino.h"
+#include "SPI.h"
+#include <chrono>
+#include <thread>
+
+NativeSerial Serial;
+NativeSPI SPI;
+NativeTinyUSBDevice TinyUSBDevice;
+
+// --- 時間 (起動時刻基準の単調増加時計) ---
+static const std::chrono::steady_clock::time_point boot_time =
+    std::chrono::steady_clock::now();
+
+uint32_t micros(void) {
+  return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now() - boot_time)
+      .count();
+}
+
+uint32_t millis(void) {
+  return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now() - boot_time)
+      .count();
+}
+
+void delay(uint32_t ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(uint32_t us) {
+  std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+// --- HID ---
+static Adafruit_USBD_HID::get_report_callback_t registered_get_cb = nullptr;
+static Adafruit_USBD_HID::set_report_callback_t registered_set_cb = nullptr;
+static uint8_t last_input_id = 0;
+static uint8_t last_input_buf[64];
+static uint16_t last_input_len = 0;
+static native_shim_input_hook_t input_hook = nullptr;
+
+void Adafruit_USBD_HID::setReportCallback(get_report_callback_t get_cb,
+                                          set_report_callback_t set_cb) {
+  registered_get_cb = get_cb;
+  registered_set_cb = set_cb;
+}
+
+bool Adafruit_USBD_HID::sendReport(uint8_t report_id, void const *report,
+                                   uint8_t len) {
+  last_input_id = report_id;
+  last_input_len = (len < sizeof(last_input_buf)) ? len : sizeof(last_input_buf);
+  memcpy(last_input_buf, report, last_input_len);
+  if (input_hook != nullptr)
+    input_hook(report_id, last_input_buf, last_input_len);
+  return true;
+}
+
+void native_shim_set_input_hook(native_shim_input_hook_t hook) {
+  input_hook = hook;
+}
+
+void native_shim_inject_report(uint8_t report_id, hid_report_type_t type,
+                               uint8_t const *buffer, uint16_t bufsize) {
+  if (registered_set_cb != nullptr)
+    registered_set_cb(report_id, type, buffer, bufsize);
+}
+
+uint16_t native_shim_get_report(uint8_t report_id, hid_report_type_t type,
+                                uint8_t *buffer, uint16_t reqlen) {
+  if (registered_get_cb == nullptr)
+    return 0;
+  return registered_get_cb(report_id, type, buffer, reqlen);
+}
+
+uint16_t native_shim_last_input_report(uint8_t *report_id, uint8_t *buffer,
+                                       uint16_t buflen) {
+  uint16_t n = (last_input_len < buflen) ? last_input_len : buflen;
+  if (report_id != nullptr)
+    *report_id = last_input_id;
+  if (buffer != nullptr)
+    memcpy(buffer, last_input_buf, n);
+  return n;
+}
@@ -0,0 +1,28 @@
+/**
+ * @file pico/mutex.h
+ * @brief ホスト (native) ビルド用 pico-sdk mutex の代替 (std::timed_mutex)
+ */
+
+#ifndef NATIVE_SHIM_PICO_MUTEX_H
+#define NATIVE_SHIM_PICO_MUTEX_H
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+typedef struct {
+  std::timed_mutex m;
+} mutex_t;
+
+inline void mutex_init(mutex_t *) {}
+inline void mutex_enter_blocking(mutex_t *mtx) { mtx->m.lock(); }
+inline bool mutex_try_enter(mutex_t *mtx, uint32_t *owner_out) {
+  (void)owner_out;
+  return mtx->m.try_lock();
+}
+inline bool mutex_enter_timeout_ms(mutex_t *mtx, uint32_t timeout_ms) {
+  return mtx->m.try_lock_for(std::chrono::milliseconds(timeout_ms));
+}
+inline void mutex_exit(mutex_t *mtx) { mtx->m.unlock(); }
+
+#endif // NATIVE_SHIM_PICO_MUTEX_H
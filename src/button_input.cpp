@@ -0,0 +1,57 @@
+/**
+ * @file button_input.cpp
+ * @brief ボタン (GPIO) の一括読み取りの実装
+ */
+
+#include "button_input.h"
+
+#ifndef NATIVE_HOST
+#include <hardware/gpio.h>
+#endif
+
+static uint8_t button_pins[BUTTON_MAX_COUNT];
+static uint8_t button_count = 0;
+
+#ifndef NATIVE_HOST
+static inline uint32_t button_gpio_levels(void) { return gpio_get_all(); }
+
+static void button_pin_init(uint8_t pin) {
+  gpio_init(pin);
+  gpio_set_dir(pin, GPIO_IN);
+  gpio_pull_up(pin);
+}
+#else
+// ホスト上では button_input_inject() で与えた値を読む (初期値: 全ピン High)
+static uint32_t button_native_levels = 0xFFFFFFFFu;
+
+static inline uint32_t button_gpio_levels(void) { return button_native_levels; }
+static void button_pin_init(uint8_t pin) { (void)pin; }
+
+void button_input_inject(uint32_t gpio_levels) {
+  button_native_levels = gpio_levels;
+}
+#endif
+
+bool button_input_begin(const uint8_t *pins, uint8_t count) {
+  if (pins == nullptr || count > BUTTON_MAX_COUNT)
+    return false;
+  for (uint8_t i = 0; i < count; i++) {
+    if (pins[i] >= 30) // RP2040 の GPIO は GP0..GP29
+      return false;
+  }
+  for (uint8_t i = 0; i < count; i++) {
+    button_pins[i] = pins[i];
+    button_pin_init(pins[i]);
+  }
+  button_count = count;
+  return true;
+}
+
+uint16_t button_input_sample(void) {
+  // 押下で Low のため反転してから各ピンのビットを集める
+  uint32_t pressed = ~button_gpio_levels();
+  uint16_t buttons = 0;
+  for (uint8_t i = 0; i < button_count; i++)
+    buttons |= (uint16_t)(((pressed >> button_pins[i]) & 1u) << i);
+  return buttons;
+}
@@ -0,0 +1,182 @@
+/**
+ * @file ffb_engine.cpp
+ * @brief Core1 用 FFB エフェクト演算エンジンの実装
+ *
+ * 力の計算は EffectStore が種類別に行い、ここでは再生タイミング
+ * (startDelay / duration / loopCount / 繰り返し間隔) と Device Control
+ * (全停止 / 一時停止) のみを管理する。
+ */
+
+#include "ffb_engine.h"
+#include "deadline_queue.h"
+#include "effect_store.h"
+
+// --- エフェクトごとの再生状態 (Core1 専用) ---
+typedef struct {
+  uint8_t timing_state;     ///< 再生状態 (TIMING_*)
+  uint8_t startCount;       ///< 最後に受け付けた Start 回数
+  uint8_t loops_left;       ///< 残り再生回数 (FFB_LOOP_INFINITE: 無限)
+  uint32_t iteration_start; ///< 今回の再生を開始した周期カウンタ値
+  uint32_t epoch; ///< 状態を設定した時の stop_epoch (異なれば停止中)
+} ffb_effect_timing_t;
+
+// 再生状態 (状態が変わる時刻のみ timing_queue に登録する)
+// TIMING_PLAYING の間だけ EffectStore の再生リストに載せる
+enum : uint8_t {
+  TIMING_IDLE = 0,    ///< 停止中 (Start 未受信 / Stop 受信)
+  TIMING_DELAY,       ///< startDelay の経過待ち
+  TIMING_PLAYING,     ///< 再生中 (演算対象)
+  TIMING_REPEAT_WAIT, ///< 次の再生 (繰り返し) の開始待ち
+  TIMING_DONE         ///< loopCount 回の再生を完了 (次の Start まで停止)
+};
+
+// 全スロットが上限の力で Device Gain 等倍でも 32bit の積算に収まること
+static_assert((int64_t)MAX_EFFECTS * MIXER_FORCE_LIMIT * 256 < INT32_MAX,
+              "MAX_EFFECTS が FfbMixer の積算範囲を超えています");
+
+static ffb_effect_timing_t timing[MAX_EFFECTS];
+static EffectStore<MAX_EFFECTS> store;
+static uint32_t engine_now; ///< ffb_engine_update() の呼び出し回数 (周期)
+static DeadlineQueue<MAX_EFFECTS> timing_queue; ///< 再生状態の遷移予定
+static uint32_t engine_epoch; ///< 最後に受け取った stop_epoch
+static bool engine_paused;    ///< Device Pause 中 (周期カウンタを止める)
+
+// --- 再生タイミング (startDelay / duration / loopCount / 繰り返し間隔) ---
+
+/// @brief 1回分の再生を開始し、duration が有限なら終了時刻を登録する
+static void timing_play(ffb_effect_timing_t &t, uint8_t slot) {
+  const ffb_effect_setup_t &setup = store.setup(slot);
+  t.timing_state = TIMING_PLAYING;
+  t.iteration_start = engine_now;
+  store.start(slot);
+  if (setup.duration_ms == FFB_DURATION_INFINITE) {
+    timing_queue.cancel(slot);
+    return;
+  }
+  // 最低1周期は再生する (duration 0 の無限ループで同一周期に留まらない)
+  uint32_t ticks = store.durationToTicks(setup.duration_ms);
+  timing_queue.schedule(slot, engine_now + ((ticks > 0) ? ticks : 1));
+}
+
+/// @brief Start の受付: startDelay があれば待機し、無ければ即座に再生する
+static void timing_begin(ffb_effect_timing_t &t, uint8_t slot) {
+  const ffb_effect_setup_t &setup = store.setup(slot);
+  t.loops_left = (setup.loopCount == 0) ? 1 : setup.loopCount;
+  uint32_t delay = store.durationToTicks(setup.startDelay_ms);
+  if (delay > 0) {
+    t.timing_state = TIMING_DELAY;
+    store.stop(slot);
+    timing_queue.schedule(slot, engine_now + delay);
+  } else {
+    timing_play(t, slot);
+  }
+}
+
+static void timing_stop(ffb_effect_timing_t &t, uint8_t slot) {
+  t.timing_state = TIMING_IDLE;
+  store.stop(slot);
+  timing_queue.cancel(slot);
+}
+
+/**
+ * @brief 登録時刻を迎えたスロットの状態遷移
+ * 再生終了時は残り回数があれば次の再生へ進む。繰り返し間隔
+ * (triggerRepeatInterval) が duration より長い場合は、前回の開始から
+ * その間隔が経過するまで待機する
+ */
+static void timing_expire(ffb_effect_timing_t &t, uint8_t slot) {
+  switch (t.timing_state) {
+  case TIMING_DELAY:
+  case TIMING_REPEAT_WAIT:
+    timing_play(t, slot);
+    break;
+  case TIMING_PLAYING: {
+    if (t.loops_left != FFB_LOOP_INFINITE && --t.loops_left == 0) {
+      t.timing_state = TIMING_DONE;
+      store.stop(slot);
+      break;
+    }
+    uint16_t interval_ms = store.setup(slot).triggerRepeatInterval_ms;
+    uint32_t next = t.iteration_start + store.durationToTicks(interval_ms);
+    if ((int32_t)(next - engine_now) > 0) {
+      t.timing_state = TIMING_REPEAT_WAIT;
+      store.stop(slot);
+      timing_queue.schedule(slot, next);
+    } else {
+      timing_play(t, slot);
+    }
+    break;
+  }
+  default:
+    break;
+  }
+}
+
+void ffb_engine_init(uint32_t tick_us) {
+  store.setTick(tick_us);
+  store.clear();
+  engine_now = 0;
+  engine_epoch = 0;
+  engine_paused = false;
+  timing_queue.clear();
+  for (int i = 0; i < MAX_EFFECTS; i++) {
+    timing[i] = ffb_effect_timing_t();
+  }
+}
+
+void ffb_engine_load(const FFB_Shared_State_t *effects,
+                     ffb_slot_mask_t changed) {
+  changed &= FFB_SLOT_MASK_ALL;
+  while (changed != 0) {
+    uint8_t i = (uint8_t)__builtin_ctzll(changed);
+    changed &= changed - 1;
+    const FFB_Shared_State_t &effect = effects[i];
+    ffb_effect_timing_t &t = timing[i];
+    // 全停止より前の状態は無効 (停止時にスロットを走査しないため)
+    if (t.epoch != engine_epoch) {
+      t.timing_state = TIMING_IDLE;
+      t.epoch = engine_epoch;
+    }
+
+    store.load(i, effect);
+    if (!effect.active) {
+      if (t.timing_state != TIMING_IDLE)
+        timing_stop(t, i);
+      continue;
+    }
+    // 停止中からの開始、または Start の再送で最初から再生し直す
+    if (t.timing_state == TIMING_IDLE || t.startCount != effect.startCount) {
+      t.startCount = effect.startCount;
+      timing_begin(t, i);
+    }
+  }
+}
+
+bool ffb_engine_control(const ffb_device_control_t &control) {
+  engine_paused = control.paused;
+  if (control.stop_epoch == engine_epoch)
+    return false;
+  // 全停止: 再生リストと遷移予定を空にするだけで、スロットは走査しない。
+  // 各スロットの再生状態は次に ffb_engine_load() した時に破棄する
+  engine_epoch = control.stop_epoch;
+  store.stopAll();
+  timing_queue.clear();
+  return true;
+}
+
+void ffb_engine_update(const ffb_axis_state_t &axis, FfbMixer &mixer) {
+  mixer.clear();
+  // 一時停止中は再生時間を進めない (再開時は停止した位置から続ける)
+  if (engine_paused)
+    return;
+
+  // 状態が変わるスロットのみ処理する (期限前なら先頭の比較1回で終わる)
+  uint8_t slot;
+  while (timing_queue.popExpired(engine_now, slot))
+    timing_expire(timing[slot], slot);
+
+  // 再生中のエフェクトのみを種類ごとにまとめて評価する
+  store.evaluate(axis, mixer);
+
+  engine_now++;
+}
@@ -4,6 +4,13 @@
  */
 
 #include "hidwffb.h"
+#include "custom_force.h"
+#include "effect_pool.h"
+#include "latency_probe.h"
+#include "spsc_ring.h"
+#include "telemetry.h"
+#include "triple_buffer.h"
+#include <array>
 #include <stddef.h>
 #include <string.h>
 
@@ -34,30 +41,103 @@ static uint8_t const desc_hid_report[] = {
 
     // --- Output Reports: FFB/PID制御 (同一コレクション内) ---
     // Set Effect (ID: 1)
-    0x05, 0x01, //   Usage Page (Generic Desktop)
-    0x85, 0x01, //   Report ID (1)
-    0x09, 0x01, //   Usage (0x01)
-    0x75, 0x08, //   Report Size (8)
-    0x95, 0x0E, //   Report Count (14) - ID除くサイズ 14
-    0x91, 0x02, //   Output (Data, Variable, Absolute)
+    0x05, 0x01,              //   Usage Page (Generic Desktop)
+    0x85, 0x01,              //   Report ID (1)
+    0x09, 0x01,              //   Usage (0x01)
+    0x75, 0x08,              //   Report Size (8)
+    0x95, PID_RC_SET_EFFECT, //   Report Count (14) - ID除くサイズ 14
+    0x91, 0x02,              //   Output (Data, Variable, Absolute)
+
+    // Set Condition (ID: 3)
+    0x85, 0x03,                 //   Report ID (3)
+    0x09, 0x03,                 //   Usage (0x03)
+    0x95, PID_RC_SET_CONDITION, //   Report Count (14) - ID除くサイズ 14
+    0x91, 0x02,                 //   Output (Data, Variable, Absolute)
+
+    // Set Periodic (ID: 4)
+    0x85, 0x04,                //   Report ID (4)
+    0x09, 0x04,                //   Usage (0x04)
+    0x95, PID_RC_SET_PERIODIC, //   Report Count (9) - ID除くサイズ 9
+    0x91, 0x02,                //   Output (Data, Variable, Absolute)
+
+    // Set Envelope (ID: 8)
+    0x85, 0x08,                //   Report ID (8)
+    0x09, 0x08,                //   Usage (0x08)
+    0x95, PID_RC_SET_ENVELOPE, //   Report Count (9) - ID除くサイズ 9
+    0x91, 0x02,                //   Output (Data, Variable, Absolute)
 
     // Set Constant Force (ID: 5)
-    0x85, 0x05, //   Report ID (5)
-    0x09, 0x05, //   Usage (0x05)
-    0x95, 0x03, //   Report Count (3) - ID除くサイズ 3
-    0x91, 0x02, //   Output (Data, Variable, Absolute)
+    0x85, 0x05,                      //   Report ID (5)
+    0x09, 0x05,                      //   Usage (0x05)
+    0x95, PID_RC_SET_CONSTANT_FORCE, //   Report Count (3) - ID除くサイズ 3
+    0x91, 0x02,                      //   Output (Data, Variable, Absolute)
+
+    // Set Ramp Force (ID: 6)
+    0x85, 0x06,                  //   Report ID (6)
+    0x09, 0x06,                  //   Usage (0x06)
+    0x95, PID_RC_SET_RAMP_FORCE, //   Report Count (5) - ID除くサイズ 5
+    0x91, 0x02,                  //   Output (Data, Variable, Absolute)
+
+    // Set Custom Force (ID: 7)
+    0x85, 0x07,                    //   Report ID (7)
+    0x09, 0x07,                    //   Usage (0x07)
+    0x95, PID_RC_SET_CUSTOM_FORCE, //   Report Count (3) - ID除くサイズ 3
+                                   //   (Index, Sample Period)
+    0x91, 0x02,                    //   Output (Data, Variable, Absolute)
 
     // Device Gain (ID: 13)
-    0x85, 0x0D, //   Report ID (13)
-    0x09, 0x0D, //   Usage (0x0D)
-    0x95, 0x01, //   Report Count (1) - ID除くサイズ 1
-    0x91, 0x02, //   Output (Data, Variable, Absolute)
+    0x85, 0x0D,               //   Report ID (13)
+    0x09, 0x0D,               //   Usage (0x0D)
+    0x95, PID_RC_DEVICE_GAIN, //   Report Count (1) - ID除くサイズ 1
+    0x91, 0x02,               //   Output (Data, Variable, Absolute)
 
     // Effect Operation (ID: 10/0x0A)
-    0x85, 0x0A, //   Report ID (10)
-    0x09, 0x0A, //   Usage (0x0A)
-    0x95, 0x03, //   Report Count (3) - ID除くサイズ 3 (Index, Op, Loop)
-    0x91, 0x02, //   Output (Data, Variable, Absolute)
+    0x85, 0x0A,                    //   Report ID (10)
+    0x09, 0x0A,                    //   Usage (0x0A)
+    0x95, PID_RC_EFFECT_OPERATION, //   Report Count (3) - ID除くサイズ 3
+                                   //   (Index, Op, Loop)
+    0x91, 0x02,                    //   Output (Data, Variable, Absolute)
+
+    // Device Control (ID: 11/0x0B)
+    0x85, 0x0B,                  //   Report ID (11)
+    0x09, 0x0B,                  //   Usage (0x0B)
+    0x95, PID_RC_DEVICE_CONTROL, //   Report Count (1) - ID除くサイズ 1
+    0x91, 0x02,                  //   Output (Data, Variable, Absolute)
+
+    // Block Free (ID: 12/0x0C)
+    0x85, 0x0C,              //   Report ID (12)
+    0x09, 0x0C,              //   Usage (0x0C)
+    0x95, PID_RC_BLOCK_FREE, //   Report Count (1) - ID除くサイズ 1
+    0x91, 0x02,              //   Output (Data, Variable, Absolute)
+
+    // --- Feature Reports: エフェクトブロックの割当て ---
+    // Create New Effect (ID: 17/0x11, Set)
+    0x85, 0x11,                     //   Report ID (17)
+    0x09, 0x11,                     //   Usage (0x11)
+    0x95, PID_RC_CREATE_NEW_EFFECT, //   Report Count (3) - ID除くサイズ 3
+                                    //   (Type, Byte Count)
+    0xB1, 0x02,                     //   Feature (Data, Variable, Absolute)
+
+    // Block Load (ID: 18/0x12, Get)
+    0x85, 0x12,              //   Report ID (18)
+    0x09, 0x12,              //   Usage (0x12)
+    0x95, PID_RC_BLOCK_LOAD, //   Report Count (4) - ID除くサイズ 4
+                             //   (Index, Status, RAM Pool Available)
+    0xB1, 0x02,              //   Feature (Data, Variable, Absolute)
+
+    // Pool (ID: 19/0x13, Get)
+    0x85, 0x13,        //   Report ID (19)
+    0x09, 0x13,        //   Usage (0x13)
+    0x95, PID_RC_POOL, //   Report Count (4) - ID除くサイズ 4
+                       //   (RAM Pool Size, Max Effects, Flags)
+    0xB1, 0x02,        //   Feature (Data, Variable, Absolute)
+
+    // Custom Force Status (ID: 20/0x14, Get)
+    0x85, 0x14,                       //   Report ID (20)
+    0x09, 0x14,                       //   Usage (0x14)
+    0x95, PID_RC_CUSTOM_FORCE_STATUS, //   Report Count (28) - ID除くサイズ
+                                      //   (チャネルごとの受信状況 x 4)
+    0xB1, 0x02,                       //   Feature (Data, Variable, Absolute)
 
     // 汎用 FFB データ用 (ID: 2)
     0x06, 0x00, 0xFF, //   Usage Page (Vendor Defined 0xFF00)
@@ -69,53 +149,310 @@ static uint8_t const desc_hid_report[] = {
     0xC0 // End Collection
 };
 
+// 高分解能入力 (別インタフェース): ベンダ定義の Input Report のみ
+// HID_HIRES_INTERFACES 個のインタフェースで同じ記述子を使う
+static uint8_t const desc_hid_hires_report[] = {
+    0x06, 0x00, 0xFF,         // Usage Page (Vendor Defined 0xFF00)
+    0x09, 0x15,               // Usage (0x15)
+    0xA1, 0x01,               // Collection (Application)
+    0x85, HID_ID_HIRES_INPUT, //   Report ID (21)
+    0x09, 0x15,               //   Usage (0x15)
+    0x15, 0x00,               //   Logical Minimum (0)
+    0x26, 0xFF, 0x00,         //   Logical Maximum (255)
+    0x75, 0x08,               //   Report Size (8)
+    0x95, HID_RC_HIRES_INPUT, //   Report Count (58) - ID除くサイズ
+                              //   (ヘッダ 8 + サンプル 10 x 5)
+    0x81, 0x02,               //   Input (Data, Variable, Absolute)
+    0xC0                      // End Collection
+};
+
 // USB HID インスタンス
 static Adafruit_USBD_HID _usb_hid;
+static Adafruit_USBD_HID _usb_hid_hires[HID_HIRES_INTERFACES];
+static uint8_t _hires_interfaces = 0; ///< 登録できた高分解能入力の数
+
+// 高分解能入力のサンプル (Core1 -> Core0)
+typedef struct {
+  uint32_t time_us;
+  uint16_t sequence;
+  int16_t steer;
+  int16_t accel;
+  int16_t brake;
+  int16_t torque;
+} hidwffb_hires_entry_t;
+
+static SpscRing<hidwffb_hires_entry_t, HID_HIRES_QUEUE_DEPTH> _hires_queue;
+static uint16_t core1_hires_sequence = 0;
+// 送信できなかったレポート (インタフェースごと, Core0 のみ参照)。
+// 取り出したサンプルを失わない
+static hidwffb_hires_report_t core0_hires_report[HID_HIRES_INTERFACES];
+static bool core0_hires_staged[HID_HIRES_INTERFACES];
 
 // FFBデータ管理用
 static uint8_t _ffb_data[HID_FFB_REPORT_SIZE];
 static volatile bool _ffb_updated = false;
 
+// Output Report 受信キュー (USB コールバック -> Core0 ループ)
+// 1周期内に複数のレポートが届いても取りこぼさず、受信順に処理する
+static SpscRing<hidwffb_rx_report_t, HID_RX_QUEUE_DEPTH> _rx_queue;
+// Report ID を data の直前に置くことで、キュー要素をコピー無しで
+// USB_FFB_Report_* 構造体として参照できる (PID_DispatchReport の前提条件)
+static_assert(offsetof(hidwffb_rx_report_t, data) ==
+                  offsetof(hidwffb_rx_report_t, reportId) + 1,
+              "hidwffb_rx_report_t: reportId は data の直前に配置すること");
+
 // PIDパース状態保持用
-static pid_debug_info_t _pid_debug = {0, false, 0, 0, false};
+static pid_debug_info_t _pid_debug = {};
 // Core 0 用のローカルデータ（パース結果の保持用）
 static FFB_Shared_State_t core0_ffb_effects[MAX_EFFECTS];
 static uint8_t core0_global_gain = 255;
 
+// エフェクトブロックの割当て (デバイス管理)
+static EffectBlockPool<MAX_EFFECTS> core0_block_pool;
+static constexpr uint16_t FFB_BLOCK_BYTES = sizeof(FFB_Shared_State_t);
+static_assert((uint32_t)MAX_EFFECTS * FFB_BLOCK_BYTES <= 0xFFFF,
+              "RAM Pool Size が 16bit を超えています");
+// 直前の Create New Effect の結果 (USB コールバックのみが更新する)
+static USB_FFB_Report_BlockLoad_t _block_load = {HID_ID_BLOCK_LOAD, 0,
+                                                 PID_BLOCK_LOAD_ERROR, 0};
+
+/**
+ * @brief 割り当てたブロックの初期化依頼 (受信キュー経由で Core0 ループへ渡す)
+ * Create New Effect のペイロードの後ろに、割り当てたブロック番号を付加する
+ */
+typedef struct {
+  USB_FFB_Report_CreateNewEffect_t request;
+  uint8_t effectBlockIndex; ///< 1..40
+} __attribute__((packed)) pid_block_created_t;
+static_assert(sizeof(pid_block_created_t) - 1 <= HID_FFB_REPORT_SIZE,
+              "pid_block_created_t が受信キュー要素に収まりません");
+
+// Custom Force のサンプル列 (Core0 -> Core1)
+static ffb_custom_channel_t custom_channels[FFB_CUSTOM_CHANNELS];
+// チャネルの割当て (Core0 ループのみ更新)
+static uint8_t core0_custom_owner[FFB_CUSTOM_CHANNELS]; ///< ブロック (0: 空き)
+static uint16_t core0_custom_next_seq[FFB_CUSTOM_CHANNELS]; ///< 次のチャンク
+// サンプル列はキュー要素内でコピーせずにリングへ渡すため、
+// 16bit 境界に置かれること
+static_assert((offsetof(hidwffb_rx_report_t, reportId) +
+               offsetof(USB_FFB_Report_CustomForceData_t, samples)) %
+                      alignof(int16_t) ==
+                  0,
+              "Custom Force のサンプルが 16bit 境界にありません");
+
+// 共有メモリへ未反映のスロット
+static ffb_slot_mask_t core0_dirty_mask = 0;
+static uint32_t core0_gain_generation = 0; ///< 0x0D 受信ごとに加算
+
+static inline void core0_mark_dirty(uint8_t idx) {
+  core0_dirty_mask |= (ffb_slot_mask_t)1 << idx;
+}
+
+// Device Control (0x0B)。全停止はスロットに触れず stop_epoch の加算のみとし、
+// 各スロットは Start 時の stop_epoch と比べて停止済みかを判定する
+static ffb_device_control_t core0_control = {0, true, false};
+static uint32_t core0_control_generation = 0; ///< 0x0B 受信ごとに加算
+static uint32_t core0_start_epoch[MAX_EFFECTS]; ///< Start 時の stop_epoch
+
+/// @brief 全エフェクトの停止 (O(1), Core1 は stop_epoch の変化で検出する)
+static void core0_stop_all(void) {
+  core0_control.stop_epoch++;
+  core0_control_generation++;
+}
+
+/// @brief ブロックに割り当てたチャネル (1..FFB_CUSTOM_CHANNELS, 0: 無し)
+static uint8_t custom_channel_of(uint8_t idx) {
+  for (uint8_t ch = 0; ch < FFB_CUSTOM_CHANNELS; ch++)
+    if (core0_custom_owner[ch] == idx + 1)
+      return ch + 1;
+  return 0;
+}
+
+/// @brief ブロックのチャネルを解放する (割当てが無ければ何もしない)
+static void custom_channel_release(uint8_t idx) {
+  uint8_t ch = custom_channel_of(idx);
+  if (ch == 0)
+    return;
+  core0_custom_owner[ch - 1] = 0;
+  core0_ffb_effects[idx].force.custom = ffb_custom_block_t();
+  core0_mark_dirty(idx);
+}
+
+#ifdef LATENCY_PROBE_ENABLE
+// 共有メモリへ未反映の変更のうち、最も古いレポートの受信/パース時刻
+static bool core0_pending_stamped = false;
+static uint32_t core0_pending_rx_us = 0;
+static uint32_t core0_pending_dispatch_us = 0;
+// 最後に取得した入力を Core1 が書き込んだ時刻 (HID 未送信の場合 true)
+static bool core0_input_pending = false;
+static uint32_t core0_input_written_us = 0;
+#endif
+
+/**
+ * @brief Create New Effect (Feature) の処理 (USB コールバック内)
+ * ホストは続けて Block Load を読むため、ここで割り当てて結果を確定する。
+ * ブロックの初期化は受信キューを経由して Core0 ループで行い、
+ * 先に届いた Block Free 等との順序を保つ
+ */
+static void pid_create_new_effect(uint8_t const *buffer, uint16_t bufsize) {
+  _block_load.effectBlockIndex = 0;
+  _block_load.loadStatus = PID_BLOCK_LOAD_ERROR;
+
+  uint8_t idx;
+  hidwffb_rx_report_t *slot = NULL;
+  if (bufsize >= PID_RC_CREATE_NEW_EFFECT)
+    slot = _rx_queue.acquireWrite(); // 満杯なら初期化を依頼できない
+  if (slot != NULL) {
+    if (core0_block_pool.allocate(idx)) {
+      slot->timestamp_us = micros();
+      slot->len = sizeof(pid_block_created_t) - 1;
+      slot->reportId = HID_ID_CREATE_NEW_EFFECT;
+      memcpy(slot->data, buffer, PID_RC_CREATE_NEW_EFFECT);
+      slot->data[PID_RC_CREATE_NEW_EFFECT] = idx + 1;
+      _rx_queue.commitWrite();
+      _block_load.effectBlockIndex = idx + 1;
+      _block_load.loadStatus = PID_BLOCK_LOAD_SUCCESS;
+    } else {
+      _block_load.loadStatus = PID_BLOCK_LOAD_FULL;
+    }
+  }
+  _block_load.ramPoolAvailable =
+      (uint16_t)(core0_block_pool.available() * FFB_BLOCK_BYTES);
+}
+
 /**
  * @brief HID受信コールバック (内部用)
- * PCから Output Report (FFB) が届いた際に呼び出される
+ * PCから Output Report (FFB) が届いた際に呼び出される。
+ * USB タスク内での処理を最小にするため、受信時刻とともにキューへ積むだけとし、
+ * パースは hidwffb_process_reports() で行う
  */
 void _hid_report_callback(uint8_t report_id, hid_report_type_t report_type,
                           uint8_t const *buffer, uint16_t bufsize) {
-  if (report_type == HID_REPORT_TYPE_OUTPUT) {
+  if (report_type == HID_REPORT_TYPE_FEATURE) {
+    if (report_id == HID_ID_CREATE_NEW_EFFECT)
+      pid_create_new_effect(buffer, bufsize);
+    return;
+  }
+  // 割当ての依頼は Feature でのみ受け付ける (Output での偽装を防ぐ)
+  if (report_type == HID_REPORT_TYPE_OUTPUT &&
+      report_id != HID_ID_CREATE_NEW_EFFECT) {
     // buffer には report_id が含まれない場合がある（TinyUSBの仕様による）
-    // PID_ParseReport は buffer[0] が ID
-    // であることを期待しているため、一時的なバッファを作成
-    uint8_t temp_buf[HID_FFB_REPORT_SIZE];
-    temp_buf[0] = report_id;
+    hidwffb_rx_report_t *slot = _rx_queue.acquireWrite();
+    if (slot == NULL)
+      return; // キュー満杯 (オーバーフロー回数は記録済み)
+
     uint16_t copy_size =
-        (bufsize < HID_FFB_REPORT_SIZE - 1) ? bufsize : HID_FFB_REPORT_SIZE - 1;
-    memcpy(&temp_buf[1], buffer, copy_size);
+        (bufsize < HID_FFB_REPORT_SIZE) ? bufsize : HID_FFB_REPORT_SIZE;
+    slot->timestamp_us = micros();
+    slot->len = copy_size;
+    slot->reportId = report_id;
+    memcpy(slot->data, buffer, copy_size);
+    _rx_queue.commitWrite();
+  }
+}
+
+/**
+ * @brief Custom Force の受信状況 (USB コールバックから読む)
+ * 各値は Core0 ループ/Core1 が個別に更新するため、値の組は同時刻のものとは
+ * 限らない (ホストは nextSequence と空きを目安に再送・送信量を決める)
+ */
+static void custom_force_status(USB_FFB_Report_CustomForceStatus_t *status) {
+  status->reportId = HID_ID_CUSTOM_FORCE_STATUS;
+  for (uint8_t ch = 0; ch < FFB_CUSTOM_CHANNELS; ch++) {
+    const ffb_custom_channel_t &channel = custom_channels[ch];
+    ffb_custom_stream_status_t &dest = status->channel[ch];
+    dest.effectBlockIndex = core0_custom_owner[ch];
+    dest.nextSequence = core0_custom_next_seq[ch];
+    dest.freeSamples =
+        (uint16_t)(ffb_custom_ring_t::CAPACITY - channel.samples.size());
+    dest.underruns = channel.underruns.load(std::memory_order_relaxed);
+  }
+}
 
-    // PIDパースの実行
-    PID_ParseReport(temp_buf, copy_size + 1);
+/**
+ * @brief HID Feature Report の読出しコールバック (内部用)
+ * buffer には Report ID を除く内容を書き込む (ID は TinyUSB が付加する)
+ * @return 書き込んだ長さ (0: 未対応の ID, ホストへは STALL)
+ */
+uint16_t _hid_get_report_callback(uint8_t report_id,
+                                  hid_report_type_t report_type,
+                                  uint8_t *buffer, uint16_t reqlen) {
+  static const USB_FFB_Report_Pool_t pool = {
+      HID_ID_POOL, (uint16_t)(MAX_EFFECTS * FFB_BLOCK_BYTES), MAX_EFFECTS,
+      PID_POOL_DEVICE_MANAGED};
+  static USB_FFB_Report_CustomForceStatus_t status;
+  if (report_type != HID_REPORT_TYPE_FEATURE || buffer == NULL)
+    return 0;
 
-    // 従来の汎用バッファ更新 (Report ID 1 または 2 を想定)
-    if (report_id == 1 || report_id == 2) {
-      memcpy(_ffb_data, temp_buf,
-             (copy_size + 1 < HID_FFB_REPORT_SIZE) ? copy_size + 1
-                                                   : HID_FFB_REPORT_SIZE);
-      _ffb_updated = true;
-    }
+  const uint8_t *src;
+  uint16_t len;
+  if (report_id == HID_ID_BLOCK_LOAD) {
+    src = (const uint8_t *)&_block_load + 1;
+    len = PID_RC_BLOCK_LOAD;
+  } else if (report_id == HID_ID_POOL) {
+    src = (const uint8_t *)&pool + 1;
+    len = PID_RC_POOL;
+  } else if (report_id == HID_ID_CUSTOM_FORCE_STATUS) {
+    custom_force_status(&status);
+    src = (const uint8_t *)&status + 1;
+    len = PID_RC_CUSTOM_FORCE_STATUS;
+  } else {
+    return 0;
   }
+  if (len > reqlen)
+    len = reqlen;
+  memcpy(buffer, src, len);
+  return len;
+}
+
+// --- USB SOF (フレーム開始) の観測 ---
+// USB タスク (Core0) のみが更新する。いずれも 32bit の単一ワードのため、
+// 他コアからも読み出せる (件数と時刻の組は不一致になり得るが、
+// 時刻はフレーム周期の位相としてのみ使用するため問題無い)
+static volatile uint32_t _sof_count = 0;
+static volatile uint32_t _sof_us = 0;
+
+/**
+ * @brief TinyUSB の SOF コールバック (hidwffb_sof_enable(true) 時のみ呼ばれる)
+ */
+extern "C" void tud_sof_cb(uint32_t frame_count) {
+  (void)frame_count;
+  _sof_us = micros();
+  _sof_count = _sof_count + 1;
 }
 
-void hidwffb_begin(uint8_t poll_interval_ms) {
+void hidwffb_sof_enable(bool enable) { tud_sof_cb_enable(enable); }
+
+bool hidwffb_poll_sof(uint32_t *last_count, uint32_t *sof_us) {
+  uint32_t count = _sof_count;
+  if (count == *last_count)
+    return false;
+  *last_count = count;
+  *sof_us = _sof_us;
+  return true;
+}
+
+void hidwffb_begin(uint8_t poll_interval_ms, bool hires_input) {
   _usb_hid.setPollInterval(poll_interval_ms);
   _usb_hid.setReportDescriptor(desc_hid_report, sizeof(desc_hid_report));
-  _usb_hid.setReportCallback(NULL, _hid_report_callback);
+  _usb_hid.setReportCallback(_hid_get_report_callback, _hid_report_callback);
   _usb_hid.begin();
+
+  // ゲームパッドと同じエンドポイントに載せると、1フレームに1レポートしか
+  // 送れないためゲームパッドの送信周期が落ちる。別インタフェースとし、
+  // 1 レポートに入らない 5 サンプル/フレーム超の分はインタフェースを増やす
+  if (hires_input) {
+    for (uint8_t i = 0; i < HID_HIRES_INTERFACES; i++) {
+      Adafruit_USBD_HID &hid = _usb_hid_hires[i];
+      hid.setPollInterval(poll_interval_ms);
+      hid.setReportDescriptor(desc_hid_hires_report,
+                              sizeof(desc_hid_hires_report));
+      // CFG_TUD_HID が足りない場合は、登録できた数だけ使う
+      if (!hid.begin())
+        break;
+      _hires_interfaces++;
+    }
+  }
 }
 
 bool hidwffb_is_mounted(void) { return TinyUSBDevice.mounted(); }
@@ -134,7 +471,88 @@ bool hidwffb_ready(void) {
 bool hidwffb_send_report(custom_gamepad_report_t *report) {
   if (!hidwffb_ready())
     return false;
-  return _usb_hid.sendReport(1, report, sizeof(custom_gamepad_report_t));
+  bool sent = _usb_hid.sendReport(1, report, sizeof(custom_gamepad_report_t));
+#ifdef LATENCY_PROBE_ENABLE
+  if (sent && core0_input_pending) {
+    LATENCY_RECORD(LAT_SENSOR_TO_HOST, core0_input_written_us);
+    core0_input_pending = false;
+  }
+#endif
+  return sent;
+}
+
+void hidwffb_hires_push(uint32_t time_us, const custom_gamepad_report_t &input,
+                        int16_t torque) {
+  hidwffb_hires_entry_t *entry = _hires_queue.acquireWrite();
+  if (entry != NULL) {
+    entry->time_us = time_us;
+    entry->sequence = core1_hires_sequence;
+    entry->steer = input.steer;
+    entry->accel = input.accel;
+    entry->brake = input.brake;
+    entry->torque = torque;
+    _hires_queue.commitWrite();
+  }
+  core1_hires_sequence++;
+}
+
+/**
+ * @brief キューの先頭から、通番の連続するサンプルを1レポートにまとめる
+ * @return まとめたサンプルがある場合 true
+ */
+static bool hires_stage(hidwffb_hires_report_t *report) {
+  const hidwffb_hires_entry_t *entry = _hires_queue.front();
+  if (entry == NULL)
+    return false;
+  report->sequence = entry->sequence;
+  report->timestamp_us = entry->time_us;
+  // キュー満杯で捨てたサンプルの前後は別のレポートとし、
+  // 各レポートのサンプルの通番を連続させる
+  uint8_t count = 0;
+  while (count < HID_HIRES_MAX_SAMPLES && entry != NULL &&
+         entry->sequence == (uint16_t)(report->sequence + count)) {
+    hidwffb_hires_sample_t *sample = &report->samples[count++];
+    sample->offset_us = (uint16_t)(entry->time_us - report->timestamp_us);
+    sample->steer = entry->steer;
+    sample->accel = entry->accel;
+    sample->brake = entry->brake;
+    sample->torque = entry->torque;
+    _hires_queue.popFront();
+    entry = _hires_queue.front();
+  }
+  // 未使用のサンプル欄は 0 とする
+  memset(&report->samples[count], 0,
+         (HID_HIRES_MAX_SAMPLES - count) * sizeof(hidwffb_hires_sample_t));
+  uint16_t pending = _hires_queue.size();
+  report->sampleCount = count;
+  report->pending = (uint8_t)((pending > 0xFF) ? 0xFF : pending);
+  return true;
+}
+
+bool hidwffb_send_hires_report(void) {
+  if (_hires_interfaces == 0 || !TinyUSBDevice.mounted() ||
+      TinyUSBDevice.suspended())
+    return false;
+
+  // インタフェースごとに1フレーム1レポートを送れるため、順に詰める
+  bool sent = false;
+  for (uint8_t i = 0; i < _hires_interfaces; i++) {
+    if (!_usb_hid_hires[i].ready())
+      continue;
+    // 前回送れなかったレポートがあれば、サンプルを追加せずに送り直す
+    hidwffb_hires_report_t *report = &core0_hires_report[i];
+    if (!core0_hires_staged[i]) {
+      if (!hires_stage(report))
+        continue;
+      core0_hires_staged[i] = true;
+    }
+    if (!_usb_hid_hires[i].sendReport(HID_ID_HIRES_INPUT, report,
+                                      sizeof(hidwffb_hires_report_t)))
+      continue;
+    core0_hires_staged[i] = false;
+    sent = true;
+  }
+  return sent;
 }
 
 bool hidwffb_get_ffb_data(uint8_t *buffer) {
@@ -150,84 +568,434 @@ bool hidwffb_get_ffb_data(uint8_t *buffer) {
 
 void hidwffb_clear_ffb_flag(void) { _ffb_updated = false; }
 
-void PID_ParseReport(uint8_t const *buffer, uint16_t bufsize) {
-  if (buffer == NULL || bufsize == 0)
-    return;
+/**
+ * @brief 受信キューに溜まった Output Report を受信順に処理する (Core0 用)
+ * @param max_reports 1回の呼び出しで処理する最大件数
+ * @return 処理した件数
+ */
+uint16_t hidwffb_process_reports(uint16_t max_reports) {
+  uint16_t processed = 0;
+
+  while (processed < max_reports) {
+    const hidwffb_rx_report_t *report = _rx_queue.front();
+    if (report == NULL)
+      break;
 
-  uint8_t reportId = buffer[0];
-  _pid_debug.lastReportId = reportId;
-
-  switch (reportId) {
-  case 0x01: { // Set Effect Report
-    if (bufsize >= sizeof(USB_FFB_Report_SetEffect_t)) {
-      USB_FFB_Report_SetEffect_t *report = (USB_FFB_Report_SetEffect_t *)buffer;
-      // ET Constant Force (0x26) のチェック
-      uint8_t idx = report->effectBlockIndex - 1;
-      if (idx < MAX_EFFECTS) {
-        core0_ffb_effects[idx].type = report->effectType;
-        core0_ffb_effects[idx].gain = report->gain; // Gainを記録
-      }
-      if (report->effectType == 0x26) {
-        _pid_debug.isConstantForce = true;
-        // SetEffect時のGainを暫定的なMagとして扱う（後のID:05で上書きされる可能性あり）
-        _pid_debug.magnitude = report->gain;
-      } else {
-        _pid_debug.isConstantForce = false;
-      }
-      _pid_debug.updated = true;
+    // PIDパースの実行 (キュー要素を直接参照し、コピーしない)
+    PID_DispatchReport(report->reportId, report->data, report->len);
+#ifdef LATENCY_PROBE_ENABLE
+    LATENCY_RECORD(LAT_RX_TO_DISPATCH, report->timestamp_us);
+    if (!core0_pending_stamped) {
+      core0_pending_stamped = true;
+      core0_pending_rx_us = report->timestamp_us;
+      core0_pending_dispatch_us = LATENCY_STAMP();
     }
-    break;
+#endif
+
+    // 従来の汎用バッファ更新 (Report ID 1 または 2 を想定)
+    // Custom Force のサンプル列はループバックテストの契機としない。
+    // 長さ 0 のベンダーレポートは data[0] が前回の内容のため扱わない
+    bool vendor = report->reportId == HID_ID_VENDOR_FFB && report->len > 0;
+    bool custom_force =
+        vendor && report->data[0] == HID_VENDOR_CMD_CUSTOM_FORCE;
+    if (report->reportId == HID_ID_SET_EFFECT || (vendor && !custom_force)) {
+      uint16_t size = (report->len + 1 < HID_FFB_REPORT_SIZE)
+                          ? report->len + 1
+                          : HID_FFB_REPORT_SIZE;
+      memcpy(_ffb_data, &report->reportId, size);
+      _ffb_updated = true;
+    }
+
+    _rx_queue.popFront();
+    processed++;
   }
+  return processed;
+}
+
+void hidwffb_get_rx_stats(hidwffb_rx_stats_t *stats) {
+  if (stats == NULL)
+    return;
+  stats->queued = _rx_queue.size();
+  stats->high_water = _rx_queue.highWater();
+  stats->capacity = _rx_queue.CAPACITY;
+  stats->overflow_count = _rx_queue.overflowCount();
+}
+
+// --- PID レポート別ハンドラ ---
+// report は Report ID を先頭に含むレポート全体を指す
 
-  case 0x05: { // Set Constant Force Report
-    if (bufsize >= sizeof(USB_FFB_Report_SetConstantForce_t)) {
-      USB_FFB_Report_SetConstantForce_t *report =
-          (USB_FFB_Report_SetConstantForce_t *)buffer;
-      uint8_t idx = report->effectBlockIndex - 1;
-      if (idx < MAX_EFFECTS) {
-        // PCから届く -10000〜10000 の値を、内部用の -32767〜32767
-        // 等にスケーリング
-        core0_ffb_effects[idx].magnitude = report->magnitude;
-      }
-      _pid_debug.magnitude = report->magnitude;
-      _pid_debug.updated = true;
+// パラメータブロックの種類 (FFB_Shared_State_t の共用体のどの側を使うか)
+enum : uint8_t {
+  PID_BLOCK_FORCE = 0, ///< envelope + periodic / ramp
+  PID_BLOCK_CONDITION, ///< condition
+  PID_BLOCK_CUSTOM     ///< custom
+};
+
+static uint8_t pid_block_class(uint8_t type) {
+  if (ffb_type_is_condition(type))
+    return PID_BLOCK_CONDITION;
+  return (type == HID_ET_CUSTOM) ? PID_BLOCK_CUSTOM : PID_BLOCK_FORCE;
+}
+
+/**
+ * @brief パラメータブロックの種類がスロットの種類と一致するか
+ * 種類が未設定 (Set Effect より先にパラメータが届いた場合) は受け付ける
+ * @param block_class PID_BLOCK_*
+ */
+static bool pid_block_matches(const FFB_Shared_State_t &effect,
+                              uint8_t block_class) {
+  return effect.type == 0 || pid_block_class(effect.type) == block_class;
+}
+
+static void pid_handle_set_effect(const USB_FFB_Report_SetEffect_t *report) {
+  // ET Constant Force (0x26) のチェック
+  uint8_t idx = report->effectBlockIndex - 1;
+  if (idx < MAX_EFFECTS) {
+    FFB_Shared_State_t &effect = core0_ffb_effects[idx];
+    // パラメータブロックの種類が変わった場合、重なった別種のパラメータを消す
+    if (effect.type != 0 &&
+        pid_block_class(effect.type) != pid_block_class(report->effectType)) {
+      custom_channel_release(idx);
+      effect.force = ffb_force_block_t();
     }
-    break;
+    effect.type = report->effectType;
+    effect.gain = report->gain; // Gainを記録
+    effect.duration_ms = report->duration;
+    effect.startDelay_ms = report->startDelay;
+    effect.triggerRepeatInterval_ms = report->triggerRepeatInterval;
+    core0_mark_dirty(idx);
+  }
+  if (report->effectType == 0x26) {
+    _pid_debug.isConstantForce = true;
+    // SetEffect時のGainを暫定的なMagとして扱う（後のID:05で上書きされる可能性あり）
+    _pid_debug.magnitude = report->gain;
+  } else {
+    _pid_debug.isConstantForce = false;
   }
+  _pid_debug.updated = true;
+}
+
+static void
+pid_handle_set_envelope(const USB_FFB_Report_SetEnvelope_t *report) {
+  uint8_t idx = report->effectBlockIndex - 1;
+  if (idx < MAX_EFFECTS &&
+      pid_block_matches(core0_ffb_effects[idx], PID_BLOCK_FORCE)) {
+    ffb_envelope_block_t &envelope = core0_ffb_effects[idx].force.envelope;
+    envelope.attackLevel =
+        (report->attackLevel > 32767) ? 32767 : report->attackLevel;
+    envelope.fadeLevel =
+        (report->fadeLevel > 32767) ? 32767 : report->fadeLevel;
+    envelope.attackTime_ms = report->attackTime;
+    envelope.fadeTime_ms = report->fadeTime;
+    core0_mark_dirty(idx);
+  }
+  _pid_debug.updated = true;
+}
 
-  case 0x0A: { // Set Effect Operation Report
-    if (bufsize >= sizeof(USB_FFB_Report_EffectOperation_t)) {
-      USB_FFB_Report_EffectOperation_t *report =
-          (USB_FFB_Report_EffectOperation_t *)buffer;
-      uint8_t idx = report->effectBlockIndex - 1;
-      if (idx < MAX_EFFECTS) {
-        if (report->operation == HID_OP_START)
-          core0_ffb_effects[idx].active = true;
-        if (report->operation == HID_OP_STOP)
-          core0_ffb_effects[idx].active = false;
-      }
-      _pid_debug.operation = report->operation;
-      _pid_debug.effectBlockIndex = report->effectBlockIndex;
-      _pid_debug.updated = true;
+static void
+pid_handle_set_condition(const USB_FFB_Report_SetCondition_t *report) {
+  uint8_t idx = report->effectBlockIndex - 1;
+  // 操舵軸 (1軸) のみ対応。他の軸のパラメータブロックは無視する
+  if (idx < MAX_EFFECTS && report->parameterBlockOffset == 0 &&
+      pid_block_matches(core0_ffb_effects[idx], PID_BLOCK_CONDITION)) {
+    ffb_condition_block_t &condition = core0_ffb_effects[idx].condition;
+    condition.cpOffset = report->cpOffset;
+    condition.positiveCoefficient = report->positiveCoefficient;
+    condition.negativeCoefficient = report->negativeCoefficient;
+    condition.positiveSaturation = report->positiveSaturation;
+    condition.negativeSaturation = report->negativeSaturation;
+    condition.deadBand = report->deadBand;
+    core0_mark_dirty(idx);
+  }
+  _pid_debug.updated = true;
+}
+
+static void
+pid_handle_set_periodic(const USB_FFB_Report_SetPeriodic_t *report) {
+  uint8_t idx = report->effectBlockIndex - 1;
+  if (idx < MAX_EFFECTS &&
+      pid_block_matches(core0_ffb_effects[idx], PID_BLOCK_FORCE)) {
+    uint16_t magnitude =
+        (report->magnitude > 32767) ? 32767 : report->magnitude;
+    core0_ffb_effects[idx].magnitude = (int16_t)magnitude;
+    ffb_periodic_block_t &periodic = core0_ffb_effects[idx].force.periodic;
+    periodic.offset = report->offset;
+    periodic.phase = report->phase;
+    periodic.period_ms = report->period;
+    core0_mark_dirty(idx);
+  }
+  _pid_debug.magnitude = (int16_t)report->magnitude;
+  _pid_debug.updated = true;
+}
+
+static void
+pid_handle_set_constant_force(const USB_FFB_Report_SetConstantForce_t *report) {
+  uint8_t idx = report->effectBlockIndex - 1;
+  if (idx < MAX_EFFECTS) {
+    // PCから届く -10000〜10000 の値を、内部用の -32767〜32767
+    // 等にスケーリング
+    core0_ffb_effects[idx].magnitude = report->magnitude;
+    core0_mark_dirty(idx);
+  }
+  _pid_debug.magnitude = report->magnitude;
+  _pid_debug.updated = true;
+}
+
+static void
+pid_handle_set_ramp_force(const USB_FFB_Report_SetRampForce_t *report) {
+  uint8_t idx = report->effectBlockIndex - 1;
+  if (idx < MAX_EFFECTS &&
+      pid_block_matches(core0_ffb_effects[idx], PID_BLOCK_FORCE)) {
+    core0_ffb_effects[idx].force.ramp.start = report->rampStart;
+    core0_ffb_effects[idx].force.ramp.end = report->rampEnd;
+    core0_mark_dirty(idx);
+  }
+  _pid_debug.updated = true;
+}
+
+/**
+ * @brief Set Custom Force: サンプル周期を設定し、サンプル列のチャネルを
+ * 割り当てる。割当て済みの場合も受信を最初からやり直す (チャンク番号を 0
+ * に戻し、未再生のサンプルを捨てる)。空きチャネルが無い場合は無視する
+ */
+static void
+pid_handle_set_custom_force(const USB_FFB_Report_SetCustomForce_t *report) {
+  uint8_t idx = report->effectBlockIndex - 1;
+  if (idx >= MAX_EFFECTS ||
+      !pid_block_matches(core0_ffb_effects[idx], PID_BLOCK_CUSTOM))
+    return;
+  uint8_t ch = custom_channel_of(idx);
+  for (uint8_t i = 0; ch == 0 && i < FFB_CUSTOM_CHANNELS; i++)
+    if (core0_custom_owner[i] == 0)
+      ch = i + 1;
+  if (ch == 0)
+    return;
+  core0_custom_owner[ch - 1] = idx + 1;
+  core0_custom_next_seq[ch - 1] = 0;
+
+  FFB_Shared_State_t &effect = core0_ffb_effects[idx];
+  effect.type = HID_ET_CUSTOM;
+  effect.force.custom.samplePeriod_us = report->samplePeriod_us;
+  effect.force.custom.startPosition =
+      custom_channels[ch - 1].samples.writePosition();
+  effect.force.custom.channel = ch;
+  core0_mark_dirty(idx);
+  _pid_debug.effectBlockIndex = report->effectBlockIndex;
+  _pid_debug.updated = true;
+}
+
+/**
+ * @brief Custom Force のサンプル列 (ID 2) をチャネルへ積む
+ * 期待するチャンク番号以外 (再送済み/欠落) と、リングに全て入らない
+ * チャンクは取り込まない。ホストは Custom Force Status の nextSequence
+ * から再送するため、サンプルは欠けも重複もしない
+ */
+static void
+pid_handle_custom_force_data(const USB_FFB_Report_CustomForceData_t *report) {
+  if (report->command != HID_VENDOR_CMD_CUSTOM_FORCE)
+    return; // 従来の汎用データ (hidwffb_get_ffb_data() で取得する)
+  uint8_t ch = custom_channel_of(report->effectBlockIndex - 1);
+  uint8_t count = report->sampleCount;
+  if (ch == 0 || count == 0 || count > FFB_CUSTOM_CHUNK_SAMPLES)
+    return;
+  uint16_t &next = core0_custom_next_seq[ch - 1];
+  if (report->sequence != next)
+    return;
+  // packed 構造体のメンバのアドレスは取らず、境界は static_assert で保証する
+  const int16_t *samples = reinterpret_cast<const int16_t *>(
+      (const uint8_t *)report +
+      offsetof(USB_FFB_Report_CustomForceData_t, samples));
+  if (custom_channels[ch - 1].samples.pushBulk(samples, count))
+    next++;
+}
+
+static void
+pid_handle_effect_operation(const USB_FFB_Report_EffectOperation_t *report) {
+  uint8_t idx = report->effectBlockIndex - 1;
+  if (idx < MAX_EFFECTS) {
+    // Solo: 他の全エフェクトを止めてから開始する
+    if (report->operation == HID_OP_SOLO)
+      core0_stop_all();
+    if (report->operation == HID_OP_START ||
+        report->operation == HID_OP_SOLO) {
+      core0_ffb_effects[idx].active = true;
+      core0_ffb_effects[idx].loopCount = report->loopCount;
+      core0_ffb_effects[idx].startCount++;
+      core0_start_epoch[idx] = core0_control.stop_epoch;
     }
-    break;
+    if (report->operation == HID_OP_STOP)
+      core0_ffb_effects[idx].active = false;
+    core0_mark_dirty(idx);
+  }
+  _pid_debug.operation = report->operation;
+  _pid_debug.effectBlockIndex = report->effectBlockIndex;
+  _pid_debug.updated = true;
+}
+
+/**
+ * @brief 割り当てたブロックの初期化 (Create New Effect の後半, 受信キュー経由)
+ */
+static void pid_handle_block_created(const pid_block_created_t *report) {
+  uint8_t idx = report->effectBlockIndex - 1;
+  if (!core0_block_pool.commit(idx))
+    return;
+  custom_channel_release(idx);
+  // 以前の内容を残さない (再生中なら Core1 側でも停止する)
+  core0_ffb_effects[idx] = FFB_Shared_State_t();
+  core0_ffb_effects[idx].type = report->request.effectType;
+  core0_mark_dirty(idx);
+  _pid_debug.effectBlockIndex = report->effectBlockIndex;
+  _pid_debug.updated = true;
+}
+
+static void pid_handle_block_free(const USB_FFB_Report_BlockFree_t *report) {
+  uint8_t idx = report->effectBlockIndex - 1;
+  if (idx < MAX_EFFECTS) {
+    // 割当て外のブロック (Create を使わないホスト) も停止・初期化はする
+    core0_block_pool.release(idx);
+    custom_channel_release(idx);
+    core0_ffb_effects[idx] = FFB_Shared_State_t();
+    core0_mark_dirty(idx);
   }
+  _pid_debug.effectBlockIndex = report->effectBlockIndex;
+  _pid_debug.updated = true;
+}
 
-  case 0x0D: { // Device Gain Report
-    if (bufsize >= sizeof(USB_FFB_Report_DeviceGain_t)) {
-      USB_FFB_Report_DeviceGain_t *report =
-          (USB_FFB_Report_DeviceGain_t *)buffer;
-      core0_global_gain = report->deviceGain;
-      _pid_debug.deviceGain = core0_global_gain;
-      _pid_debug.updated = true;
+static void
+pid_handle_device_control(const USB_FFB_Report_DeviceControl_t *report) {
+  switch (report->control) {
+  case HID_DC_ENABLE_ACTUATORS:
+    core0_control.actuators_enabled = true;
+    break;
+  case HID_DC_DISABLE_ACTUATORS:
+    core0_control.actuators_enabled = false;
+    break;
+  case HID_DC_STOP_ALL_EFFECTS:
+    core0_stop_all();
+    break;
+  case HID_DC_DEVICE_RESET: {
+    // 全停止し、全ブロックを解放する (パラメータは再確保時に初期化される)
+    core0_stop_all();
+    ffb_slot_mask_t used = core0_block_pool.usedMask();
+    while (used != 0) {
+      core0_block_pool.release((uint8_t)__builtin_ctzll(used));
+      used &= used - 1;
     }
+    for (uint8_t ch = 0; ch < FFB_CUSTOM_CHANNELS; ch++)
+      if (core0_custom_owner[ch] != 0)
+        custom_channel_release(core0_custom_owner[ch] - 1);
+    core0_control.actuators_enabled = true;
+    core0_control.paused = false;
     break;
   }
-
-  default:
-    // 他のIDは現状無視
+  case HID_DC_DEVICE_PAUSE:
+    core0_control.paused = true;
+    break;
+  case HID_DC_DEVICE_CONTINUE:
+    core0_control.paused = false;
     break;
+  default:
+    return;
   }
+  core0_control_generation++;
+  _pid_debug.operation = report->control;
+  _pid_debug.updated = true;
+}
+
+static void pid_handle_device_gain(const USB_FFB_Report_DeviceGain_t *report) {
+  core0_global_gain = report->deviceGain;
+  core0_gain_generation++;
+  _pid_debug.deviceGain = core0_global_gain;
+  _pid_debug.updated = true;
+}
+
+// --- Report ID -> ハンドラの振り分け表 (コンパイル時生成) ---
+typedef struct {
+  void (*handler)(uint8_t const *report); ///< NULL: 未対応 (無視)
+  uint16_t min_len;                       ///< 必要なペイロード長 (ID除く)
+} pid_dispatch_entry_t;
+
+// 構造体型 R を受け取るハンドラを、バイト列を受け取る共通形式へ変換する
+template <typename R, void (*Handler)(const R *)>
+static void pid_invoke(uint8_t const *report) {
+  Handler(reinterpret_cast<const R *>(report));
+}
+
+template <typename R, void (*Handler)(const R *)>
+static constexpr pid_dispatch_entry_t pid_entry() {
+  return {&pid_invoke<R, Handler>, (uint16_t)(sizeof(R) - 1)};
+}
+
+static constexpr std::array<pid_dispatch_entry_t, PID_DISPATCH_TABLE_SIZE>
+pid_make_dispatch_table() {
+  std::array<pid_dispatch_entry_t, PID_DISPATCH_TABLE_SIZE> table{};
+  table[HID_ID_SET_EFFECT] =
+      pid_entry<USB_FFB_Report_SetEffect_t, pid_handle_set_effect>();
+  table[HID_ID_SET_ENVELOPE] =
+      pid_entry<USB_FFB_Report_SetEnvelope_t, pid_handle_set_envelope>();
+  table[HID_ID_SET_CONDITION] =
+      pid_entry<USB_FFB_Report_SetCondition_t, pid_handle_set_condition>();
+  table[HID_ID_SET_PERIODIC] =
+      pid_entry<USB_FFB_Report_SetPeriodic_t, pid_handle_set_periodic>();
+  table[HID_ID_SET_CONSTANT_FORCE] =
+      pid_entry<USB_FFB_Report_SetConstantForce_t,
+                pid_handle_set_constant_force>();
+  table[HID_ID_SET_RAMP_FORCE] =
+      pid_entry<USB_FFB_Report_SetRampForce_t, pid_handle_set_ramp_force>();
+  table[HID_ID_SET_CUSTOM_FORCE] =
+      pid_entry<USB_FFB_Report_SetCustomForce_t,
+                pid_handle_set_custom_force>();
+  table[HID_ID_VENDOR_FFB] =
+      pid_entry<USB_FFB_Report_CustomForceData_t,
+                pid_handle_custom_force_data>();
+  table[HID_ID_EFFECT_OPERATION] =
+      pid_entry<USB_FFB_Report_EffectOperation_t,
+                pid_handle_effect_operation>();
+  table[HID_ID_DEVICE_GAIN] =
+      pid_entry<USB_FFB_Report_DeviceGain_t, pid_handle_device_gain>();
+  table[HID_ID_DEVICE_CONTROL] =
+      pid_entry<USB_FFB_Report_DeviceControl_t, pid_handle_device_control>();
+  table[HID_ID_BLOCK_FREE] =
+      pid_entry<USB_FFB_Report_BlockFree_t, pid_handle_block_free>();
+  // Create New Effect は USB コールバックが付加した割当て結果を処理する
+  table[HID_ID_CREATE_NEW_EFFECT] =
+      pid_entry<pid_block_created_t, pid_handle_block_created>();
+  return table;
+}
+
+static constexpr std::array<pid_dispatch_entry_t, PID_DISPATCH_TABLE_SIZE>
+    pid_dispatch_table = pid_make_dispatch_table();
+
+/**
+ * @brief PID レポートをハンドラへ振り分ける (コピー無し)
+ * @param report_id Report ID
+ * @param payload Report ID を除くペイロード。payload[-1] が report_id
+ * であること (受信キュー要素および PID_ParseReport はこれを満たす)
+ * @param len ペイロード長
+ */
+void PID_DispatchReport(uint8_t report_id, uint8_t const *payload,
+                        uint16_t len) {
+  if (payload == NULL)
+    return;
+
+  _pid_debug.lastReportId = report_id;
+
+  // 他のIDおよび長さ不足のレポートは現状無視
+  if (report_id >= PID_DISPATCH_TABLE_SIZE)
+    return;
+  const pid_dispatch_entry_t &entry = pid_dispatch_table[report_id];
+  if (entry.handler == NULL || len < entry.min_len)
+    return;
+
+  entry.handler(payload - 1);
+}
+
+void PID_ParseReport(uint8_t const *buffer, uint16_t bufsize) {
+  if (buffer == NULL || bufsize == 0)
+    return;
+
+  // buffer[0] が Report ID
+  PID_DispatchReport(buffer[0], &buffer[1], bufsize - 1);
 }
 
 bool hidwffb_get_pid_debug_info(pid_debug_info_t *info) {
@@ -243,52 +1011,190 @@ bool hidwffb_get_pid_debug_info(pid_debug_info_t *info) {
 /*
 双方向アクセスロジック
 Core 0 と Core 1 がお互いのデータを「安全に、かつ迅速に」読み書きするための関数
+各方向とも単一ライタ/単一リーダのため、ミューテックスではなく TripleBuffer
+で受け渡す。どちらのコアも相手を待たず、読込が失敗して更新を取りこぼす
+こともない。
 */
-FFB_Shared_State_t shared_ffb_effects[MAX_EFFECTS];
-volatile uint8_t shared_global_gain = 255;
-custom_gamepad_report_t shared_input_report;
-mutex_t ffb_shared_mutex;
+// Core 0 -> Core 1 (FFB命令一式)
+// 更新されたスロットのみを受け渡すため、スロットごとに世代番号を持つ
+typedef struct {
+  FFB_Shared_State_t effects[MAX_EFFECTS];
+  uint32_t slot_generation[MAX_EFFECTS]; ///< スロットの内容の世代
+  uint8_t global_gain;
+  uint32_t gain_generation; ///< 全体ゲイン更新ごとに加算
+  ffb_device_control_t control;
+  uint32_t control_generation; ///< Device Control 更新ごとに加算
+#ifdef LATENCY_PROBE_ENABLE
+  bool has_rx_stamp;   ///< rx_us が有効 (PID 受信による更新)
+  uint32_t rx_us;      ///< 最も古い未反映レポートの受信時刻
+  uint32_t publish_us; ///< 共有メモリへ反映した時刻
+#endif
+} ffb_shared_command_t;
+
+static TripleBuffer<ffb_shared_command_t> shared_ffb_command;
+// Core 1 -> Core 0 (物理入力)
+typedef struct {
+  custom_gamepad_report_t report;
+#ifdef LATENCY_PROBE_ENABLE
+  uint32_t written_us; ///< Core1 が書き込んだ時刻
+#endif
+} ffb_shared_input_t;
+
+static TripleBuffer<ffb_shared_input_t> shared_input_report;
+
+static inline void shared_input_write(const custom_gamepad_report_t &input) {
+  ffb_shared_input_t *dest = shared_input_report.beginWrite();
+  dest->report = input;
+#ifdef LATENCY_PROBE_ENABLE
+  dest->written_us = LATENCY_STAMP();
+#endif
+  shared_input_report.endWrite();
+}
+
+// Core 0 側: 共有メモリへ最後に反映した状態
+static bool core0_published_cool_back = false;
+static uint32_t core0_published_gain_generation = 0;
+static uint32_t core0_published_control_generation = 0;
+// スロットごとの最新の世代 (更新ごとに加算)。書込先のバッファは 2 回前以前の
+// 内容のため、世代が異なるスロットをすべて書き込む
+static uint32_t core0_slot_generation[MAX_EFFECTS];
+
+// Core 1 側: 最後に受け取った状態
+static uint8_t core1_global_gain = 255;
+static uint32_t core1_seen_sequence = 0;
+static uint32_t core1_slot_generation[MAX_EFFECTS];
+static uint32_t core1_gain_generation = 0;
+static ffb_device_control_t core1_control = {0, true, false};
+static uint32_t core1_control_generation = 0;
 
 // --- Core間通信用構造体の初期化 ---
-void ffb_shared_memory_init() { mutex_init(&ffb_shared_mutex); }
+void ffb_shared_memory_init() {
+  // 初回の同期で全スロットを Core 1 へ渡す
+  core0_dirty_mask = FFB_SLOT_MASK_ALL;
+  core0_gain_generation++;
+  core0_control_generation++;
+
+  custom_gamepad_report_t empty_report = {0, 0, 0, 0};
+  shared_input_write(empty_report);
+}
 
 // --- Core 0 側: パース結果を共有メモリへ反映 ---
 void ffb_core0_update_shared(pid_debug_info_t *info) {
-  if (mutex_enter_timeout_ms(&ffb_shared_mutex, 1)) {
-    for (int i = 0; i < MAX_EFFECTS; i++) {
-      shared_ffb_effects[i] = core0_ffb_effects[i];
-      // Core0 側でタイマー管理しているフラグを共有メモリに反映
-      if (info != NULL) {
-        shared_ffb_effects[i].isCoolBackTest =
-            info->updated; // 暫定：後ほど main.cpp で管理
-      }
+  // Core0 側でタイマー管理しているフラグ。変化時は全スロットへ反映する
+  bool cool_back = (info != NULL) ? info->updated // 暫定：後ほど main.cpp で管理
+                                  : core0_published_cool_back;
+  if (cool_back != core0_published_cool_back) {
+    core0_dirty_mask = FFB_SLOT_MASK_ALL;
+    core0_published_cool_back = cool_back;
+  }
+
+  // PID 受信が無い周期は共有メモリに触れない
+  if (core0_dirty_mask == 0 &&
+      core0_gain_generation == core0_published_gain_generation &&
+      core0_control_generation == core0_published_control_generation)
+    return;
+
+  // ライタは待たないため、更新が捨てられることはない
+  ffb_slot_mask_t dirty = core0_dirty_mask;
+  while (dirty != 0) {
+    uint8_t i = (uint8_t)__builtin_ctzll(dirty);
+    dirty &= dirty - 1;
+    // 最後の Start より後に全停止したスロットは停止として渡す
+    if (core0_start_epoch[i] != core0_control.stop_epoch)
+      core0_ffb_effects[i].active = false;
+    core0_ffb_effects[i].isCoolBackTest = cool_back;
+    core0_slot_generation[i]++;
+  }
+  ffb_shared_command_t *cmd = shared_ffb_command.beginWrite();
+  for (uint8_t i = 0; i < MAX_EFFECTS; i++) {
+    if (cmd->slot_generation[i] != core0_slot_generation[i]) {
+      cmd->effects[i] = core0_ffb_effects[i];
+      cmd->slot_generation[i] = core0_slot_generation[i];
     }
-    shared_global_gain = core0_global_gain;
-    mutex_exit(&ffb_shared_mutex);
   }
+  cmd->global_gain = core0_global_gain;
+  cmd->gain_generation = core0_gain_generation;
+  cmd->control = core0_control;
+  cmd->control_generation = core0_control_generation;
+#ifdef LATENCY_PROBE_ENABLE
+  cmd->publish_us = LATENCY_STAMP();
+  cmd->has_rx_stamp = core0_pending_stamped;
+  cmd->rx_us = core0_pending_rx_us;
+  if (core0_pending_stamped) {
+    LATENCY_RECORD(LAT_DISPATCH_TO_PUBLISH, core0_pending_dispatch_us);
+    core0_pending_stamped = false;
+  }
+#endif
+  shared_ffb_command.endWrite();
+
+  core0_dirty_mask = 0;
+  core0_published_gain_generation = core0_gain_generation;
+  core0_published_control_generation = core0_control_generation;
 }
 
-// --- Core 1 側:
-// 物理入力を書き込み、FFB命令を読み出す。テスト時はループバックを実施 ---
-// --- Core 1 側: 物理入力(エンコーダ/ペダル)を書き込み、FFB命令を読み出す ---
-void ffb_core1_update_shared(custom_gamepad_report_t *new_input,
-                             FFB_Shared_State_t *local_effects_dest) {
-  if (mutex_enter_timeout_ms(&ffb_shared_mutex, 1)) {
-    // 1. Core 1 の結果を Core 0 へ渡す (物理入力)
-    shared_input_report = *new_input;
-
-    // 2. Core 0 の命令を Core 1 へ持ってくる (FFB命令)
-    for (int i = 0; i < MAX_EFFECTS; i++) {
-      local_effects_dest[i] = shared_ffb_effects[i];
+// --- Core 1 側: Core 0 の命令を Core 1 へ持ってくる (FFB命令) ---
+static ffb_slot_mask_t
+core1_receive_command(FFB_Shared_State_t *local_effects_dest) {
+  // 公開回数が変わっていなければ何もしない
+  if (shared_ffb_command.sequence() == core1_seen_sequence)
+    return 0;
+
+  // 最新のバッファを直接参照し、世代番号が変化したスロットのみを反映する
+  // (参照中のバッファへ Core0 は書き込まないため、一時領域は不要)
+  uint32_t seq;
+  const ffb_shared_command_t *cmd = shared_ffb_command.read(&seq);
+  ffb_slot_mask_t changed = 0;
+  for (int i = 0; i < MAX_EFFECTS; i++) {
+    uint32_t gen = cmd->slot_generation[i];
+    if (gen != core1_slot_generation[i]) {
+      local_effects_dest[i] = cmd->effects[i];
+      core1_slot_generation[i] = gen;
+      changed |= (ffb_slot_mask_t)1 << i;
     }
-    mutex_exit(&ffb_shared_mutex);
   }
+  if (cmd->gain_generation != core1_gain_generation) {
+    core1_global_gain = cmd->global_gain;
+    core1_gain_generation = cmd->gain_generation;
+  }
+  if (cmd->control_generation != core1_control_generation) {
+    core1_control = cmd->control;
+    core1_control_generation = cmd->control_generation;
+  }
+#ifdef LATENCY_PROBE_ENABLE
+  LATENCY_RECORD(LAT_PUBLISH_TO_CORE1, cmd->publish_us);
+  if (cmd->has_rx_stamp)
+    LATENCY_RECORD(LAT_USB_TO_CORE1, cmd->rx_us);
+#endif
+  core1_seen_sequence = seq;
+  return changed;
+}
+
+// --- Core 1 側: 物理入力(エンコーダ/ペダル)を書き込み、FFB命令を読み出す ---
+ffb_slot_mask_t
+ffb_core1_update_shared(custom_gamepad_report_t *new_input,
+                        FFB_Shared_State_t *local_effects_dest) {
+  shared_input_write(*new_input);
+  return core1_receive_command(local_effects_dest);
+}
+
+uint8_t ffb_core1_device_gain(void) { return core1_global_gain; }
+
+ffb_custom_channel_t *ffb_custom_channel(uint8_t channel) {
+  if (channel == 0 || channel > FFB_CUSTOM_CHANNELS)
+    return NULL;
+  return &custom_channels[channel - 1];
+}
+
+const ffb_device_control_t &ffb_core1_device_control(void) {
+  return core1_control;
 }
 
-void hidwffb_loopback_test_sync(custom_gamepad_report_t *new_input,
-                                FFB_Shared_State_t *local_effects_dest) {
+ffb_slot_mask_t
+hidwffb_loopback_test_sync(custom_gamepad_report_t *new_input,
+                           FFB_Shared_State_t *local_effects_dest) {
   // 1. まず Core 0 から最新の命令を受け取る
-  ffb_core1_update_shared(new_input, local_effects_dest);
+  // (入力は上書き後に1回だけ公開し、上書き前の値を Core0 に見せない)
+  ffb_slot_mask_t changed = core1_receive_command(local_effects_dest);
 
 #ifdef CALLBACK_TEST_ENABLE
   // 2. 受け取った命令に基づいて入力を捏造する (ループバック)
@@ -296,16 +1202,14 @@ void hidwffb_loopback_test_sync(custom_gamepad_report_t *new_input,
   if (local_effects_dest[0].isCoolBackTest) {
     new_input->steer = local_effects_dest[0].magnitude;
     new_input->accel = local_effects_dest[0].gain;
-    new_input->brake = (int16_t)shared_global_gain; // uint8_t -> int16_t
+    new_input->brake = (int16_t)core1_global_gain; // uint8_t -> int16_t
   } else {
-    // 通常時（またはテスト無効時）
+    // 通常時（またはテスト無効時）。accel/brake は物理入力 (ペダル) のまま
     if (local_effects_dest[0].active) {
       new_input->steer = local_effects_dest[0].magnitude;
     } else {
       new_input->steer = 0;
     }
-    new_input->accel = 0;
-    new_input->brake = 0;
   }
 
   // デバッグ用
@@ -313,26 +1217,27 @@ void hidwffb_loopback_test_sync(custom_gamepad_report_t *new_input,
   static bool last_cool = false;
   if (local_effects_dest[0].magnitude != last_mag ||
       local_effects_dest[0].isCoolBackTest != last_cool) {
-    Serial.print("[CORE1_DEBUG] Mag:");
-    Serial.print(local_effects_dest[0].magnitude);
-    Serial.print(", CoolBack:");
-    Serial.println(local_effects_dest[0].isCoolBackTest);
+    // Core1 はシリアルへ書き込まず、自コアのテレメトリリングへ積む
+    tlm_core1_debug_t tlm = {local_effects_dest[0].magnitude,
+                             (uint8_t)local_effects_dest[0].isCoolBackTest};
+    telemetry_emit(TLM_CORE1, TLM_TYPE_CORE1_DEBUG, &tlm, sizeof(tlm));
     last_mag = local_effects_dest[0].magnitude;
     last_cool = local_effects_dest[0].isCoolBackTest;
   }
 #endif
 
   // 3. 捏造した(または実際の)入力を Core 0 へ戻す
-  if (mutex_enter_timeout_ms(&ffb_shared_mutex, 1)) {
-    shared_input_report = *new_input;
-    mutex_exit(&ffb_shared_mutex);
-  }
+  shared_input_write(*new_input);
+  return changed;
 }
 
 // --- Core 0 側: パース結果を書き込み、HID送信用の入力を読み出す ---
 void ffb_core0_get_input_report(custom_gamepad_report_t *dest) {
-  if (mutex_enter_timeout_ms(&ffb_shared_mutex, 1)) {
-    *dest = shared_input_report;
-    mutex_exit(&ffb_shared_mutex);
-  }
-}
\ No newline at end of file
+  // 読込は失敗しないため、常に Core1 が最後に公開した値を返す
+  const ffb_shared_input_t *snapshot = shared_input_report.read();
+  *dest = snapshot->report;
+#ifdef LATENCY_PROBE_ENABLE
+  core0_input_written_us = snapshot->written_us;
+  core0_input_pending = true;
+#endif
+}
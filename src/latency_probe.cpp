@@ -0,0 +1,94 @@
+/**
+ * @file latency_probe.cpp
+ * @brief ホットパスの遅延計測の実装 (LATENCY_PROBE_ENABLE 時のみ生成)
+ */
+
+#include "latency_probe.h"
+
+#ifdef LATENCY_PROBE_ENABLE
+
+#include "seqlock.h"
+#include "telemetry.h"
+#include <stddef.h>
+
+// 計測点ごとのヒストグラム (単一ライタ/任意コアのリーダ)
+static SeqLock<latency_hist_t> latency_hist[LAT_PROBE_COUNT];
+
+static const char *const latency_names[LAT_PROBE_COUNT] = {
+    "rx_to_dispatch",   "dispatch_to_publish", "publish_to_core1",
+    "usb_to_core1",     "sensor_to_host",      "loop0_body",
+    "loop1_body"};
+
+/// @brief 所要時間 -> バケット番号 (floor(log2(us)) + 1, 上限あり)
+static inline uint8_t latency_bucket(uint32_t us) {
+  if (us == 0)
+    return 0;
+  uint8_t k = (uint8_t)(32 - __builtin_clz(us));
+  return (k < LATENCY_HIST_BUCKETS) ? k : LATENCY_HIST_BUCKETS - 1;
+}
+
+void latency_record(latency_probe_t probe, uint32_t elapsed_us,
+                    uint32_t budget_us) {
+  if (probe >= LAT_PROBE_COUNT)
+    return;
+  // 書込側は1コアのみのため、共有領域を直接更新する
+  latency_hist_t *hist = latency_hist[probe].beginWrite();
+  hist->count++;
+  hist->bucket[latency_bucket(elapsed_us)]++;
+  if (elapsed_us > hist->max_us)
+    hist->max_us = elapsed_us;
+  if (budget_us != 0 && elapsed_us > budget_us)
+    hist->over_budget++;
+  latency_hist[probe].endWrite();
+}
+
+bool latency_get_hist(latency_probe_t probe, latency_hist_t *dest) {
+  if (probe >= LAT_PROBE_COUNT || dest == NULL)
+    return false;
+  latency_hist_t snapshot;
+  if (!latency_hist[probe].tryRead(snapshot))
+    return false;
+  *dest = snapshot;
+  return true;
+}
+
+const char *latency_probe_name(latency_probe_t probe) {
+  return (probe < LAT_PROBE_COUNT) ? latency_names[probe] : "?";
+}
+
+uint32_t latency_percentile_us(const latency_hist_t *hist, uint16_t permille) {
+  if (hist->count == 0)
+    return 0;
+  uint64_t target = ((uint64_t)hist->count * permille + 999) / 1000;
+  uint64_t seen = 0;
+  for (uint8_t k = 0; k < LATENCY_HIST_BUCKETS - 1; k++) {
+    seen += hist->bucket[k];
+    if (seen >= target && seen > 0)
+      return (k == 0) ? 0 : ((uint32_t)1 << k) - 1;
+  }
+  return hist->max_us;
+}
+
+void latency_report_step(bool start) {
+  static uint8_t next = LAT_PROBE_COUNT; // LAT_PROBE_COUNT: 出力無し
+  if (start)
+    next = 0;
+  if (next >= LAT_PROBE_COUNT)
+    return;
+
+  latency_probe_t probe = (latency_probe_t)next++;
+  latency_hist_t hist;
+  if (!latency_get_hist(probe, &hist))
+    return; // 書込と競合した計測点は今回の出力を省略する
+
+  // 表示形式は tools/python/telemetry.py で [LAT] 行に変換する
+  tlm_latency_t tlm = {(uint8_t)probe,
+                       hist.count,
+                       hist.max_us,
+                       latency_percentile_us(&hist, 500),
+                       latency_percentile_us(&hist, 990),
+                       hist.over_budget};
+  telemetry_emit(TLM_CORE0, TLM_TYPE_LATENCY, &tlm, sizeof(tlm));
+}
+
+#endif // LATENCY_PROBE_ENABLE
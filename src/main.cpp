@@ -3,14 +3,25 @@
  * @brief RP2040 ゲームコントローラ (FFB対応) メインプログラム
  *
  * Core0: USB通信、入力読み取り、HID送信
- * Core1: FFB演算、モータドライバ制御 (将来追加)
+ * Core1: FFB演算、モータドライバ制御 (PWM)
  */
 
+#include "axis_observer.h"
+#include "button_debounce.h"
+#include "button_input.h"
+#include "ffb_engine.h"
+#include "fixed_filter.h"
 #include "hidwffb.h"
+#include "latency_probe.h"
+#include "pedal_adc.h"
+#include "serial_command.h"
+#include "sof_phase_lock.h"
+#include "steer_sensor_spi.h"
+#include "telemetry.h"
+#include "torque_output_pwm.h"
 #include "util.h"
 #include <Adafruit_TinyUSB.h>
 #include <Arduino.h>
-#include <SPI.h>
 
 // --- ピン定義 ---
 #define PIN_ACCEL 26      // A0 (GP26)
@@ -18,22 +29,94 @@
 #define PIN_SHIFT_UP 25   // GP25
 #define PIN_SHIFT_DOWN 24 // GP24
 #define PIN_SPI_CS 17     // SPI CS (操舵軸センサ用)
+#define PIN_SPI_RX 16     // SPI0 RX (MISO)
+#define PIN_SPI_SCK 18    // SPI0 SCK
+#define PIN_SPI_TX 19     // SPI0 TX (MOSI)
+#define PIN_MOTOR_PWM 14  // モータドライバ PWM
+#define PIN_MOTOR_DIR 15  // モータドライバ 方向
 
 // --- デバッグ設定 ---
 // 原則、platformio.iniで定義する
 // #define HID_INPUT_DEBUG_ENABLE ///< HID入力データをシリアル出力する
+// #define LATENCY_PROBE_ENABLE   ///< 遅延ヒストグラムを集計・定期出力する
+// #define SOF_SYNC_ENABLE        ///< 各コアの周期を USB SOF に位相同期する
+// #define HIRES_INPUT_ENABLE     ///< Core1 の入力を周期ごとに別途送信する
+
+#ifdef HIRES_INPUT_ENABLE
+const bool HIRES_INPUT = true; ///< 高分解能入力 (解析ツール向け) を送る
+#else
+const bool HIRES_INPUT = false;
+#endif
 
 // --- 周期管理 ---
-const uint32_t LOOP_INTERVAL_MS = 1;    ///< 1000Hz周期
-const uint32_t LOOP_INTERVAL_LOOP1 = 1; ///< 1000Hz周期
+// Core0 (USB) と Core1 (FFB演算) の周期は独立に設定できる。
+// 周期超過時は遅れた周期を破棄し、最新の状態で次の周期境界から再開する。
+const uint32_t LOOP_INTERVAL_MS = 1;  ///< USB ポーリング周期 (1000Hz)
+const uint32_t LOOP_PERIOD_US = 1000; ///< Core0 1000Hz周期
+const uint32_t LOOP1_PERIOD_US = 250; ///< Core1 4000Hz周期
 
-IntervalTrigger_m loop_trigger(LOOP_INTERVAL_MS);     ///< Core0 1000Hz周期
-IntervalTrigger_m loop1_trigger(LOOP_INTERVAL_LOOP1); ///< Core1 1000Hz周期
+PeriodicTrigger_u loop_trigger(LOOP_PERIOD_US, SCHED_SKIP);   ///< Core0
+PeriodicTrigger_u loop1_trigger(LOOP1_PERIOD_US, SCHED_SKIP); ///< Core1
+
+#ifdef SOF_SYNC_ENABLE
+// Core0 は SOF の直前に入力を取得・送信し、次フレームの IN で読み出させる。
+// Core1 はその 100us 前に入力を更新する (Core1 の周期を法として同期)。
+const uint32_t SOF_LEAD_US = 200;       ///< Core0: SOF の 200us 前に実行
+const uint32_t SOF_LEAD_LOOP1_US = 300; ///< Core1: SOF の 300us 前に実行
+SofPhaseLock sof_lock(LOOP_PERIOD_US, SOF_LEAD_US);        ///< Core0
+SofPhaseLock sof_lock1(LOOP1_PERIOD_US, SOF_LEAD_LOOP1_US); ///< Core1
+uint32_t input_sample_us = 0; ///< Core0 が送信する入力を取得した時刻
+IntervalTrigger_m sof_report_trigger(5000);  ///< Core0 同期統計の出力周期
+IntervalTrigger_m sof_report_trigger1(5000); ///< Core1 同期統計の出力周期
+
+/// @brief SOF を観測していれば周期実行の位相を補正する
+static void sof_sync_step(SofPhaseLock &lock, PeriodicTrigger_u &trigger,
+                          uint32_t &sof_seen, uint32_t sample_us) {
+  uint32_t sof_us;
+  if (hidwffb_poll_sof(&sof_seen, &sof_us))
+    trigger.shiftPhase(lock.update(sof_us, trigger.lastDeadline(), sample_us));
+}
+
+/// @brief 位相同期の統計をテレメトリへ積む (各コアから自コアの分を呼ぶ)
+static void sof_report(tlm_core_t core, const SofPhaseLock &lock) {
+  const sof_lock_stats_t &stats = lock.stats();
+  uint32_t age_mean_us = (stats.locked_count > 0)
+                             ? (uint32_t)(stats.age_sum_us / stats.locked_count)
+                             : 0;
+  tlm_sof_lock_t tlm = {(uint8_t)lock.locked(),
+                        (int16_t)stats.phase_err_us,
+                        (uint16_t)stats.phase_err_max,
+                        stats.sof_count,
+                        stats.locked_count,
+                        (uint16_t)age_mean_us,
+                        (uint16_t)stats.age_max_us};
+  telemetry_emit(core, TLM_TYPE_SOF_LOCK, &tlm, sizeof(tlm));
+}
+#endif
 
 // --- タイマー管理 ---
 OneShotTrigger_m cool_back_test_timer(5000); ///< 5秒のワンショットタイマー
 #ifdef HID_INPUT_DEBUG_ENABLE
 OneShotTrigger_m dummy_override_timer(5000); ///< ダミーデータ用5秒タイマー
+SerialCommandParser serial_parser;           ///< HID 入力注入コマンド
+#endif
+#ifdef LATENCY_PROBE_ENABLE
+IntervalTrigger_m latency_report_trigger(5000); ///< 遅延計測結果の出力周期
+IntervalTrigger_m sched_report_trigger1(5000);  ///< Core1 周期統計の出力周期
+
+/// @brief 周期実行の統計をテレメトリへ積む (各コアから自コアの分を呼ぶ)
+static void sched_report(tlm_core_t core, const PeriodicTrigger_u &trigger) {
+  const sched_stats_t &stats = trigger.stats();
+  uint32_t late_mean_us =
+      (stats.runs > 0) ? (uint32_t)(stats.late_sum_us / stats.runs) : 0;
+  tlm_sched_t tlm = {(uint16_t)trigger.getPeriod(),
+                     stats.runs,
+                     stats.overruns,
+                     stats.skipped,
+                     stats.late_max_us,
+                     late_mean_us};
+  telemetry_emit(core, TLM_TYPE_SCHED, &tlm, sizeof(tlm));
+}
 #endif
 
 // --- FFBデータ共有用 (Core0 <-> Core1) ---
@@ -42,19 +125,12 @@ uint8_t current_ffb_buf[HID_FFB_REPORT_SIZE];
 void setup() {
   Serial.begin(115200);
 
-  // I/O初期化
-  pinMode(PIN_ACCEL, INPUT);
-  pinMode(PIN_BRAKE, INPUT);
-  pinMode(PIN_SHIFT_UP, INPUT_PULLUP);
-  pinMode(PIN_SHIFT_DOWN, INPUT_PULLUP);
-  pinMode(PIN_SPI_CS, OUTPUT);
-  digitalWrite(PIN_SPI_CS, HIGH);
-
-  // SPI初期化 (操舵軸センサ用)
-  SPI.begin();
+  // I/O初期化 (ペダル・ボタンは Core1 の pedal_adc_begin() /
+  // button_input_begin() で設定)
+  // SPI (操舵軸センサ用) は Core1 の steer_sensor.begin() で初期化する
 
   // HIDモジュールの初期化 (1msポーリング)
-  hidwffb_begin(LOOP_INTERVAL_MS);
+  hidwffb_begin(LOOP_INTERVAL_MS, HIRES_INPUT);
 
   // USB接続待ち
   hidwffb_wait_for_mount();
@@ -62,32 +138,43 @@ void setup() {
   // 共有メモリ初期化
   ffb_shared_memory_init();
 
-  Serial.println("System Refactored: HID Gamepad Ready (Core0)");
+  telemetry_text(TLM_CORE0, "HID Gamepad Ready (Core0)");
   loop_trigger.init();
+#ifdef SOF_SYNC_ENABLE
+  hidwffb_sof_enable(true);
+  sof_report_trigger.init();
+#endif
+#ifdef LATENCY_PROBE_ENABLE
+  latency_report_trigger.init();
+#endif
 }
 
 void loop() {
-  // 1ms周期で実行 (util.h の IntervalTrigger_m を使用)
+#ifdef SOF_SYNC_ENABLE
+  static uint32_t sof_seen = 0;
+  sof_sync_step(sof_lock, loop_trigger, sof_seen, input_sample_us);
+#endif
+
+  // 1ms周期で実行 (util.h の PeriodicTrigger_u を使用)
   if (loop_trigger.hasExpired()) {
+    uint32_t loop_start_us = LATENCY_STAMP();
 
     if (hidwffb_ready()) {
 #ifdef HID_INPUT_DEBUG_ENABLE
       static custom_gamepad_report_t dummy_report = {0, 0, 0, 0};
 
-      // シリアル受信処理
-      if (Serial.available()) {
-        String line = Serial.readStringUntil('\n');
-        if (line.startsWith("HID:")) {
-          int s_idx = line.indexOf('S'), a_idx = line.indexOf(",A"),
-              b_idx = line.indexOf(",B"), btn_idx = line.indexOf(",BTN");
-          if (s_idx != -1 && a_idx != -1 && b_idx != -1 && btn_idx != -1) {
-            dummy_report.steer = line.substring(s_idx + 1, a_idx).toInt();
-            dummy_report.accel = line.substring(a_idx + 2, b_idx).toInt();
-            dummy_report.brake = line.substring(b_idx + 2, btn_idx).toInt();
-            dummy_report.buttons = line.substring(btn_idx + 4).toInt();
-            dummy_override_timer.start();
-            Serial.println("[HID_DEBUG] Dummy Data Serial Received");
-          }
+      // シリアル受信処理 (受信済みの分だけを1バイトずつ処理し、待たない)
+      for (uint16_t n = 0;
+           n < SERIAL_CMD_BYTES_PER_LOOP && Serial.available() > 0; n++) {
+        serial_cmd_result_t result =
+            serial_parser.feed((uint8_t)Serial.read());
+        if (result == SERIAL_CMD_HID_INPUT_TEXT ||
+            result == SERIAL_CMD_HID_INPUT_BINARY) {
+          dummy_report = serial_parser.input();
+          dummy_override_timer.start();
+          // バイナリは 1kHz で届くため、受信通知はテキスト時のみ
+          if (result == SERIAL_CMD_HID_INPUT_TEXT)
+            telemetry_text(TLM_CORE0, "[HID_DEBUG] Dummy Data Received");
         }
       }
 
@@ -109,6 +196,9 @@ void loop() {
 #endif
     }
 
+    // --- 受信キューの Output Report を受信順に処理 ---
+    hidwffb_process_reports(HID_RX_QUEUE_DEPTH);
+
     // --- FFBデータ更新チェックおよび共有 ---
     if (hidwffb_get_ffb_data(current_ffb_buf)) {
       // 受信データを検知したらタイマーを5秒にセット
@@ -125,29 +215,21 @@ void loop() {
     pid_debug_info_t pid_info;
     if (hidwffb_get_pid_debug_info(&pid_info)) {
 #ifdef PID_DEBUG_ENABLE
-      if (pid_info.lastReportId == 0x01) {
-        Serial.print("[PID_DEBUG] ID:0x01, Type:");
-        Serial.print(pid_info.isConstantForce ? "Constant" : "Unknown");
-        Serial.print(", Mag:");
-        Serial.print(pid_info.magnitude);
-        Serial.print(", Gain:");
-        Serial.println(pid_info.deviceGain);
-      } else if (pid_info.lastReportId == 0x05) {
-        Serial.print("[PID_DEBUG] ID:0x05, Mag:");
-        Serial.println(pid_info.magnitude);
-      } else if (pid_info.lastReportId == 0x0A) {
-        Serial.print("[PID_DEBUG] ID:0x0A, Op:");
-        Serial.println(pid_info.operation);
-      } else if (pid_info.lastReportId == 0x0D) {
-        Serial.print("[PID_DEBUG] ID:0x0D, DeviceGain:");
-        Serial.println(pid_info.deviceGain);
-      }
+      // シリアルへは直接書き込まず、テレメトリのリングへ積むだけにする
+      // (表示形式は tools/python/telemetry.py で従来の [PID_DEBUG] 行に変換)
+      tlm_pid_debug_t tlm = {pid_info.lastReportId,
+                             (uint8_t)pid_info.isConstantForce,
+                             pid_info.magnitude,
+                             pid_info.deviceGain,
+                             pid_info.operation,
+                             pid_info.effectBlockIndex};
+      telemetry_emit(TLM_CORE0, TLM_TYPE_PID_DEBUG, &tlm, sizeof(tlm));
 #endif
       pid_info.updated = is_cool_back_active; // 共有メモリへ渡すフラグ
       ffb_core0_update_shared(&pid_info);
     } else {
       // PID受信がなくても定期的に共有メモリを更新（タイマー切れ反映のため）
-      pid_debug_info_t empty_info = {0};
+      pid_debug_info_t empty_info = {};
       empty_info.updated = is_cool_back_active;
       ffb_core0_update_shared(&empty_info);
     }
@@ -155,14 +237,109 @@ void loop() {
     // --- 共有メモリから入力を取得してHID送信 ---
     if (hidwffb_ready()) {
       custom_gamepad_report_t shared_report = {0, 0, 0, 0};
+#ifdef SOF_SYNC_ENABLE
+      input_sample_us = micros();
+#endif
       ffb_core0_get_input_report(&shared_report);
       hidwffb_send_report(&shared_report);
+      // Core1 の周期ごとのサンプル (4000Hz なら 4 個) を1フレームにまとめる
+      if (HIRES_INPUT)
+        hidwffb_send_hires_report();
     }
+
+    // --- 遅延計測 (結果は1周期に1計測点ずつ出力する) ---
+#ifdef LATENCY_PROBE_ENABLE
+    bool report_start = latency_report_trigger.hasExpired();
+    latency_report_step(report_start);
+    if (report_start)
+      sched_report(TLM_CORE0, loop_trigger);
+#endif
+#ifdef SOF_SYNC_ENABLE
+    if (sof_report_trigger.hasExpired())
+      sof_report(TLM_CORE0, sof_lock);
+#endif
+
+    // --- テレメトリ送信 (CDC の送信バッファに空きがある分だけ) ---
+    telemetry_drain(TLM_RING_DEPTH);
+    LATENCY_RECORD_BUDGET(LAT_LOOP0_BODY, loop_start_us, LOOP_PERIOD_US);
   }
 }
 
 // --- Core1: FFB演算およびモータ制御用 ---
 FFB_Shared_State_t core1_effects[MAX_EFFECTS];
+int16_t core1_torque = 0; ///< エフェクト合算後のトルク指令値
+
+// ペダルの校正値 (デシメーション後の 0..65520)
+// 実機では pedal_adc_read_raw() で離した/踏み切った状態の値を測って設定する
+const pedal_calibration_t ACCEL_CALIBRATION = {1024, 64496, 512, 512};
+const pedal_calibration_t BRAKE_CALIBRATION = {1024, 64496, 512, 512};
+
+// ボタン: ビット0 = シフトアップ, ビット1 = シフトダウン
+// Core1 の周期で全ピンを一括で読み取り、垂直カウンタでチャタリングを除く。
+// シフタは押下を最初のサンプルで確定し (次の USB フレームで送信)、
+// 解放のみ BUTTON_DEBOUNCE_US の連続を待つ
+const uint8_t BUTTON_PINS[] = {PIN_SHIFT_UP, PIN_SHIFT_DOWN};
+const uint32_t BUTTON_DEBOUNCE_US = 5000;  ///< 確定に必要な連続時間
+const uint16_t BUTTON_EAGER_MASK = 0x0003; ///< 押下を即時に確定するボタン
+ButtonDebouncer button_debouncer(LOOP1_PERIOD_US, BUTTON_DEBOUNCE_US,
+                                 BUTTON_EAGER_MASK);
+
+// 操舵軸センサ (SPI + DMA)。多回転の位置へ展開し、ロック間を steer へ割り当てる
+// 起動時のハンドル位置を中心 (steer = 0) とする
+const uint16_t STEER_LOCK_TO_LOCK_DEG = 900; ///< ロック間の回転角 [deg]
+SpiSteerSensor spi_steer_sensor(PIN_SPI_CS, PIN_SPI_SCK, PIN_SPI_TX,
+                                PIN_SPI_RX);
+SteerSensor &steer_sensor = spi_steer_sensor;
+EncoderUnwrapper steer_unwrapper(STEER_SPI_BITS);
+SteerMapper steer_mapper(1u << STEER_SPI_BITS, STEER_LOCK_TO_LOCK_DEG);
+bool steer_centered = false;
+int16_t steer_value = 0; ///< 最後に取得できた steer
+
+// 操舵軸の状態推定 (条件エフェクト用)
+// フルスケール: 速度 = ロック間 (65534) を 0.5 秒, 加速度 = その 10 倍/秒
+const uint32_t STEER_VELOCITY_FULLSCALE = 131068; ///< [steer単位/s]
+const uint32_t STEER_ACCEL_FULLSCALE = 1310680;   ///< [steer単位/s^2]
+AxisObserver steer_observer(LOOP1_PERIOD_US, STEER_VELOCITY_FULLSCALE,
+                            STEER_ACCEL_FULLSCALE);
+
+// 入力/出力フィルタ (係数は Core1 の周期でコンパイル時に算出)
+// ペダル: ADC の突発値をメディアンで除き、1€ で静止時のみ強く平滑化する
+// 操舵軸: 1€ (エンコーダは外れ値が無いためメディアンは通さない)
+// トルク: 合算後に2次の低域通過 (ステップ状の指令による振動の抑制)
+// 群遅延 (10Hz): ペダル 約0.85ms, 操舵軸 約0.22ms, トルク 約0.54ms
+constexpr double LOOP1_RATE_HZ = 1000000.0 / LOOP1_PERIOD_US;
+static constexpr one_euro_coeffs_t PEDAL_FILTER =
+    one_euro_coeffs(LOOP1_RATE_HZ, 5.0, 0.001, 20.0);
+static constexpr one_euro_coeffs_t STEER_FILTER =
+    one_euro_coeffs(LOOP1_RATE_HZ, 5.0, 0.003, 20.0);
+static constexpr biquad_coeffs_t TORQUE_FILTER =
+    biquad_lowpass_q15(400.0, LOOP1_RATE_HZ);
+MedianFilter<int16_t, 3> pedal_median[PEDAL_COUNT];
+OneEuroFilter<PEDAL_FILTER> pedal_filter[PEDAL_COUNT];
+OneEuroFilter<STEER_FILTER> steer_filter;
+BiquadQ15<TORQUE_FILTER> torque_filter;
+
+// トルク出力段: エフェクトの合算 (Gain, Device Gain, ソフトクリップ) ->
+// 出力フィルタ -> 変化量の制限 -> PWM
+// 変化量の上限はフルスケールの 1/4 / 周期 (0 -> 最大を 1ms)
+const uint16_t TORQUE_MAX_STEP = 8192; ///< 1周期あたりの変化量の上限
+PwmTorqueOutput pwm_torque_output(PIN_MOTOR_PWM, PIN_MOTOR_DIR);
+TorqueOutput &torque_output = pwm_torque_output;
+FfbMixer torque_mixer(torque_output, TORQUE_MAX_STEP);
+IntervalTrigger_m mixer_report_trigger1(5000); ///< ミキサ統計の出力周期
+
+/// @brief ミキサの統計をテレメトリへ積む (Core1)
+static void mixer_report(void) {
+  const mixer_stats_t &stats = torque_mixer.stats();
+  tlm_mixer_t tlm = {stats.ticks,
+                     stats.overflow,
+                     stats.soft_clipped,
+                     stats.clipped,
+                     stats.slew_limited,
+                     (uint16_t)((stats.peak > 0xFFFF) ? 0xFFFF : stats.peak),
+                     torque_mixer.lastOutput()};
+  telemetry_emit(TLM_CORE1, TLM_TYPE_MIXER, &tlm, sizeof(tlm));
+}
 
 void setup1() {
   // Core1 初期化処理
@@ -170,21 +347,115 @@ void setup1() {
     core1_effects[i].active = false;
     core1_effects[i].magnitude = 0;
   }
+  ffb_engine_init(LOOP1_PERIOD_US);
+  torque_output.begin(); // トルク 0 から出力を開始する
+
+  // ペダル: ADC のフリーラン変換を DMA でリングバッファへ取り込む
+  pedal_adc_set_calibration(PEDAL_ACCEL, ACCEL_CALIBRATION);
+  pedal_adc_set_calibration(PEDAL_BRAKE, BRAKE_CALIBRATION);
+  pedal_adc_begin(PIN_ACCEL, PIN_BRAKE);
+
+  // ボタン: プルアップ入力 (押下で Low)
+  button_input_begin(BUTTON_PINS, sizeof(BUTTON_PINS));
+
+  // 操舵軸センサ: 最初の取得を開始しておく (結果は次の周期で取り出す)
+  if (steer_sensor.begin())
+    steer_sensor.startRead();
+
   loop1_trigger.init();
+  mixer_report_trigger1.init();
+#ifdef LATENCY_PROBE_ENABLE
+  sched_report_trigger1.init();
+#endif
+#ifdef SOF_SYNC_ENABLE
+  sof_report_trigger1.init();
+#endif
 }
 
 void loop1() {
-  // Core1 メインループ (1000Hz周期)
+#ifdef SOF_SYNC_ENABLE
+  // Core1 は入力を更新する周期そのものを同期させる (経過時間は周期実行から)
+  static uint32_t sof_seen1 = 0;
+  sof_sync_step(sof_lock1, loop1_trigger, sof_seen1,
+                loop1_trigger.lastDeadline());
+#endif
+
+  // Core1 メインループ (4000Hz周期)
   if (loop1_trigger.hasExpired()) {
+    uint32_t loop_start_us = LATENCY_STAMP();
     custom_gamepad_report_t core1_input = {0, 0, 0, 0};
 
-    // 物理入力読み取り (将来実装。現在は0またはループバック値)
+    // 物理入力読み取り
+    uint32_t sample_us = micros(); // 高分解能入力のサンプル時刻
+    // ペダルは DMA で取得済みのサンプルを合算するだけで、変換を待たない
+    int16_t pedals[PEDAL_COUNT];
+    if (pedal_adc_read(pedals)) {
+      for (uint8_t p = 0; p < PEDAL_COUNT; p++)
+        pedals[p] = pedal_filter[p].process(pedal_median[p].process(pedals[p]));
+      core1_input.accel = pedals[PEDAL_ACCEL];
+      core1_input.brake = pedals[PEDAL_BRAKE];
+    }
+    // ボタン: 全ピンを1回で読み取り、16 ボタン分をまとめてチャタリング除去
+    core1_input.buttons = button_debouncer.update(button_input_sample());
+    // 操舵軸: 前周期に開始した転送の結果を取り出し、次の転送を開始してから
+    // 展開・変換する (SPI の転送は DMA で以降の処理と並行に進む)
+    uint16_t steer_angle;
+    bool steer_valid = steer_sensor.poll(&steer_angle);
+    steer_sensor.startRead();
+    if (steer_valid) {
+      int32_t position = steer_unwrapper.update(steer_angle);
+      if (!steer_centered) {
+        steer_mapper.setCenter(position);
+        steer_filter.reset(0);
+        steer_centered = true;
+      }
+      steer_value = steer_filter.process(steer_mapper.map(position));
+    }
+    core1_input.steer = steer_value;
     // hidwffb_loopback_test_sync 内で CALLBACK_TEST_ENABLE 時は steer
-    // が上書きされる
+    // が上書きされる (ループバック中は accel/brake も上書き)
+
+    // 同期処理 (受け取ったスロットのみエンジンへ展開する)
+    // Device Control は全停止の世代を1回比較するだけで、スロットを走査しない
+    ffb_slot_mask_t changed =
+        hidwffb_loopback_test_sync(&core1_input, core1_effects);
+    const ffb_device_control_t &control = ffb_core1_device_control();
+    bool stopped_all = ffb_engine_control(control);
+    if (changed != 0)
+      ffb_engine_load(core1_effects, changed);
 
-    // 同期処理
-    hidwffb_loopback_test_sync(&core1_input, core1_effects);
+    // 操舵軸の状態推定 (Core1 の周期で更新し、条件エフェクトへ渡す)。
+    // ループバックで上書きされた core1_input.steer ではなく、センサから
+    // 得た値を使う (条件エフェクトは実際の操舵軸の位置に作用する)
+    const ffb_axis_state_t &axis = steer_observer.update(steer_value);
 
-    // モータ出力演算など (将来実装)
+    // エフェクト演算 (再生中のエフェクトを Gain を掛けて合算)
+    ffb_engine_update(axis, torque_mixer);
+
+    // モータ出力: Device Gain・ソフトクリップ -> 出力フィルタ -> 変化量の制限
+    int16_t mixed = torque_mixer.mix(ffb_core1_device_gain());
+    if (stopped_all || !control.actuators_enabled) {
+      // 全停止/アクチュエータ無効は出力フィルタと変化量の制限を通さず、
+      // 同じ周期でトルクを 0 にする
+      torque_filter.reset(0);
+      torque_mixer.cutOff();
+      core1_torque = 0;
+    } else {
+      core1_torque = torque_mixer.output(torque_filter.process(mixed));
+    }
+    if (HIRES_INPUT)
+      hidwffb_hires_push(sample_us, core1_input, core1_torque);
+
+    LATENCY_RECORD_BUDGET(LAT_LOOP1_BODY, loop_start_us, LOOP1_PERIOD_US);
+    if (mixer_report_trigger1.hasExpired())
+      mixer_report();
+#ifdef LATENCY_PROBE_ENABLE
+    if (sched_report_trigger1.hasExpired())
+      sched_report(TLM_CORE1, loop1_trigger);
+#endif
+#ifdef SOF_SYNC_ENABLE
+    if (sof_report_trigger1.hasExpired())
+      sof_report(TLM_CORE1, sof_lock1);
+#endif
   }
 }
@@ -0,0 +1,2229 @@
+/**
+ * @file native_bench.cpp
+ * @brief ホスト (native) 環境用ベンチマーク
+ *
+ * 実機に書き込む前に、PID パース・Core 間同期・Core1 周期処理のコストを
+ * ワークステーション上で計測し、性能劣化を検出するためのもの。
+ * 実行: ~/.platformio/penv/bin/pio run -e native -t exec
+ *
+ * 計測値はホスト CPU 上の値であり、RP2040 上の絶対値ではない。
+ * 変更前後の相対比較に使用すること。
+ * 動作の判定 (bench_expect) に1件でも失敗した場合は終了コード 1 を返す。
+ */
+
+#ifdef NATIVE_HOST
+
+#include "button_debounce.h"
+#include "button_input.h"
+#include "effect_store.h"
+#include "ffb_engine.h"
+#include "ffb_waveform.h"
+#include "fixed_filter.h"
+#include "hidwffb.h"
+#include "latency_probe.h"
+#include "pedal_adc.h"
+#include "serial_command.h"
+#include "sof_phase_lock.h"
+#include "steer_sensor.h"
+#include "telemetry.h"
+#include "torque_output.h"
+#include "triple_buffer.h"
+#include "util.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdarg>
+#include <thread>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// --- 計測ヘルパ ---
+static volatile uint32_t bench_sink; ///< 最適化による処理削除の防止用
+
+typedef std::chrono::steady_clock bench_clock;
+
+/**
+ * @brief fn を iterations 回実行し、1回あたりの所要時間 [ns] を返す
+ */
+template <typename Fn> static double bench_run(uint32_t iterations, Fn fn) {
+  // ウォームアップ
+  for (uint32_t i = 0; i < iterations / 10; i++)
+    fn(i);
+  bench_clock::time_point start = bench_clock::now();
+  for (uint32_t i = 0; i < iterations; i++)
+    fn(i);
+  bench_clock::time_point end = bench_clock::now();
+  return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end -
+                                                                      start)
+             .count() /
+         iterations;
+}
+
+static uint32_t bench_failures = 0; ///< 判定に失敗した項目数
+
+/**
+ * @brief 結果を判定する。失敗時は内容を表示し、終了コードを非 0 にする
+ * @param fmt 判定の内容 (printf 形式)
+ */
+static bool bench_expect(bool ok, const char *fmt, ...) {
+  if (!ok) {
+    bench_failures++;
+    va_list args;
+    va_start(args, fmt);
+    printf("!! FAIL: ");
+    vprintf(fmt, args);
+    printf("\n");
+    va_end(args);
+  }
+  return ok;
+}
+
+static void bench_print(const char *name, double ns_per_op,
+                        uint32_t items_per_op, const char *item_unit) {
+  printf("%-36s %10.1f ns/op", name, ns_per_op);
+  if (items_per_op > 0)
+    printf("  %12.0f %s/s", 1e9 * items_per_op / ns_per_op, item_unit);
+  printf("\n");
+}
+
+// --- テスト用レポート (Report ID を先頭に含む) ---
+static const USB_FFB_Report_SetEffect_t report_set_effect = {
+    HID_ID_SET_EFFECT, 1, HID_ET_CONSTANT, 0xFFFF, 0, 16384, 0xFF, 0x01, 0, 0};
+static const USB_FFB_Report_SetConstantForce_t report_constant = {
+    HID_ID_SET_CONSTANT_FORCE, 1, 12000};
+static const USB_FFB_Report_EffectOperation_t report_operation = {
+    HID_ID_EFFECT_OPERATION, 1, HID_OP_START, 1};
+
+/// @brief Set Effect / Set Constant Force / Effect Operation の一連の送信
+static const uint8_t *const burst_reports[] = {
+    (const uint8_t *)&report_set_effect, (const uint8_t *)&report_constant,
+    (const uint8_t *)&report_operation};
+static const uint16_t burst_sizes[] = {sizeof(report_set_effect),
+                                       sizeof(report_constant),
+                                       sizeof(report_operation)};
+static const uint32_t BURST_LEN = 3;
+
+// --- 1. PID パーススループット ---
+static void bench_parse(void) {
+  printf("\n[PID parse]\n");
+  const uint32_t N = 200000;
+
+  // 旧経路相当: 64byte 一時バッファへ Report ID を付けてコピーしてからパース
+  double ns = bench_run(N, [](uint32_t) {
+    for (uint32_t r = 0; r < BURST_LEN; r++) {
+      uint8_t temp_buf[HID_FFB_REPORT_SIZE];
+      temp_buf[0] = burst_reports[r][0];
+      memcpy(&temp_buf[1], &burst_reports[r][1], burst_sizes[r] - 1);
+      PID_ParseReport(temp_buf, burst_sizes[r]);
+    }
+  });
+  bench_print("copy + PID_ParseReport", ns, BURST_LEN, "reports");
+
+  // 振り分け表による直接ディスパッチ
+  ns = bench_run(N, [](uint32_t) {
+    for (uint32_t r = 0; r < BURST_LEN; r++)
+      PID_DispatchReport(burst_reports[r][0], &burst_reports[r][1],
+                         burst_sizes[r] - 1);
+  });
+  bench_print("PID_DispatchReport", ns, BURST_LEN, "reports");
+
+  // USB コールバック -> 受信キュー -> 一括処理 (実機と同じ経路)
+  ns = bench_run(N, [](uint32_t) {
+    for (uint32_t r = 0; r < BURST_LEN; r++)
+      native_shim_inject_report(burst_reports[r][0], HID_REPORT_TYPE_OUTPUT,
+                                &burst_reports[r][1], burst_sizes[r] - 1);
+    bench_sink = hidwffb_process_reports(HID_RX_QUEUE_DEPTH);
+  });
+  bench_print("callback + hidwffb_process_reports", ns, BURST_LEN, "reports");
+}
+
+// --- 2. Core 間同期コスト ---
+static void bench_core_sync(void) {
+  printf("\n[Core sync]\n");
+  const uint32_t N = 1000000;
+  static FFB_Shared_State_t core1_effects[MAX_EFFECTS];
+  static custom_gamepad_report_t input = {0, 0, 0, 0};
+
+  // PID 受信の無い定常状態
+  double ns = bench_run(N, [](uint32_t) {
+    pid_debug_info_t empty_info = {};
+    ffb_core0_update_shared(&empty_info);
+    ffb_core1_update_shared(&input, core1_effects);
+  });
+  bench_print("idle tick (core0 + core1)", ns, 0, "");
+
+  // 毎周期 1 スロットが更新される状態
+  ns = bench_run(N, [](uint32_t i) {
+    USB_FFB_Report_SetConstantForce_t report = {
+        HID_ID_SET_CONSTANT_FORCE, (uint8_t)(i % MAX_EFFECTS + 1),
+        (int16_t)i};
+    PID_ParseReport((const uint8_t *)&report, sizeof(report));
+    pid_debug_info_t empty_info = {};
+    ffb_core0_update_shared(&empty_info);
+    ffb_core1_update_shared(&input, core1_effects);
+  });
+  bench_print("1 dirty slot / tick (core0 + core1)", ns, 0, "");
+
+  ns = bench_run(N, [](uint32_t) {
+    custom_gamepad_report_t report;
+    ffb_core0_get_input_report(&report);
+    bench_sink = report.steer;
+  });
+  bench_print("ffb_core0_get_input_report", ns, 0, "");
+}
+
+// --- 3. Core1 周期処理コスト ---
+static void bench_core1_tick(void) {
+  printf("\n[Core1 tick]\n");
+  const uint32_t N = 1000000;
+  static FFB_Shared_State_t core1_effects[MAX_EFFECTS];
+
+  double ns = bench_run(N, [](uint32_t) {
+    custom_gamepad_report_t core1_input = {0, 0, 0, 0};
+    hidwffb_loopback_test_sync(&core1_input, core1_effects);
+    bench_sink = core1_input.steer;
+  });
+  bench_print("hidwffb_loopback_test_sync", ns, 0, "");
+}
+
+// --- エフェクトブロックの割当て (Create New Effect / Block Load) ---
+
+/// @brief Create New Effect を送り、続けて Block Load を読む (ホストと同じ手順)
+static uint8_t bench_create_effect(uint8_t type,
+                                   USB_FFB_Report_BlockLoad_t *load) {
+  const USB_FFB_Report_CreateNewEffect_t create = {HID_ID_CREATE_NEW_EFFECT,
+                                                   type, 0};
+  native_shim_inject_report(HID_ID_CREATE_NEW_EFFECT, HID_REPORT_TYPE_FEATURE,
+                            (const uint8_t *)&create + 1, sizeof(create) - 1);
+  load->reportId = HID_ID_BLOCK_LOAD;
+  native_shim_get_report(HID_ID_BLOCK_LOAD, HID_REPORT_TYPE_FEATURE,
+                         (uint8_t *)load + 1, sizeof(*load) - 1);
+  hidwffb_process_reports(HID_RX_QUEUE_DEPTH);
+  return load->loadStatus;
+}
+
+static void bench_free_effect(uint8_t block_index) {
+  const USB_FFB_Report_BlockFree_t free_report = {HID_ID_BLOCK_FREE,
+                                                  block_index};
+  native_shim_inject_report(HID_ID_BLOCK_FREE, HID_REPORT_TYPE_OUTPUT,
+                            &free_report.effectBlockIndex,
+                            sizeof(free_report) - 1);
+  hidwffb_process_reports(HID_RX_QUEUE_DEPTH);
+}
+
+static void bench_effect_pool(void) {
+  printf("\n[Effect block pool]\n");
+  USB_FFB_Report_Pool_t pool = {HID_ID_POOL, 0, 0, 0};
+  native_shim_get_report(HID_ID_POOL, HID_REPORT_TYPE_FEATURE,
+                         (uint8_t *)&pool + 1, sizeof(pool) - 1);
+  printf("pool: %u bytes, %u blocks x %u bytes, flags 0x%02X\n",
+         pool.ramPoolSize, pool.simultaneousEffectsMax,
+         (unsigned)sizeof(FFB_Shared_State_t), pool.memoryManagement);
+
+  // 全ブロックを確保すると、次の要求は Full になる
+  static const uint8_t types[] = {HID_ET_SINE, HID_ET_SPRING, HID_ET_CONSTANT,
+                                  HID_ET_DAMPER};
+  static uint8_t blocks[MAX_EFFECTS];
+  USB_FFB_Report_BlockLoad_t load;
+  uint8_t created = 0;
+  while (created < MAX_EFFECTS &&
+         bench_create_effect(types[created & 3], &load) ==
+             PID_BLOCK_LOAD_SUCCESS)
+    blocks[created++] = load.effectBlockIndex;
+  uint8_t status = bench_create_effect(HID_ET_SINE, &load);
+  printf("created %u / %u, next: status %u (2 = full), available %u bytes\n",
+         created, MAX_EFFECTS, status, load.ramPoolAvailable);
+  bench_expect(created == MAX_EFFECTS && status == PID_BLOCK_LOAD_FULL &&
+                   load.ramPoolAvailable == 0,
+               "pool full: created %u, status %u, available %u", created,
+               status, load.ramPoolAvailable);
+
+  // 種類の異なるパラメータブロックは無視される (共用体を壊さない)
+  USB_FFB_Report_SetPeriodic_t periodic = {HID_ID_SET_PERIODIC, blocks[0],
+                                           8000, 0, 0, 125};
+  USB_FFB_Report_SetCondition_t condition = {
+      HID_ID_SET_CONDITION, blocks[0], 0, 1000, 9000, 9000, 0, 0, 0};
+  PID_ParseReport((const uint8_t *)&periodic, sizeof(periodic));
+  PID_ParseReport((const uint8_t *)&condition, sizeof(condition));
+  static FFB_Shared_State_t core1_effects[MAX_EFFECTS];
+  custom_gamepad_report_t input = {0, 0, 0, 0};
+  ffb_core0_update_shared(NULL);
+  ffb_core1_update_shared(&input, core1_effects);
+  uint16_t period = core1_effects[blocks[0] - 1].force.periodic.period_ms;
+  printf("Sine block %u after Set Condition: period %u ms (expect 125)\n",
+         blocks[0], period);
+  bench_expect(period == 125, "Set Condition overwrote Sine period: %u ms",
+               period);
+
+  for (uint8_t i = 0; i < created; i++)
+    bench_free_effect(blocks[i]);
+  status = bench_create_effect(HID_ET_SINE, &load);
+  printf("after freeing all: status %u, block %u, available %u bytes\n",
+         status, load.effectBlockIndex, load.ramPoolAvailable);
+  bench_expect(status == PID_BLOCK_LOAD_SUCCESS &&
+                   load.ramPoolAvailable ==
+                       (MAX_EFFECTS - 1) * sizeof(FFB_Shared_State_t),
+               "after freeing all: status %u, available %u", status,
+               load.ramPoolAvailable);
+  bench_free_effect(load.effectBlockIndex);
+
+  double ns = bench_run(200000, [](uint32_t i) {
+    USB_FFB_Report_BlockLoad_t result;
+    bench_create_effect(types[i & 3], &result);
+    bench_free_effect(result.effectBlockIndex);
+  });
+  bench_print("create + block load + free", ns, 0, "");
+}
+
+// 条件エフェクト評価用の軸状態 (固定値)
+static const ffb_axis_state_t bench_axis = {8000, 1200, -300};
+
+// エンジンの積算先 (出力は記録のみ)
+static int16_t bench_capture[4000];
+static CaptureTorqueOutput bench_output(bench_capture, 4000);
+static FfbMixer bench_mixer(bench_output, 0);
+
+/// @brief 判定用のエフェクト (Gain 等倍, 1 回再生)
+static FFB_Shared_State_t bench_effect(uint8_t type, int16_t magnitude,
+                                       uint16_t duration_ms) {
+  FFB_Shared_State_t effect = FFB_Shared_State_t();
+  effect.type = type;
+  effect.magnitude = magnitude;
+  effect.duration_ms = duration_ms;
+  effect.loopCount = 1;
+  effect.gain = 32767;
+  effect.active = true;
+  return effect;
+}
+
+/**
+ * @brief 先頭 count スロットだけを再生し、周期ごとの合力を trace へ記録する
+ * Gain 等倍・Device Gain 255 のため、MIXER_KNEE 未満では力の合計そのもの
+ */
+static void bench_trace(const FFB_Shared_State_t *src, uint8_t count,
+                        uint32_t tick_us, int16_t *trace, uint32_t ticks) {
+  static FFB_Shared_State_t effects[MAX_EFFECTS];
+  for (uint8_t i = 0; i < MAX_EFFECTS; i++)
+    effects[i] = (i < count) ? src[i] : FFB_Shared_State_t();
+  ffb_engine_init(tick_us);
+  ffb_engine_load(effects, FFB_SLOT_MASK_ALL);
+  for (uint32_t t = 0; t < ticks; t++) {
+    ffb_engine_update(bench_axis, bench_mixer);
+    trace[t] = bench_mixer.mix(255);
+  }
+}
+
+// --- 4. エフェクト演算 (全スロット active) ---
+static void bench_engine(void) {
+  printf("\n[FFB engine: %d effects active]\n", MAX_EFFECTS);
+
+  // 合力の照合: Constant x2 + Ramp (-3000 -> 3000) + Spring を 100ms 再生。
+  // Spring は位置 8000, 不感帯 500, 係数 0.5 で -(8000 - 500) / 2 = -3750
+  FFB_Shared_State_t sum[4] = {
+      bench_effect(HID_ET_CONSTANT, 1000, 100),
+      bench_effect(HID_ET_CONSTANT, -3000, 100),
+      bench_effect(HID_ET_RAMP, 0, 100),
+      bench_effect(HID_ET_SPRING, 0, 100),
+  };
+  sum[2].force.ramp.start = -3000;
+  sum[2].force.ramp.end = 3000;
+  sum[3].condition.positiveCoefficient = 16384;
+  sum[3].condition.negativeCoefficient = 16384;
+  sum[3].condition.deadBand = 500;
+  static int16_t trace[200];
+  bench_trace(sum, 4, 1000, trace, 200);
+  uint32_t mismatched = 0;
+  for (int32_t t = 0; t < 200; t++) {
+    int32_t expect = (t < 100) ? 1000 - 3000 + (-3000 + 60 * t) - 3750 : 0;
+    if (trace[t] != expect)
+      mismatched++;
+  }
+  printf("constant + ramp + spring sum: mismatched ticks %lu / 200\n",
+         (unsigned long)mismatched);
+  bench_expect(mismatched == 0, "engine sum mismatched %lu ticks",
+               (unsigned long)mismatched);
+
+  const uint32_t N = 1000000;
+  static FFB_Shared_State_t effects[MAX_EFFECTS];
+  for (int i = 0; i < MAX_EFFECTS; i++) {
+    effects[i] = FFB_Shared_State_t();
+    static const uint8_t types[] = {HID_ET_CONSTANT, HID_ET_RAMP,
+                                    HID_ET_SPRING,   HID_ET_DAMPER,
+                                    HID_ET_INERTIA,  HID_ET_FRICTION};
+    effects[i].type = types[i % 6];
+    if (ffb_type_is_condition(effects[i].type)) {
+      effects[i].condition.positiveCoefficient = 16384;
+      effects[i].condition.negativeCoefficient = 16384;
+      effects[i].condition.deadBand = 500;
+    } else {
+      effects[i].force.ramp.start = -3000;
+      effects[i].force.ramp.end = 3000;
+    }
+    effects[i].magnitude = 1000;
+    effects[i].duration_ms = 500;
+    effects[i].loopCount = FFB_LOOP_INFINITE;
+    effects[i].gain = 32767;
+    effects[i].active = true;
+  }
+  ffb_engine_init(1000);
+  ffb_engine_load(effects, FFB_SLOT_MASK_ALL);
+
+  double ns = bench_run(N, [](uint32_t) {
+    ffb_engine_update(bench_axis, bench_mixer);
+    bench_sink = (uint32_t)bench_mixer.mix(255);
+  });
+  bench_print("ffb_engine_update", ns, 0, "");
+
+  // 短い duration / startDelay / 繰り返し間隔で状態遷移が頻発する場合
+  for (int i = 0; i < MAX_EFFECTS; i++) {
+    effects[i].duration_ms = (uint16_t)(3 + i);
+    effects[i].startDelay_ms = (uint16_t)i;
+    effects[i].triggerRepeatInterval_ms = (i & 1) ? 20 : 0;
+  }
+  ffb_engine_init(1000);
+  ffb_engine_load(effects, FFB_SLOT_MASK_ALL);
+  ns = bench_run(N, [](uint32_t) {
+    ffb_engine_update(bench_axis, bench_mixer);
+    bench_sink = (uint32_t)bench_mixer.mix(255);
+  });
+  bench_print("ffb_engine_update (timed loops)", ns, 0, "");
+}
+
+// --- 5. 周期エフェクト波形 ---
+static void bench_waveform(void) {
+  printf("\n[Periodic waveform]\n");
+  const uint32_t N = 10000000;
+  const uint32_t STEP = wave_phase_step(100, 1000); // 10Hz @ 1kHz
+
+  double ns = bench_run(N, [STEP](uint32_t i) {
+    bench_sink = (uint32_t)wave_sine_q15(i * STEP);
+  });
+  bench_print("wave_sine_q15", ns, 0, "");
+  ns = bench_run(N, [STEP](uint32_t i) {
+    bench_sink = (uint32_t)wave_triangle_q15(i * STEP);
+  });
+  bench_print("wave_triangle_q15", ns, 0, "");
+
+  // 倍精度 sin() に対する誤差 (ヘッダに記載の上限 ±4 LSB と比較する)
+  double max_error = 0.0;
+  for (uint32_t p = 0; p < 0x10000; p++) {
+    uint32_t phase = p << 16;
+    double ref = std::sin(2.0 * M_PI * phase / 4294967296.0) * WAVE_Q15_MAX;
+    double error = std::fabs(wave_sine_q15(phase) - ref);
+    if (error > max_error)
+      max_error = error;
+  }
+  printf("wave_sine_q15 max |error| vs sin(): %.2f LSB (Q15, bound 4)\n",
+         max_error);
+  bench_expect(max_error <= 4.0, "sine error %.2f LSB exceeds 4", max_error);
+
+  // 矩形波/三角波/のこぎり波は端点と 1/4 周期ごとの値が厳密に決まる
+  const uint32_t Q = 0x40000000u; // 1/4 周期
+  static const struct {
+    const char *name;
+    int16_t (*wave)(uint32_t);
+    int16_t at[4]; ///< 位相 0, 1/4, 1/2, 3/4
+  } shapes[] = {
+      {"square", wave_square_q15, {32767, 32767, -32767, -32767}},
+      {"triangle", wave_triangle_q15, {0, 32767, 0, -32767}},
+      {"sawtooth up", wave_sawtooth_up_q15, {-32767, -16384, 0, 16384}},
+      {"sawtooth down", wave_sawtooth_down_q15, {32767, 16384, 0, -16384}},
+  };
+  for (const auto &s : shapes)
+    for (uint32_t q = 0; q < 4; q++)
+      bench_expect(s.wave(q * Q) == s.at[q], "%s at %lu/4: %d (expect %d)",
+                   s.name, (unsigned long)q, s.wave(q * Q), s.at[q]);
+
+  // エンジン経由の正弦波 (振幅 10000, 100ms 周期) と sin() の差
+  FFB_Shared_State_t sine = bench_effect(HID_ET_SINE, 10000, 0xFFFF);
+  sine.force.periodic.period_ms = 100;
+  sine.force.periodic.offset = 500;
+  static int16_t trace[400];
+  bench_trace(&sine, 1, 1000, trace, 400);
+  double engine_error = 0.0;
+  for (uint32_t t = 0; t < 400; t++) {
+    double ref = 500.0 + 10000.0 * std::sin(2.0 * M_PI * t / 100.0);
+    double error = std::fabs(trace[t] - ref);
+    engine_error = (error > engine_error) ? error : engine_error;
+  }
+  printf("engine sine (10000, 100ms) max |error|: %.2f\n", engine_error);
+  bench_expect(engine_error <= 3.0, "engine sine error %.2f exceeds 3",
+               engine_error);
+
+  // 全スロットが正弦波の場合のエンジン1周期
+  static FFB_Shared_State_t effects[MAX_EFFECTS];
+  for (int i = 0; i < MAX_EFFECTS; i++) {
+    effects[i] = FFB_Shared_State_t();
+    effects[i].type = HID_ET_SINE;
+    effects[i].magnitude = 3000;
+    effects[i].force.periodic.period_ms = (uint16_t)(50 + i * 10);
+    effects[i].duration_ms = FFB_DURATION_INFINITE;
+    effects[i].gain = 32767;
+    effects[i].active = true;
+  }
+  ffb_engine_init(1000);
+  ffb_engine_load(effects, FFB_SLOT_MASK_ALL);
+  ns = bench_run(1000000, [](uint32_t) {
+    ffb_engine_update(bench_axis, bench_mixer);
+    bench_sink = (uint32_t)bench_mixer.mix(255);
+  });
+  bench_print("ffb_engine_update (all sine)", ns, 0, "");
+}
+
+// --- エンベロープ (Attack / Fade の区切りの周期と直線補間) ---
+
+/**
+ * @brief Constant (10000, Attack 4000 / 10ms, Fade 2000 / 20ms) を再生し、
+ * 理想の包絡線との最大誤差を返す
+ * @param duration_ms 0xFFFF なら Fade 無しで Attack 後は 10000 を維持する
+ * @param edge_errors 区切り (開始・Attack 終了・Fade 開始・終了) の不一致数
+ */
+static int32_t bench_envelope_case(int16_t magnitude, uint16_t duration_ms,
+                                   uint32_t tick_us, uint32_t *edge_errors) {
+  FFB_Shared_State_t effect =
+      bench_effect(HID_ET_CONSTANT, magnitude, duration_ms);
+  effect.force.envelope.attackLevel = 4000;
+  effect.force.envelope.attackTime_ms = 10;
+  effect.force.envelope.fadeLevel = 2000;
+  effect.force.envelope.fadeTime_ms = 20;
+  const int32_t per_ms = (int32_t)(1000 / tick_us);
+  const int32_t attack_end = 10 * per_ms;
+  const int32_t ticks = 200 * per_ms;
+  const bool finite = (duration_ms != FFB_DURATION_INFINITE);
+  const int32_t end = finite ? duration_ms * per_ms : ticks;
+  const int32_t fade_start = end - 20 * per_ms;
+  static int16_t trace[800];
+  bench_trace(&effect, 1, tick_us, trace, (uint32_t)ticks);
+
+  const int32_t sign = (magnitude < 0) ? -1 : 1;
+  int32_t max_error = 0;
+  for (int32_t t = 0; t < ticks; t++) {
+    int32_t level;
+    if (t < attack_end)
+      level = 4000 + (10000 - 4000) * t / attack_end;
+    else if (!finite || t < fade_start)
+      level = 10000;
+    else if (t < end)
+      level = 10000 + (2000 - 10000) * (t - fade_start) / (end - fade_start);
+    else
+      level = 0;
+    int32_t error = trace[t] - sign * level;
+    error = (error < 0) ? -error : error;
+    max_error = (error > max_error) ? error : max_error;
+  }
+  // 区切りの周期: 開始時は Attack Level、Attack 終了で Sustain、
+  // Fade は Sustain から始まり、duration の終了で 0 になる
+  *edge_errors = 0;
+  *edge_errors += (trace[0] != sign * 4000);
+  *edge_errors += (trace[attack_end - 1] == sign * 10000);
+  *edge_errors += (trace[attack_end] != sign * 10000);
+  if (finite) {
+    *edge_errors += (trace[fade_start] != sign * 10000);
+    *edge_errors += (trace[fade_start + 1] == sign * 10000);
+    *edge_errors += (trace[end - 1] == 0);
+    *edge_errors += (trace[end] != 0);
+  } else {
+    *edge_errors += (trace[ticks - 1] != sign * 10000);
+  }
+  return max_error;
+}
+
+static void bench_envelope(void) {
+  printf("\n[Envelope]\n");
+  static const struct {
+    int16_t magnitude;
+    uint16_t duration_ms;
+    uint32_t tick_us;
+  } cases[] = {
+      {10000, 100, 1000},
+      {-10000, 100, 1000},
+      {10000, 100, 250},
+      {10000, FFB_DURATION_INFINITE, 1000},
+      {-10000, FFB_DURATION_INFINITE, 250},
+  };
+  for (const auto &c : cases) {
+    uint32_t edge_errors;
+    int32_t error = bench_envelope_case(c.magnitude, c.duration_ms, c.tick_us,
+                                        &edge_errors);
+    char duration[8];
+    snprintf(duration, sizeof(duration), "%u", c.duration_ms);
+    printf("magnitude %6d, duration %4s ms @ %4lu us: max |error| %ld, "
+           "edge mismatches %lu\n",
+           c.magnitude,
+           (c.duration_ms == FFB_DURATION_INFINITE) ? "inf" : duration,
+           (unsigned long)c.tick_us, (long)error, (unsigned long)edge_errors);
+    bench_expect(error <= 2 && edge_errors == 0,
+                 "envelope %d / %u ms / %lu us: error %ld, edges %lu",
+                 c.magnitude, c.duration_ms, (unsigned long)c.tick_us,
+                 (long)error, (unsigned long)edge_errors);
+  }
+}
+
+// --- 再生タイミング (startDelay / duration / loopCount / 繰り返し間隔) ---
+static void bench_timing(void) {
+  printf("\n[Effect timing]\n");
+  static const struct {
+    uint16_t delay_ms;
+    uint16_t duration_ms;
+    uint16_t interval_ms;
+    uint8_t loops; ///< 0 は 1 回, FFB_LOOP_INFINITE は無限
+    uint32_t tick_us;
+  } cases[] = {
+      {5, 10, 25, 3, 1000},
+      {5, 10, 0, 3, 1000},
+      {0, 10, 0, 0, 1000},
+      {5, 10, 25, 2, 250},
+      {0, 10, 25, FFB_LOOP_INFINITE, 1000},
+  };
+  const uint32_t TICKS = 200;
+  static int16_t trace[TICKS];
+  for (const auto &c : cases) {
+    FFB_Shared_State_t effect =
+        bench_effect(HID_ET_CONSTANT, 5000, c.duration_ms);
+    effect.startDelay_ms = c.delay_ms;
+    effect.triggerRepeatInterval_ms = c.interval_ms;
+    effect.loopCount = c.loops;
+    bench_trace(&effect, 1, c.tick_us, trace, TICKS);
+
+    // k 回目の再生は startDelay + k * max(間隔, duration) から duration の間
+    const uint32_t per_ms = 1000 / c.tick_us;
+    const uint32_t delay = c.delay_ms * per_ms;
+    const uint32_t duration = c.duration_ms * per_ms;
+    const uint32_t interval = c.interval_ms * per_ms;
+    const uint32_t pitch = (interval > duration) ? interval : duration;
+    const uint32_t loops = (c.loops == 0) ? 1 : c.loops;
+    uint32_t mismatched = 0, starts = 0;
+    for (uint32_t t = 0; t < TICKS; t++) {
+      bool playing = false;
+      if (t >= delay) {
+        uint32_t k = (t - delay) / pitch;
+        playing = (c.loops == FFB_LOOP_INFINITE || k < loops) &&
+                  (t - delay) % pitch < duration;
+      }
+      if (trace[t] != (playing ? 5000 : 0))
+        mismatched++;
+      if (trace[t] != 0 && (t == 0 || trace[t - 1] == 0))
+        starts++;
+    }
+    printf("delay %2u, duration %2u, interval %2u, loops %3u @ %4lu us: "
+           "starts %lu, mismatched ticks %lu / %lu\n",
+           c.delay_ms, c.duration_ms, c.interval_ms, c.loops,
+           (unsigned long)c.tick_us, (unsigned long)starts,
+           (unsigned long)mismatched, (unsigned long)TICKS);
+    bench_expect(mismatched == 0,
+                 "timing delay %u / duration %u / interval %u / loops %u "
+                 "@ %lu us: %lu ticks mismatched",
+                 c.delay_ms, c.duration_ms, c.interval_ms, c.loops,
+                 (unsigned long)c.tick_us, (unsigned long)mismatched);
+  }
+}
+
+// --- トルク出力段 (合算, ソフトクリップ, 変化量の制限) ---
+static void bench_torque_mixer(void) {
+  printf("\n[Torque mixer]\n");
+  // 高負荷時の想定: 路面の振動 (正弦波 3 つ) + 縁石 (矩形波) +
+  // 横 G (Constant) + Spring を同時に再生し、Device Gain を段階的に上げる
+  static FFB_Shared_State_t effects[MAX_EFFECTS];
+  static const uint8_t types[] = {HID_ET_SINE,     HID_ET_SINE,
+                                  HID_ET_SINE,     HID_ET_SQUARE,
+                                  HID_ET_CONSTANT, HID_ET_SPRING};
+  for (int i = 0; i < MAX_EFFECTS; i++) {
+    effects[i] = FFB_Shared_State_t();
+    if (i >= 6)
+      continue;
+    effects[i].type = types[i];
+    effects[i].magnitude = (i == 4) ? 15000 : 9000;
+    if (ffb_type_is_condition(types[i])) {
+      effects[i].condition.positiveCoefficient = 16384;
+      effects[i].condition.negativeCoefficient = 16384;
+    } else {
+      effects[i].force.periodic.period_ms = (uint16_t)(20 + i * 7);
+    }
+    effects[i].duration_ms = FFB_DURATION_INFINITE;
+    effects[i].gain = 27852; // 0.85
+    effects[i].active = true;
+  }
+
+  static int16_t captured[4000];
+  static CaptureTorqueOutput capture(captured, 4000);
+  const uint16_t MAX_STEP = 8192;
+  static FfbMixer mixer(capture, MAX_STEP);
+  static const uint8_t device_gains[] = {128, 192, 255};
+  for (uint8_t g = 0; g < 3; g++) {
+    ffb_engine_init(250);
+    ffb_engine_load(effects, FFB_SLOT_MASK_ALL);
+    int32_t prev = mixer.lastOutput();
+    capture.begin();
+    mixer.resetStats();
+    for (uint32_t t = 0; t < 4000; t++) { // 4kHz で 1 秒
+      ffb_engine_update(bench_axis, mixer);
+      mixer.output(mixer.mix(device_gains[g]));
+    }
+    const mixer_stats_t &st = mixer.stats();
+    int32_t out_max = 0, step_max = 0;
+    for (uint32_t t = 0; t < capture.size(); t++) {
+      int32_t v = (captured[t] < 0) ? -(int32_t)captured[t] : captured[t];
+      int32_t d = (int32_t)captured[t] - prev;
+      d = (d < 0) ? -d : d;
+      out_max = (v > out_max) ? v : out_max;
+      step_max = (d > step_max) ? d : step_max;
+      prev = captured[t];
+    }
+    printf("device gain %3u: overflow %4lu  soft clip %4lu  clip %4lu  "
+           "slew %3lu  peak in %6lu  max out %5ld\n",
+           device_gains[g], (unsigned long)st.overflow,
+           (unsigned long)st.soft_clipped, (unsigned long)st.clipped,
+           (unsigned long)st.slew_limited, (unsigned long)st.peak,
+           (long)out_max);
+    bench_expect(out_max <= MIXER_TORQUE_MAX,
+                 "mixer gain %u: output %ld exceeds %d", device_gains[g],
+                 (long)out_max, MIXER_TORQUE_MAX);
+    bench_expect(step_max <= MAX_STEP,
+                 "mixer gain %u: step %ld exceeds %u", device_gains[g],
+                 (long)step_max, MAX_STEP);
+    if (device_gains[g] == 128)
+      bench_expect(out_max < MIXER_KNEE && st.soft_clipped == 0,
+                   "mixer gain 128: output %ld, soft clipped %lu",
+                   (long)out_max, (unsigned long)st.soft_clipped);
+  }
+
+  // 変化量の制限: 0 -> フルスケールのステップは 4 周期 (1ms) で到達する
+  while (mixer.output(0) != 0) // output(0) 自体も制限されるため 0 まで戻す
+    ;
+  uint32_t steps = 0;
+  while (mixer.output(32767) < 32767)
+    steps++;
+  printf("0 -> full scale step: %lu ticks with max step %u\n",
+         (unsigned long)steps + 1, MAX_STEP);
+  bench_expect(steps + 1 == 4, "mixer: full scale step took %lu ticks",
+               (unsigned long)steps + 1);
+
+  // 全停止 (cutOff) は変化量の制限を通さず即座に 0 を書き込む
+  uint32_t writes = capture.writes();
+  mixer.cutOff();
+  bench_expect(capture.writes() == writes + 1 && capture.lastValue() == 0 &&
+                   mixer.lastOutput() == 0,
+               "mixer: cutOff wrote %d (%lu writes)", capture.lastValue(),
+               (unsigned long)(capture.writes() - writes));
+
+  static int32_t forces[MAX_EFFECTS];
+  for (int i = 0; i < MAX_EFFECTS; i++)
+    forces[i] = (i & 1) ? 9000 : -4000;
+  double ns = bench_run(1000000, [](uint32_t n) {
+    bench_mixer.clear();
+    for (int i = 0; i < MAX_EFFECTS; i++)
+      bench_mixer.add(forces[i] + (int32_t)(n & 1023), 24576);
+    bench_sink = (uint32_t)bench_mixer.output(bench_mixer.mix(255));
+  });
+  char name[48];
+  snprintf(name, sizeof(name), "mixer add x%d + mix + output", MAX_EFFECTS);
+  bench_print(name, ns, 0, "");
+}
+
+// --- エフェクトの保持方法: スロットごとの構造体 (AoS) と種類別の配列 (SoA) ---
+
+/**
+ * @brief 比較用: 変更前のエンジンと同じく、スロットごとの構造体を全数走査し、
+ * volatile の active と Effect Type で分岐して評価する (タイミング処理は除く)
+ */
+template <uint8_t N> struct AosEffectBench {
+  struct Slot {
+    FFB_Shared_State_t effect;
+    volatile bool active;
+    uint32_t phase;
+    uint32_t phase_step;
+    uint16_t period_ms;
+  };
+  Slot slot[N];
+
+  static int32_t condition(const ffb_condition_block_t &e, int32_t metric,
+                           int32_t center, int32_t dead_band) {
+    int32_t upper = center + dead_band, lower = center - dead_band;
+    upper = (upper > FFB_TORQUE_MAX) ? FFB_TORQUE_MAX : upper;
+    lower = (lower < -FFB_TORQUE_MAX) ? -FFB_TORQUE_MAX : lower;
+    int32_t force;
+    if (metric > upper)
+      force = -(((metric - upper) * e.positiveCoefficient) >> 15);
+    else if (metric < lower)
+      force = -(((metric - lower) * e.negativeCoefficient) >> 15);
+    else
+      return 0;
+    int32_t pos = e.positiveSaturation ? e.positiveSaturation : FFB_TORQUE_MAX;
+    int32_t neg = e.negativeSaturation ? e.negativeSaturation : FFB_TORQUE_MAX;
+    return (force > pos) ? pos : (force < -neg) ? -neg : force;
+  }
+
+  template <int16_t (*Wave)(uint32_t)> static int32_t periodic(Slot &s) {
+    const ffb_periodic_block_t &p = s.effect.force.periodic;
+    if (p.period_ms != s.period_ms) {
+      s.period_ms = p.period_ms;
+      s.phase_step = wave_phase_step(s.period_ms, 250);
+    }
+    int32_t wave = Wave(s.phase);
+    s.phase += s.phase_step;
+    return p.offset + ((s.effect.magnitude * wave) >> 15);
+  }
+
+  void evaluate(const ffb_axis_state_t &axis, FfbMixer &mixer) {
+    for (uint8_t i = 0; i < N; i++) {
+      Slot &s = slot[i];
+      if (!s.active)
+        continue;
+      const FFB_Shared_State_t &e = s.effect;
+      const ffb_condition_block_t &c = e.condition;
+      int32_t force;
+      switch (e.type) {
+      case HID_ET_CONSTANT:
+        force = e.magnitude;
+        break;
+      case HID_ET_SQUARE:
+        force = periodic<wave_square_q15>(s);
+        break;
+      case HID_ET_SINE:
+        force = periodic<wave_sine_q15>(s);
+        break;
+      case HID_ET_TRIANGLE:
+        force = periodic<wave_triangle_q15>(s);
+        break;
+      case HID_ET_SPRING:
+        force = condition(c, axis.position, c.cpOffset, c.deadBand);
+        break;
+      case HID_ET_DAMPER:
+        force = condition(c, axis.velocity, c.cpOffset, c.deadBand);
+        break;
+      case HID_ET_INERTIA:
+        force = condition(c, axis.acceleration, c.cpOffset, c.deadBand);
+        break;
+      case HID_ET_FRICTION: {
+        int32_t dir = axis.velocity * FFB_FRICTION_VELOCITY_GAIN;
+        dir = (dir > FFB_TORQUE_MAX)    ? FFB_TORQUE_MAX
+              : (dir < -FFB_TORQUE_MAX) ? -FFB_TORQUE_MAX
+                                        : dir;
+        force = condition(c, dir, 0, 0);
+        break;
+      }
+      default:
+        force = 0;
+        break;
+      }
+      mixer.add(force, e.gain);
+    }
+  }
+};
+
+/// @brief 比較用のエフェクト (周期 4 種, 条件 4 種, Constant を順に割り当てる)
+static FFB_Shared_State_t bench_layout_effect(uint8_t i, bool playing) {
+  static const uint8_t types[] = {HID_ET_SINE,   HID_ET_SPRING,
+                                  HID_ET_SQUARE, HID_ET_DAMPER,
+                                  HID_ET_CONSTANT, HID_ET_TRIANGLE,
+                                  HID_ET_FRICTION, HID_ET_SINE,
+                                  HID_ET_INERTIA};
+  FFB_Shared_State_t e = FFB_Shared_State_t();
+  e.type = types[i % 9];
+  e.magnitude = (int16_t)(2000 + i * 37);
+  if (ffb_type_is_condition(e.type)) {
+    e.condition.cpOffset = (int16_t)(i * 50 - 1000);
+    e.condition.deadBand = 300;
+    e.condition.positiveCoefficient = 12000;
+    e.condition.negativeCoefficient = 9000;
+    e.condition.positiveSaturation = (i & 1) ? 6000 : 0;
+  } else {
+    e.force.periodic.offset = (int16_t)((i & 3) * 100);
+    e.force.periodic.period_ms = (uint16_t)(20 + i * 3);
+    e.force.periodic.phase = (uint16_t)(i * 800);
+  }
+  e.duration_ms = FFB_DURATION_INFINITE;
+  e.gain = 24576;
+  e.active = playing;
+  return e;
+}
+
+/**
+ * @brief N スロット中 playing 個 (等間隔) を再生した場合の 1 周期を比較する
+ * 同じ入力で両者の出力列が一致することも確認する
+ */
+template <uint8_t N> static void bench_layout(uint8_t playing) {
+  static AosEffectBench<N> aos;
+  static EffectStore<N> soa;
+  soa.setTick(250);
+  soa.clear();
+  uint8_t stride = (uint8_t)(N / playing);
+  for (uint8_t i = 0; i < N; i++) {
+    FFB_Shared_State_t e = bench_layout_effect(i, i % stride == 0);
+    typename AosEffectBench<N>::Slot &s = aos.slot[i];
+    s.effect = e;
+    s.active = e.active;
+    s.phase = wave_phase_from_pid(e.force.periodic.phase);
+    s.period_ms = e.force.periodic.period_ms;
+    s.phase_step = wave_phase_step(s.period_ms, 250);
+    soa.load(i, e);
+    if (e.active)
+      soa.start(i);
+  }
+
+  // 出力列の一致 (1 秒分)
+  ffb_axis_state_t axis = bench_axis;
+  int64_t sum_aos = 0, sum_soa = 0;
+  uint32_t mismatch = 0;
+  for (uint32_t t = 0; t < 4000; t++) {
+    axis.position = (int16_t)((int32_t)(t * 97 % 32768) - 16384);
+    axis.velocity = (int16_t)((int32_t)(t * 13 % 4096) - 2048);
+    bench_mixer.clear();
+    aos.evaluate(axis, bench_mixer);
+    int16_t a = bench_mixer.mix(255);
+    bench_mixer.clear();
+    soa.evaluate(axis, bench_mixer);
+    int16_t b = bench_mixer.mix(255);
+    sum_aos += a;
+    sum_soa += b;
+    mismatch += (a != b);
+  }
+
+  double ns_aos = bench_run(1000000, [](uint32_t) {
+    bench_mixer.clear();
+    aos.evaluate(bench_axis, bench_mixer);
+    bench_sink = (uint32_t)bench_mixer.mix(255);
+  });
+  double ns_soa = bench_run(1000000, [](uint32_t) {
+    bench_mixer.clear();
+    soa.evaluate(bench_axis, bench_mixer);
+    bench_sink = (uint32_t)bench_mixer.mix(255);
+  });
+  char name[48];
+  snprintf(name, sizeof(name), "AoS %u slots, %u playing", N, playing);
+  bench_print(name, ns_aos, 1, "ticks");
+  snprintf(name, sizeof(name), "SoA %u slots, %u playing", N, playing);
+  bench_print(name, ns_soa, 1, "ticks");
+  printf("  speedup x%.2f, output sum %lld / %lld, mismatched ticks %lu\n",
+         ns_aos / ns_soa, (long long)sum_aos, (long long)sum_soa,
+         (unsigned long)mismatch);
+  bench_expect(mismatch == 0 && sum_aos == sum_soa,
+               "AoS/SoA %u slots, %u playing: %lu ticks mismatched, sum "
+               "%lld / %lld",
+               N, playing, (unsigned long)mismatch, (long long)sum_aos,
+               (long long)sum_soa);
+}
+
+static void bench_effect_layout(void) {
+  printf("\n[Effect store layout: AoS scan vs SoA play lists]\n");
+  bench_layout<10>(10);
+  bench_layout<40>(40);
+  bench_layout<40>(10);
+}
+
+// --- Device Control (全停止 / Solo / 一時停止 / アクチュエータ / リセット) ---
+
+static FFB_Shared_State_t control_core1_effects[MAX_EFFECTS];
+
+/**
+ * @brief 受信処理から Core1 の出力段までを1周期分進める (main.cpp と同じ順)
+ * @param mixed エンジンの合算値 (全停止/アクチュエータ無効で 0 にする前)
+ * @return 出力段へ渡す値
+ */
+static int16_t bench_control_tick(int16_t *mixed = nullptr) {
+  hidwffb_process_reports(HID_RX_QUEUE_DEPTH);
+  pid_debug_info_t empty_info = {};
+  ffb_core0_update_shared(&empty_info);
+  custom_gamepad_report_t input = {0, 0, 0, 0};
+  ffb_slot_mask_t changed =
+      ffb_core1_update_shared(&input, control_core1_effects);
+  const ffb_device_control_t &control = ffb_core1_device_control();
+  bool stopped_all = ffb_engine_control(control);
+  if (changed != 0)
+    ffb_engine_load(control_core1_effects, changed);
+  ffb_engine_update(bench_axis, bench_mixer);
+  int16_t sum = bench_mixer.mix(255);
+  if (mixed != nullptr)
+    *mixed = sum;
+  return (stopped_all || !control.actuators_enabled) ? 0 : sum;
+}
+
+static void bench_send_output(const void *report, uint16_t size) {
+  const uint8_t *bytes = (const uint8_t *)report;
+  native_shim_inject_report(bytes[0], HID_REPORT_TYPE_OUTPUT, &bytes[1],
+                            size - 1);
+}
+
+static void bench_device_control_send(uint8_t control) {
+  const USB_FFB_Report_DeviceControl_t report = {HID_ID_DEVICE_CONTROL,
+                                                 control};
+  bench_send_output(&report, sizeof(report));
+}
+
+/// @brief ブロック 1..count に Constant (magnitude 200) を設定して開始する
+static void bench_start_constants(uint8_t count, uint8_t operation) {
+  for (uint8_t i = 1; i <= count; i++) {
+    USB_FFB_Report_SetEffect_t effect = report_set_effect;
+    effect.effectBlockIndex = i;
+    USB_FFB_Report_SetConstantForce_t constant = {HID_ID_SET_CONSTANT_FORCE,
+                                                  i, 200};
+    USB_FFB_Report_EffectOperation_t start = {HID_ID_EFFECT_OPERATION, i,
+                                              operation, FFB_LOOP_INFINITE};
+    bench_send_output(&effect, sizeof(effect));
+    bench_send_output(&constant, sizeof(constant));
+    bench_send_output(&start, sizeof(start));
+    hidwffb_process_reports(HID_RX_QUEUE_DEPTH);
+  }
+}
+
+static void bench_device_control(void) {
+  printf("\n[Device Control]\n");
+  ffb_engine_init(1000);
+  bench_device_control_send(HID_DC_DEVICE_RESET);
+  bench_control_tick();
+
+  // エンジン側の停止も確かめるため、出力段へ渡す前の合算値を照合する
+  const int16_t all = (int16_t)(MAX_EFFECTS * 100); // Constant 200 x Gain 0.5
+  int16_t mixed;
+  bench_start_constants(MAX_EFFECTS, HID_OP_START);
+  int16_t playing = bench_control_tick();
+  bench_device_control_send(HID_DC_STOP_ALL_EFFECTS);
+  int16_t stop_mixed;
+  int16_t stopped = bench_control_tick(&stop_mixed);
+  int16_t next_mixed;
+  bench_control_tick(&next_mixed);
+  printf("Stop All: %d effects %d -> %d in the same tick (engine %d), "
+         "next tick engine %d\n",
+         MAX_EFFECTS, playing, stopped, stop_mixed, next_mixed);
+  bench_expect(playing == all, "playing %d (expect %d)", playing, all);
+  bench_expect(stopped == 0 && stop_mixed == 0 && next_mixed == 0,
+               "Stop All: output %d, engine %d, next tick engine %d",
+               stopped, stop_mixed, next_mixed);
+
+  bench_start_constants(MAX_EFFECTS, HID_OP_START);
+  USB_FFB_Report_EffectOperation_t solo = {HID_ID_EFFECT_OPERATION, 7,
+                                           HID_OP_SOLO, FFB_LOOP_INFINITE};
+  bench_send_output(&solo, sizeof(solo));
+  bench_control_tick();
+  int16_t solo_out = bench_control_tick();
+  printf("Solo block 7: output %d (1 effect)\n", solo_out);
+  bench_expect(solo_out == 100, "Solo: output %d (expect 100)", solo_out);
+
+  bench_start_constants(MAX_EFFECTS, HID_OP_START);
+  bench_device_control_send(HID_DC_DEVICE_PAUSE);
+  int16_t paused = bench_control_tick(&mixed);
+  int16_t paused_mixed = mixed;
+  bench_device_control_send(HID_DC_DEVICE_CONTINUE);
+  int16_t resumed = bench_control_tick();
+  printf("Pause: %d (engine %d), Continue: %d\n", paused, paused_mixed,
+         resumed);
+  bench_expect(paused == 0 && paused_mixed == 0 && resumed == all,
+               "Pause: %d (engine %d), Continue: %d (expect %d)", paused,
+               paused_mixed, resumed, all);
+  // アクチュエータ無効の間もエンジンは演算を続け、出力段だけを 0 にする
+  bench_device_control_send(HID_DC_DISABLE_ACTUATORS);
+  int16_t disabled = bench_control_tick(&mixed);
+  int16_t disabled_mixed = mixed;
+  bench_device_control_send(HID_DC_ENABLE_ACTUATORS);
+  int16_t enabled = bench_control_tick();
+  printf("Disable Actuators: %d (engine %d), Enable Actuators: %d\n",
+         disabled, disabled_mixed, enabled);
+  bench_expect(disabled == 0 && disabled_mixed == all && enabled == all,
+               "Disable Actuators: %d (engine %d), Enable Actuators: %d",
+               disabled, disabled_mixed, enabled);
+
+  USB_FFB_Report_BlockLoad_t load;
+  for (uint8_t i = 0; i < 8; i++)
+    bench_create_effect(HID_ET_SINE, &load);
+  bench_device_control_send(HID_DC_DEVICE_RESET);
+  bench_control_tick();
+  bench_create_effect(HID_ET_SINE, &load);
+  printf("Reset: 8 blocks freed, next block %u, available %u bytes\n",
+         load.effectBlockIndex, load.ramPoolAvailable);
+  // Reset 後は直前に確保した 1 ブロックのみ使用中
+  bench_expect(load.loadStatus == PID_BLOCK_LOAD_SUCCESS &&
+                   load.ramPoolAvailable ==
+                       (MAX_EFFECTS - 1) * sizeof(FFB_Shared_State_t),
+               "Reset: status %u, available %u bytes", load.loadStatus,
+               load.ramPoolAvailable);
+  bench_device_control_send(HID_DC_DEVICE_RESET);
+
+  // 全停止の周期のコストは再生中のエフェクト数によらない
+  static FFB_Shared_State_t effects[MAX_EFFECTS];
+  static const uint8_t counts[] = {1, 10, MAX_EFFECTS};
+  for (uint8_t c = 0; c < 3; c++) {
+    for (uint8_t i = 0; i < MAX_EFFECTS; i++) {
+      effects[i] = bench_layout_effect(i, i < counts[c]);
+      effects[i].startCount++;
+    }
+    ffb_engine_init(1000);
+    ffb_device_control_t control = {0, true, false};
+    const uint32_t N = 100000;
+    double total_ns = 0;
+    for (uint32_t n = 0; n < N; n++) {
+      ffb_engine_load(effects, FFB_SLOT_MASK_ALL);
+      control.stop_epoch++;
+      bench_clock::time_point start = bench_clock::now();
+      ffb_engine_control(control);
+      ffb_engine_update(bench_axis, bench_mixer);
+      bench_clock::time_point end = bench_clock::now();
+      total_ns += std::chrono::duration<double, std::nano>(end - start).count();
+      // 停止後に再び開始させる
+      for (uint8_t i = 0; i < MAX_EFFECTS; i++)
+        effects[i].startCount++;
+    }
+    char name[48];
+    snprintf(name, sizeof(name), "stop-all tick (%u playing)", counts[c]);
+    bench_print(name, total_ns / N, 0, "");
+  }
+}
+
+// --- Custom Force (ID 2 のサンプル列の受信と再生) ---
+
+static USB_FFB_Report_CustomForceStatus_t bench_custom_status(void) {
+  USB_FFB_Report_CustomForceStatus_t status;
+  status.reportId = HID_ID_CUSTOM_FORCE_STATUS;
+  native_shim_get_report(HID_ID_CUSTOM_FORCE_STATUS, HID_REPORT_TYPE_FEATURE,
+                         (uint8_t *)&status + 1, sizeof(status) - 1);
+  return status;
+}
+
+/// @brief 路面の振動を模した 0 以外のサンプル列 (i 番目)
+static int16_t bench_road_sample(uint32_t i) {
+  uint32_t x = i * 2654435761u;
+  int16_t v = (int16_t)((x >> 16) % 12000 + 1);
+  return (x & 0x8000) ? (int16_t)-v : v;
+}
+
+/// @brief チャンク seq (サンプル seq * 29 から) を ID 2 で送る
+static void bench_send_chunk(uint8_t block_index, uint16_t seq) {
+  USB_FFB_Report_CustomForceData_t chunk;
+  chunk.reportId = HID_ID_VENDOR_FFB;
+  chunk.command = HID_VENDOR_CMD_CUSTOM_FORCE;
+  chunk.effectBlockIndex = block_index;
+  chunk.sequence = seq;
+  chunk.sampleCount = FFB_CUSTOM_CHUNK_SAMPLES;
+  int16_t samples[FFB_CUSTOM_CHUNK_SAMPLES];
+  uint32_t base = (uint32_t)seq * FFB_CUSTOM_CHUNK_SAMPLES;
+  for (uint8_t i = 0; i < FFB_CUSTOM_CHUNK_SAMPLES; i++)
+    samples[i] = bench_road_sample(base + i);
+  memcpy((uint8_t *)&chunk + offsetof(USB_FFB_Report_CustomForceData_t,
+                                      samples),
+         samples, sizeof(samples));
+  bench_send_output(&chunk, sizeof(chunk));
+}
+
+/// @brief Custom Force のブロックを確保し、サンプル周期を設定して開始する
+static uint8_t bench_start_custom(uint16_t period_us) {
+  USB_FFB_Report_BlockLoad_t load;
+  bench_create_effect(HID_ET_CUSTOM, &load);
+  uint8_t block = load.effectBlockIndex;
+  USB_FFB_Report_SetEffect_t effect = report_set_effect;
+  effect.effectBlockIndex = block;
+  effect.effectType = HID_ET_CUSTOM;
+  effect.gain = 32767;
+  USB_FFB_Report_SetCustomForce_t custom = {HID_ID_SET_CUSTOM_FORCE, block,
+                                            period_us};
+  USB_FFB_Report_EffectOperation_t start = {HID_ID_EFFECT_OPERATION, block,
+                                            HID_OP_START, FFB_LOOP_INFINITE};
+  bench_send_output(&effect, sizeof(effect));
+  bench_send_output(&custom, sizeof(custom));
+  bench_send_output(&start, sizeof(start));
+  hidwffb_process_reports(HID_RX_QUEUE_DEPTH);
+  return block;
+}
+
+/**
+ * @brief 1ms ごとに 1 チャンクを送るホストを模擬し、USB 上の欠落と重複を
+ * 加えても再生されるサンプル列が送信した列と一致することを確認する
+ * (サンプル周期 = Core1 の周期なので、出力は 1 周期 1 サンプル)
+ */
+static void bench_custom_force(void) {
+  printf("\n[Custom Force stream: 1 chunk (%d samples) / ms, 5%% lost, "
+         "5%% duplicated]\n",
+         FFB_CUSTOM_CHUNK_SAMPLES);
+  const uint32_t TICK_US = 250;
+  ffb_engine_init(TICK_US);
+  bench_device_control_send(HID_DC_DEVICE_RESET);
+  bench_control_tick();
+  uint8_t block = bench_start_custom((uint16_t)TICK_US);
+
+  const uint32_t TICKS = 40000;
+  static int16_t played[TICKS];
+  uint16_t sent = 0; // 次に送るチャンク
+  uint32_t lost = 0, duplicated = 0, resent = 0, rng = 12345;
+  for (uint32_t t = 0; t < TICKS; t++) {
+    if (t % (1000 / TICK_US) == 0) {
+      // ホスト: 状況を読み、受け付けられていなければその番号から送り直す
+      USB_FFB_Report_CustomForceStatus_t status = bench_custom_status();
+      uint16_t next = status.channel[0].nextSequence;
+      if (next != sent) {
+        resent++;
+        sent = next;
+      }
+      if (status.channel[0].freeSamples >= FFB_CUSTOM_CHUNK_SAMPLES) {
+        rng = rng * 1103515245u + 12345u;
+        uint32_t r = (rng >> 16) % 100;
+        if (r < 5) {
+          lost++; // USB 上で失われる
+        } else {
+          bench_send_chunk(block, sent);
+          if (r < 10) {
+            duplicated++;
+            bench_send_chunk(block, sent);
+          }
+        }
+        sent++;
+      }
+    }
+    played[t] = bench_control_tick();
+  }
+
+  // 最初のサンプルが届くまでの 0 を除き、送信した列と比較する
+  uint32_t first = 0;
+  while (first < TICKS && played[first] == 0)
+    first++;
+  uint32_t mismatched = 0, gaps = 0;
+  for (uint32_t t = first; t < TICKS; t++) {
+    if (played[t] == 0)
+      gaps++;
+    else if (played[t] != bench_road_sample(t - first - gaps))
+      mismatched++;
+  }
+  USB_FFB_Report_CustomForceStatus_t status = bench_custom_status();
+  printf("played %u samples, mismatched %u, underrun ticks %u (before first "
+         "sample %u)\n",
+         TICKS - first - gaps, mismatched, gaps, first);
+  printf("chunks lost %u, duplicated %u, host resends %u, next seq %u, "
+         "underruns %u\n",
+         lost, duplicated, resent, status.channel[0].nextSequence,
+         status.channel[0].underruns);
+
+  // 長さ 0 のベンダーレポートは従来の汎用データとしても扱わない。
+  // 受信キューの全要素に前回の内容として汎用データを残してから送る
+  static const uint8_t generic = 0x01;
+  uint8_t ffb_data[HID_FFB_REPORT_SIZE];
+  for (uint16_t i = 0; i < HID_RX_QUEUE_DEPTH; i++) {
+    native_shim_inject_report(HID_ID_VENDOR_FFB, HID_REPORT_TYPE_OUTPUT,
+                              &generic, 1);
+    hidwffb_process_reports(HID_RX_QUEUE_DEPTH);
+  }
+  hidwffb_clear_ffb_flag();
+  native_shim_inject_report(HID_ID_VENDOR_FFB, HID_REPORT_TYPE_OUTPUT,
+                            &generic, 0);
+  hidwffb_process_reports(HID_RX_QUEUE_DEPTH);
+  bool empty_taken = hidwffb_get_ffb_data(ffb_data);
+  native_shim_inject_report(HID_ID_VENDOR_FFB, HID_REPORT_TYPE_OUTPUT,
+                            &generic, 1);
+  hidwffb_process_reports(HID_RX_QUEUE_DEPTH);
+  bool generic_taken = hidwffb_get_ffb_data(ffb_data);
+  printf("vendor report len 0: %s, len 1 (generic data): %s\n",
+         empty_taken ? "taken" : "ignored",
+         generic_taken ? "taken" : "ignored");
+  bench_expect(!empty_taken && generic_taken,
+               "vendor report len 0 taken %d, len 1 taken %d", empty_taken,
+               generic_taken);
+
+  // 処理コスト: チャンク1件の受信 (コールバック + 取込み) と、
+  // 5 サンプル/周期 (50us) を平均して再生する Core1 の1周期
+  bench_device_control_send(HID_DC_DEVICE_RESET);
+  bench_control_tick();
+  block = bench_start_custom(FFB_CUSTOM_PERIOD_MIN_US);
+  bench_control_tick();
+  static uint16_t seq;
+  seq = 0;
+  static uint8_t cost_block;
+  cost_block = block;
+  double ns = bench_run(100000, [](uint32_t) {
+    bench_send_chunk(cost_block, seq++);
+    hidwffb_process_reports(HID_RX_QUEUE_DEPTH);
+    // 6 周期でチャンク1件分 (30 サンプル) を消費する
+    for (uint8_t i = 0; i < 6; i++)
+      bench_sink = (uint32_t)bench_control_tick();
+  });
+  bench_print("1 chunk in + 6 Core1 ticks (50us)", ns,
+              FFB_CUSTOM_CHUNK_SAMPLES, "samples");
+  bench_device_control_send(HID_DC_DEVICE_RESET);
+  bench_control_tick();
+}
+
+// --- 高分解能入力 (Core1 の周期ごとのサンプルを1フレームにまとめて送る) ---
+
+/// @brief 通番 n のサンプルとして積む入力
+static custom_gamepad_report_t bench_hires_sample(uint32_t n) {
+  custom_gamepad_report_t input = {(int16_t)(n * 7), (int16_t)(n * 3),
+                                   (int16_t)(0 - n), 0};
+  return input;
+}
+
+// ホストが1フレームに受け取った高分解能入力レポート (送信順)
+static hidwffb_hires_report_t bench_hires_received[HID_HIRES_INTERFACES];
+static uint8_t bench_hires_count;
+
+static void bench_hires_hook(uint8_t report_id, uint8_t const *report,
+                             uint16_t len) {
+  if (report_id != HID_ID_HIRES_INPUT || len != sizeof(hidwffb_hires_report_t))
+    return;
+  if (bench_hires_count < HID_HIRES_INTERFACES)
+    memcpy(&bench_hires_received[bench_hires_count], report, len);
+  bench_hires_count++;
+}
+
+/**
+ * @brief Core1 (period_us ごとに 0..39us の揺らぎ) と Core0 (1ms ごと) を
+ * 模擬し、ホストが受け取ったサンプルの通番・時刻・値を照合する
+ * @param stall_frames 途中で Core0 が送信しないフレーム数
+ */
+static void bench_hires_stream(uint32_t period_us, uint32_t stall_frames) {
+  const uint32_t FRAMES = 20000;
+  const uint32_t ticks_per_frame = 1000 / period_us;
+  static uint32_t pushed_us[FRAMES * 8];
+  uint32_t pushed = 0, received = 0, mismatched = 0, lost = 0;
+  uint32_t reports = 0, max_pending = 0, max_age_us = 0, overflow = 0;
+  uint32_t next = 0; // ホストが次に期待する通番 (32bit へ展開)
+  uint32_t rng = 4321;
+  native_shim_set_input_hook(bench_hires_hook);
+  // 前回の試行の残りを捨て、1 サンプルを送って通番の起点を得る
+  while (hidwffb_send_hires_report())
+    ;
+  hidwffb_hires_push(0, bench_hires_sample(0), 0);
+  bench_hires_count = 0;
+  hidwffb_send_hires_report();
+  const uint16_t base = (uint16_t)(bench_hires_received[0].sequence + 1);
+
+  for (uint32_t f = 0; f < FRAMES; f++) {
+    uint32_t frame_us = f * 1000;
+    for (uint32_t k = 0; k < ticks_per_frame; k++) {
+      rng = rng * 1103515245u + 12345u;
+      pushed_us[pushed] = frame_us + k * period_us + (rng >> 16) % 40;
+      hidwffb_hires_push(pushed_us[pushed], bench_hires_sample(pushed),
+                         (int16_t)(pushed * 11));
+      pushed++;
+    }
+    if (f >= FRAMES / 2 && f < FRAMES / 2 + stall_frames)
+      continue; // Core0 の遅延 (このフレームは送らない)
+    bench_hires_count = 0;
+    hidwffb_send_hires_report();
+    if (bench_hires_count > HID_HIRES_INTERFACES)
+      overflow++; // 1フレームにインタフェース数を超えて送った
+
+    // ホスト: 先頭サンプルの通番から欠落を数え、時刻と値を照合する
+    for (uint8_t r = 0; r < bench_hires_count && r < HID_HIRES_INTERFACES;
+         r++) {
+      const hidwffb_hires_report_t &report = bench_hires_received[r];
+      reports++;
+      uint32_t first =
+          next + (uint16_t)(report.sequence - base - (uint16_t)next);
+      lost += first - next;
+      if (report.pending > max_pending)
+        max_pending = report.pending;
+      for (uint8_t i = 0; i < report.sampleCount; i++) {
+        uint32_t n = first + i;
+        const hidwffb_hires_sample_t &sample = report.samples[i];
+        custom_gamepad_report_t input = bench_hires_sample(n);
+        if (report.timestamp_us + sample.offset_us != pushed_us[n] ||
+            sample.steer != input.steer || sample.accel != input.accel ||
+            sample.brake != input.brake ||
+            sample.torque != (int16_t)(n * 11))
+          mismatched++;
+        // 送信したフレームの終わり (ホストが受け取る時刻) までの経過時間
+        uint32_t age_us = frame_us + 1000 - pushed_us[n];
+        if (age_us > max_age_us)
+          max_age_us = age_us;
+        received++;
+      }
+      next = first + report.sampleCount;
+    }
+  }
+  native_shim_set_input_hook(nullptr);
+  printf("%5u Hz, Core0 stall %2u ms: %u reports, %u/%u samples, lost %u, "
+         "mismatched %u, max pending %u, max age %u us\n",
+         1000000 / period_us, stall_frames, reports, received, pushed, lost,
+         mismatched, max_pending, max_age_us);
+  // 停止後の追い付きを含め、最後のフレームまでに全サンプルが届くこと
+  bench_expect(lost == 0 && mismatched == 0 && received == pushed &&
+                   overflow == 0,
+               "hires %u Hz, stall %u ms: lost %u, mismatched %u, received "
+               "%u/%u, over-sent frames %u",
+               1000000 / period_us, stall_frames, lost, mismatched, received,
+               pushed, overflow);
+}
+
+static void bench_hires_input(void) {
+  printf("\n[High-resolution input: %d samples / report, %d reports / frame]"
+         "\n",
+         HID_HIRES_MAX_SAMPLES, HID_HIRES_INTERFACES);
+  bench_hires_stream(250, 0);
+  bench_hires_stream(250, 6);
+  bench_hires_stream(125, 0);
+  bench_hires_stream(125, 6);
+
+  static const custom_gamepad_report_t input = {100, 200, 300, 0};
+  double ns = bench_run(1000000, [](uint32_t i) {
+    hidwffb_hires_push(i, input, 400);
+    if ((i & 7) == 7)
+      bench_sink = hidwffb_send_hires_report();
+  });
+  bench_print("8 Core1 pushes + 1 Core0 frame", ns * 8, 8, "samples");
+}
+
+// --- 6. 周期判定 ---
+static void bench_interval(void) {
+  printf("\n[Interval trigger]\n");
+  const uint32_t N = 1000000;
+  static IntervalTrigger_u trigger_u(1000);
+  static IntervalTrigger_m trigger_m(1);
+  trigger_u.init();
+  trigger_m.init();
+
+  double ns =
+      bench_run(N, [](uint32_t) { bench_sink = trigger_u.hasExpired(); });
+  bench_print("IntervalTrigger_u::hasExpired", ns, 0, "");
+  ns = bench_run(N, [](uint32_t) { bench_sink = trigger_m.hasExpired(); });
+  bench_print("IntervalTrigger_m::hasExpired", ns, 0, "");
+
+  static PeriodicTrigger_u trigger_p(250);
+  trigger_p.init();
+  ns = bench_run(N, [](uint32_t) { bench_sink = trigger_p.hasExpired(); });
+  bench_print("PeriodicTrigger_u::hasExpired", ns, 0, "");
+
+  // 約 1ms の停止後に続けて判定した場合の実行回数 (周期 250us)
+  const sched_policy_t policies[] = {SCHED_SKIP, SCHED_CATCH_UP};
+  const char *const names[] = {"skip", "catch-up"};
+  uint32_t bursts[2], skipped[2];
+  for (uint8_t p = 0; p < 2; p++) {
+    PeriodicTrigger_u trigger(250, policies[p], 2);
+    trigger.init();
+    while (!trigger.hasExpired()) {
+    }
+    // sleep は数百 us 超過することがあるため、次の予定時刻 + 1.1ms まで
+    // 待ち続けて遅れを揃える (両方とも 4 周期の遅れ)
+    const uint32_t until = trigger.lastDeadline() + 250 + 1100;
+    while ((int32_t)(micros() - until) < 0) {
+    }
+    uint32_t burst = 0;
+    for (uint8_t i = 0; i < 16; i++)
+      burst += trigger.hasExpired() ? 1 : 0;
+    const sched_stats_t &st = trigger.stats();
+    printf("stall 1.1ms (%s): burst=%lu runs=%lu overruns=%lu skipped=%lu "
+           "late_max=%luus\n",
+           names[p], (unsigned long)burst, (unsigned long)st.runs,
+           (unsigned long)st.overruns, (unsigned long)st.skipped,
+           (unsigned long)st.late_max_us);
+    bursts[p] = burst;
+    skipped[p] = st.skipped;
+  }
+  // SKIP は1回だけ実行して残りを捨て、CATCH_UP は続けて追い付く
+  bench_expect(bursts[0] == 1 && skipped[0] > 0,
+               "interval skip: burst %lu, skipped %lu",
+               (unsigned long)bursts[0], (unsigned long)skipped[0]);
+  bench_expect(bursts[1] > 1 && skipped[1] < skipped[0],
+               "interval catch-up: burst %lu, skipped %lu (skip: %lu)",
+               (unsigned long)bursts[1], (unsigned long)skipped[1],
+               (unsigned long)skipped[0]);
+}
+
+// --- USB SOF 位相同期 (仮想 SOF によるシミュレーション) ---
+/**
+ * @brief ホストの SOF と Core0 の周期実行を仮想時刻で模擬する
+ * @param ppm ホストの SOF 周期の偏差 (USB の許容範囲は ±500ppm)
+ * @param lock false の場合は従来どおり自走させる
+ *
+ * Core0 は予定時刻に実行を開始し、body_us 後に入力を取得して送信する。
+ * SOF の観測 (tud_sof_cb) は USB タスクの遅れ 0..15us を含み、
+ * Core0 の処理中に届いた場合は処理の終了まで遅れる。
+ * 入力の経過時間は「SOF 時点で送信済みの最新の入力を取得してから」の時間。
+ */
+static void sof_simulate(int32_t ppm, bool lock) {
+  const uint32_t FRAMES = 20000;
+  const uint32_t SETTLE = 1000; ///< 統計から除く開始直後のフレーム数
+  const uint32_t PERIOD = 1000;
+  const uint32_t BODY_US = 60;
+  const uint32_t WINDOW_US = 20;  ///< 同期状態とみなす位相誤差
+  const uint32_t SPREAD_US = 32;  ///< 同期時に許容する経過時間の幅
+  SofPhaseLock sof_lock(PERIOD, 200, 2, 50, WINDOW_US);
+
+  uint32_t rng = 12345;
+  uint32_t next_run = 0;                    ///< Core0 の次の予定時刻 [us]
+  uint32_t sample_us = 0, prev_sample = 0;  ///< 入力の取得時刻
+  uint64_t sof_ns = 137 * 1000;             ///< 初期位相は任意
+  uint32_t locked_at = 0;
+  uint32_t age_min = UINT32_MAX, age_max = 0;
+  uint64_t age_sum = 0;
+
+  for (uint32_t frame = 0; frame < FRAMES; frame++) {
+    uint32_t sof_us = (uint32_t)(sof_ns / 1000);
+    // SOF までの Core0 の周期実行
+    while ((int32_t)(next_run - sof_us) <= 0) {
+      prev_sample = sample_us;
+      sample_us = next_run + BODY_US;
+      next_run += PERIOD;
+    }
+    // SOF 時点で送信済みの入力 (取得が SOF より後なら1つ前の入力)
+    uint32_t sent = ((int32_t)(sample_us - sof_us) <= 0) ? sample_us
+                                                          : prev_sample;
+    uint32_t age = sof_us - sent;
+    if (frame >= SETTLE) {
+      age_sum += age;
+      age_min = (age < age_min) ? age : age_min;
+      age_max = (age > age_max) ? age : age_max;
+    }
+
+    // tud_sof_cb による観測 (Core0 の処理中は終了まで遅れる)
+    uint32_t observed = sof_us;
+    uint32_t last_run = next_run - PERIOD;
+    if ((int32_t)(sof_us - last_run) >= 0 &&
+        (int32_t)(sof_us - (last_run + BODY_US)) < 0)
+      observed = last_run + BODY_US;
+    rng = rng * 1664525u + 1013904223u;
+    observed += (rng >> 16) % 16;
+    if (lock) {
+      next_run += (uint32_t)sof_lock.update(observed, last_run, sent);
+      if (locked_at == 0 && sof_lock.locked())
+        locked_at = frame;
+    }
+    sof_ns += (uint64_t)(1000000 + ppm); // 1フレーム [ns]
+  }
+
+  uint32_t n = FRAMES - SETTLE;
+  printf("%-9s %+5ldppm: age mean=%4lluus min=%4luus max=%4luus",
+         lock ? "sof lock" : "free-run", (long)ppm,
+         (unsigned long long)(age_sum / n), (unsigned long)age_min,
+         (unsigned long)age_max);
+  if (lock)
+    printf("  locked@%lu err_max=%luus", (unsigned long)locked_at,
+           (unsigned long)sof_lock.stats().phase_err_max);
+  printf("\n");
+  if (!lock)
+    return;
+  bench_expect(locked_at != 0 && locked_at < 100,
+               "SOF lock %+ldppm: locked at frame %lu", (long)ppm,
+               (unsigned long)locked_at);
+  bench_expect(sof_lock.stats().phase_err_max <= WINDOW_US,
+               "SOF lock %+ldppm: phase error %luus exceeds %luus",
+               (long)ppm, (unsigned long)sof_lock.stats().phase_err_max,
+               (unsigned long)WINDOW_US);
+  bench_expect(age_max - age_min <= SPREAD_US,
+               "SOF lock %+ldppm: input age spread %luus exceeds %luus",
+               (long)ppm, (unsigned long)(age_max - age_min),
+               (unsigned long)SPREAD_US);
+}
+
+static void bench_sof_sync(void) {
+  printf("\n[USB SOF phase lock (simulated host)]\n");
+  const int32_t ppms[] = {-500, 0, 500};
+  for (uint8_t i = 0; i < 3; i++) {
+    sof_simulate(ppms[i], false);
+    sof_simulate(ppms[i], true);
+  }
+}
+
+// --- ペダル ADC (記録したサンプル列の再生 / デシメーション) ---
+static void bench_pedal_adc(void) {
+  printf("\n[Pedal ADC decimation]\n");
+  // Core1 の1周期 (250us) あたりの変換数 (全チャネル合計)
+  const uint16_t PER_TICK = PEDAL_ADC_SAMPLE_RATE_HZ / 4000;
+  const uint32_t TICKS = 20000;
+  pedal_adc_begin(26, 27);
+  pedal_calibration_t cal = {1024, 64496, 512, 512};
+  pedal_adc_set_calibration(PEDAL_ACCEL, cal);
+  pedal_adc_set_calibration(PEDAL_BRAKE, cal);
+
+  // 模擬の記録: アクセルは 5 秒で全閉 -> 全開、ブレーキは中間で固定。
+  // いずれも ±24 LSB (12bit) の一様ノイズを含む
+  uint32_t rng = 1;
+  auto noisy = [&rng](int32_t v) {
+    rng = rng * 1664525u + 1013904223u;
+    v += (int32_t)((rng >> 16) % 49) - 24;
+    return (uint16_t)((v < 0) ? 0 : (v > 4095) ? 4095 : v);
+  };
+  static uint16_t stream[TICKS][PEDAL_ADC_SAMPLE_RATE_HZ / 4000];
+  for (uint32_t t = 0; t < TICKS; t++)
+    for (uint16_t i = 0; i < PER_TICK; i += 2) {
+      stream[t][i] = noisy((int32_t)(4095u * t / TICKS));
+      stream[t][i + 1] = noisy(2048);
+    }
+
+  // ノイズの無い入力 (16 サンプルの平均値) に対する軸の値
+  PedalChannel ideal;
+  ideal.setCalibration(cal);
+  const int32_t brake_ideal = ideal.scale(2048u << PEDAL_OVERSAMPLE_LOG2);
+
+  int16_t out[PEDAL_COUNT] = {0, 0};
+  int32_t brake_min = INT16_MAX, brake_max = INT16_MIN;
+  int32_t accel_prev = INT16_MIN, accel_backstep = 0;
+  int32_t accel_error_max = 0;
+  int64_t brake_sum = 0;
+  uint32_t reads = 0;
+  for (uint32_t t = 0; t < TICKS; t++) {
+    pedal_adc_inject(stream[t], PER_TICK);
+    if (!pedal_adc_read(out))
+      continue;
+    reads++;
+    brake_sum += out[PEDAL_BRAKE];
+    brake_min = (out[PEDAL_BRAKE] < brake_min) ? out[PEDAL_BRAKE] : brake_min;
+    brake_max = (out[PEDAL_BRAKE] > brake_max) ? out[PEDAL_BRAKE] : brake_max;
+    if (out[PEDAL_ACCEL] < accel_prev - 256)
+      accel_backstep++;
+    accel_prev = out[PEDAL_ACCEL];
+    int32_t accel_ideal =
+        ideal.scale((4095u * t / TICKS) << PEDAL_OVERSAMPLE_LOG2);
+    int32_t error = out[PEDAL_ACCEL] - accel_ideal;
+    error = (error < 0) ? -error : error;
+    accel_error_max = (error > accel_error_max) ? error : accel_error_max;
+  }
+  // 入力ノイズ ±24 LSB は、デシメーション無しでは軸の値で約 ±400 に相当。
+  // 16 サンプルの平均で標準偏差は 1/4 となるため、±300 以内に収まること
+  int32_t brake_mean = (int32_t)(brake_sum / (reads ? reads : 1));
+  printf("brake (fixed) output range: %ld..%ld, mean %ld (ideal %ld)\n",
+         (long)brake_min, (long)brake_max, (long)brake_mean,
+         (long)brake_ideal);
+  printf("accel ramp end: %d, steps back > 256: %ld, max |error| %ld\n",
+         out[PEDAL_ACCEL], (long)accel_backstep, (long)accel_error_max);
+  bench_expect(brake_max - brake_ideal <= 300 && brake_ideal - brake_min <= 300,
+               "brake noise %ld..%ld exceeds ideal %ld +-300",
+               (long)brake_min, (long)brake_max, (long)brake_ideal);
+  // 平均のずれは 12bit の 1 LSB (軸の値で約 17) 未満
+  bench_expect(brake_mean - brake_ideal <= 16 && brake_ideal - brake_mean <= 16,
+               "brake mean %ld differs from ideal %ld", (long)brake_mean,
+               (long)brake_ideal);
+  bench_expect(out[PEDAL_ACCEL] == PEDAL_AXIS_MAX && accel_backstep == 0 &&
+                   accel_error_max <= 300,
+               "accel ramp end %d, back steps %ld, error %ld",
+               out[PEDAL_ACCEL], (long)accel_backstep, (long)accel_error_max);
+
+  // ノイズの無い一定値では、16 サンプルが入れ替わった後は理想値と一致する
+  static uint16_t flat[PEDAL_ADC_SAMPLE_RATE_HZ / 4000];
+  for (uint16_t i = 0; i < PER_TICK; i += 2) {
+    flat[i] = 3000;
+    flat[i + 1] = 1000;
+  }
+  for (uint32_t t = 0; t < 4; t++)
+    pedal_adc_inject(flat, PER_TICK);
+  pedal_adc_read(out);
+  int16_t accel_flat = ideal.scale(3000u << PEDAL_OVERSAMPLE_LOG2);
+  int16_t brake_flat = ideal.scale(1000u << PEDAL_OVERSAMPLE_LOG2);
+  printf("flat input: accel %d (ideal %d), brake %d (ideal %d)\n",
+         out[PEDAL_ACCEL], accel_flat, out[PEDAL_BRAKE], brake_flat);
+  bench_expect(out[PEDAL_ACCEL] == accel_flat && out[PEDAL_BRAKE] == brake_flat,
+               "flat input decimated to %d / %d (ideal %d / %d)",
+               out[PEDAL_ACCEL], out[PEDAL_BRAKE], accel_flat, brake_flat);
+
+  double ns = bench_run(1000000, [](uint32_t) {
+    int16_t v[PEDAL_COUNT];
+    pedal_adc_read(v);
+    bench_sink = (uint32_t)v[0] + (uint32_t)v[1];
+  });
+  bench_print("pedal_adc_read (2 pedals)", ns, 0, "");
+}
+
+// --- 操舵軸エンコーダ (トレースの再生 / 多回転の展開) ---
+static void bench_steer_encoder(void) {
+  printf("\n[Steer encoder pipeline]\n");
+  const uint8_t BITS = 14;
+  const uint32_t CPR = 1u << BITS;
+  const uint32_t TICKS = 40000; ///< 4kHz で 10 秒
+
+  // 模擬の記録: ±1.4 回転の往復に、周期ごとに最大約 0.45 回転動く
+  // 高速区間 (展開できる上限付近) を含む。真の位置も保持して照合する
+  static int32_t truth[TICKS];
+  static uint16_t trace[TICKS];
+  int32_t pos = 5000;
+  for (uint32_t t = 0; t < TICKS; t++) {
+    if (t >= 30000 && t < 30400)
+      pos += (t < 30200) ? 7400 : -7400; // 高速区間
+    else
+      pos = 5000 + (int32_t)(1.4 * CPR * sin(2.0 * M_PI * t / 8000.0));
+    truth[t] = pos;
+    trace[t] = (uint16_t)((uint32_t)pos & (CPR - 1));
+  }
+
+  static TraceSteerSensor trace_sensor(trace, TICKS, BITS);
+  SteerSensor &sensor = trace_sensor;
+  static EncoderUnwrapper unwrapper(BITS);
+  static SteerMapper mapper(CPR, 900);
+  sensor.begin();
+  sensor.startRead();
+
+  // 再生: poll() は1周期前に startRead() したサンプルを返す
+  uint32_t mismatches = 0;
+  int32_t offset = 0;
+  int16_t steer_min = INT16_MAX, steer_max = INT16_MIN;
+  for (uint32_t t = 0; t < TICKS; t++) {
+    uint16_t angle;
+    bool valid = sensor.poll(&angle);
+    sensor.startRead();
+    if (!valid)
+      continue;
+    int32_t unwrapped = unwrapper.update(angle);
+    if (t == 0) {
+      offset = truth[0] - unwrapped;
+      mapper.setCenter(unwrapped);
+    }
+    if (unwrapped + offset != truth[t])
+      mismatches++;
+    int16_t steer = mapper.map(unwrapped);
+    steer_min = (steer < steer_min) ? steer : steer_min;
+    steer_max = (steer > steer_max) ? steer : steer_max;
+  }
+  printf("unwrap mismatches: %lu / %lu, steer range (900deg lock): %d..%d\n",
+         (unsigned long)mismatches, (unsigned long)TICKS, steer_min,
+         steer_max);
+  bench_expect(mismatches == 0, "encoder unwrap mismatched %lu samples",
+               (unsigned long)mismatches);
+  // ±1.4 回転は 900deg (±1.25 回転) のロックを超えるため両端に届く
+  bench_expect(steer_min == -32767 && steer_max == 32767,
+               "steer range %d..%d does not reach the lock", steer_min,
+               steer_max);
+
+  double ns = bench_run(1000000, [](uint32_t) {
+    SteerSensor &s = trace_sensor;
+    uint16_t angle;
+    if (s.poll(&angle))
+      bench_sink = (uint32_t)mapper.map(unwrapper.update(angle));
+    s.startRead();
+  });
+  bench_print("steer poll+start+unwrap+map", ns, 0, "");
+}
+
+// --- ボタン (一括読み取り / チャタリング除去 / 押下から送信までの遅れ) ---
+static void bench_buttons(void) {
+  printf("\n[Button debounce @ 4kHz, 5ms]\n");
+  // ボタン 0, 1: シフタ (即時押下), ボタン 2, 3: 通常 (押下/解放とも連続待ち)
+  static const uint8_t pins[] = {25, 24, 10, 11};
+  const uint8_t COUNT = sizeof(pins);
+  const uint32_t TICK_US = 250;
+  const uint32_t TICKS = 4000 * 120; ///< 120 秒
+  button_input_begin(pins, COUNT);
+  ButtonDebouncer debouncer(TICK_US, 5000, 0x0003);
+
+  // 模擬の波形: 押下/解放の直後に 0..3ms のチャタリング (周期ごとに
+  // ランダムなレベル)、その後 20..200ms 安定する
+  struct trace_t {
+    uint8_t phase;      ///< 0: 解放, 1: 押下時の跳ね, 2: 押下, 3: 解放時の跳ね
+    uint32_t remaining; ///< 現在の段階の残り周期数
+    bool level;         ///< 押下 = true
+    uint32_t contact;   ///< 最初に接触した周期
+    uint32_t presses;   ///< 押下の回数
+  } tr[4] = {};
+  uint32_t rng = 12345;
+  auto rand_u = [&rng](uint32_t n) {
+    rng = rng * 1664525u + 1013904223u;
+    return (rng >> 8) % n;
+  };
+  for (uint8_t b = 0; b < COUNT; b++)
+    tr[b].remaining = 80 + rand_u(720);
+
+  uint32_t edges[4] = {0, 0, 0, 0};
+  uint32_t releases[4] = {0, 0, 0, 0};
+  uint64_t latency_sum[4] = {0, 0, 0, 0};
+  uint32_t latency_max[4] = {0, 0, 0, 0};
+  uint64_t frame_sum[4] = {0, 0, 0, 0};
+  uint32_t frame_max[4] = {0, 0, 0, 0};
+  for (uint32_t t = 0; t < TICKS; t++) {
+    uint32_t levels = 0xFFFFFFFFu;
+    for (uint8_t b = 0; b < COUNT; b++) {
+      trace_t &x = tr[b];
+      if (x.remaining == 0) {
+        x.phase = (uint8_t)((x.phase + 1) & 3);
+        if (x.phase == 1 || x.phase == 3) {
+          x.remaining = 1 + rand_u(12); // 跳ね: 0.25..3ms
+          if (x.phase == 1) {
+            x.contact = t;
+            x.presses++;
+          }
+        } else {
+          x.remaining = 80 + rand_u(720);
+        }
+      }
+      // 跳ねの間はランダム、最後の周期で次の段階のレベルに落ち着く
+      if (x.phase == 1 || x.phase == 3)
+        x.level = (x.remaining == 1) ? (x.phase == 1) : (rand_u(2) != 0);
+      else
+        x.level = (x.phase == 2);
+      if (x.phase == 1 && t == x.contact)
+        x.level = true; // 接触の瞬間
+      x.remaining--;
+      if (x.level)
+        levels &= ~(1u << pins[b]);
+    }
+    button_input_inject(levels);
+    debouncer.update(button_input_sample());
+    uint16_t pressed = debouncer.pressed();
+    for (uint8_t b = 0; b < COUNT; b++) {
+      releases[b] += (debouncer.released() >> b) & 1u;
+      if ((pressed & (1u << b)) == 0)
+        continue;
+      edges[b]++;
+      uint32_t latency = t - tr[b].contact;
+      // Core0 は 1ms (4 周期) ごとに送信する: 次の送信までの周期数を加える
+      uint32_t frame = latency + ((4 - (t & 3)) & 3);
+      latency_sum[b] += latency;
+      frame_sum[b] += frame;
+      latency_max[b] = (latency > latency_max[b]) ? latency : latency_max[b];
+      frame_max[b] = (frame > frame_max[b]) ? frame : frame_max[b];
+    }
+  }
+  for (uint8_t b = 0; b < COUNT; b++) {
+    uint32_t n = (edges[b] > 0) ? edges[b] : 1;
+    printf("button %u (%s): presses %4lu, press edges %4lu, to state "
+           "mean %4.0f max %4lu us, to frame mean %4.0f max %4lu us\n",
+           b, (b < 2) ? "eager" : "lazy ", (unsigned long)tr[b].presses,
+           (unsigned long)edges[b], (double)latency_sum[b] * TICK_US / n,
+           (unsigned long)latency_max[b] * TICK_US,
+           (double)frame_sum[b] * TICK_US / n,
+           (unsigned long)frame_max[b] * TICK_US);
+    // 押下・解放とも跳ね 1 回につきエッジ 1 回。確定までの遅れは
+    // シフタが 0、通常のボタンは跳ね (最大 3ms) + 連続待ち 5ms 以内
+    uint32_t held = (debouncer.state() >> b) & 1u;
+    uint32_t latency_limit = (b < 2) ? 0 : 12 + 5000 / TICK_US;
+    bench_expect(edges[b] == tr[b].presses && releases[b] + held == edges[b],
+                 "button %u: presses %lu, press edges %lu, release edges %lu",
+                 b, (unsigned long)tr[b].presses, (unsigned long)edges[b],
+                 (unsigned long)releases[b]);
+    bench_expect(latency_max[b] <= latency_limit,
+                 "button %u: press latency %lu us exceeds %lu us", b,
+                 (unsigned long)latency_max[b] * TICK_US,
+                 (unsigned long)latency_limit * TICK_US);
+  }
+
+  double ns = bench_run(10000000, [&debouncer](uint32_t i) {
+    bench_sink = debouncer.update((uint16_t)(i * 0x9E37u));
+  });
+  bench_print("ButtonDebouncer::update (16 bits)", ns, 0, "");
+  ns = bench_run(10000000,
+                 [](uint32_t) { bench_sink = button_input_sample(); });
+  bench_print("button_input_sample (4 pins)", ns, 0, "");
+}
+
+// --- 固定小数点フィルタ (処理コスト / 群遅延 / ノイズ低減) ---
+static constexpr double FILTER_FS = 4000.0; ///< Core1 の周期
+static constexpr biquad_coeffs_t BENCH_LP_Q15 =
+    biquad_lowpass_q15(400.0, FILTER_FS);
+static constexpr biquad_coeffs_t BENCH_LP_Q31 =
+    biquad_lowpass_q31(400.0, FILTER_FS);
+static constexpr biquad_coeffs_t BENCH_NOTCH_Q31 =
+    biquad_notch_q31(50.0, FILTER_FS);
+static constexpr one_euro_coeffs_t BENCH_EURO_PEDAL =
+    one_euro_coeffs(FILTER_FS, 5.0, 0.001, 20.0);
+static constexpr one_euro_coeffs_t BENCH_EURO_STEER =
+    one_euro_coeffs(FILTER_FS, 5.0, 0.003, 20.0);
+
+/// @brief ホストの TSC (x86 以外は 0 を返し、サイクル数は表示しない)
+static inline uint64_t bench_cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+/**
+ * @brief 1つのフィルタを評価する (filter は int16_t -> int16_t)
+ * - 処理コスト: 1サンプルあたりのホスト TSC サイクル数と時間
+ * - 群遅延: 10Hz 正弦波 (振幅 8000) の入出力の位相差から求める
+ *   (メディアン/1€ は非線形のため、この振幅・周波数での実効値)
+ * - ステップ: 0 -> 8000 の段差で出力が 50% に達するまでのサンプル数
+ * - ノイズ: 一定値 + ±200 LSB の一様ノイズに対する出力/入力の標準偏差の比
+ */
+template <typename Filter>
+static void filter_report(const char *name, Filter make) {
+  const uint32_t N = 40000; ///< 10 秒 (10Hz で 100 周期)
+  const double F_SINE = 10.0;
+  const double w = 2.0 * M_PI * F_SINE / FILTER_FS;
+
+  // 群遅延: 後半 (過渡応答後) の入出力を直交復調して位相を比べる
+  auto f = make();
+  double in_i = 0, in_q = 0, out_i = 0, out_q = 0;
+  for (uint32_t n = 0; n < N; n++) {
+    int16_t x = (int16_t)lround(8000.0 * sin(w * n));
+    int16_t y = f.process(x);
+    if (n < N / 2)
+      continue;
+    in_i += x * cos(w * n);
+    in_q += x * sin(w * n);
+    out_i += y * cos(w * n);
+    out_q += y * sin(w * n);
+  }
+  // x = A sin(wn + φ) のとき φ = atan2(I, Q)。遅延 = (φ入力 - φ出力) / w
+  double lag = atan2(in_i, in_q) - atan2(out_i, out_q);
+  if (lag < -M_PI)
+    lag += 2.0 * M_PI;
+  double delay = lag / w;
+
+  // ステップ応答
+  f = make();
+  uint32_t step50 = 0;
+  for (uint32_t n = 0; n < 4000; n++)
+    if (f.process(8000) >= 4000) {
+      step50 = n;
+      break;
+    }
+
+  // ノイズ低減
+  f = make();
+  uint32_t rng = 1;
+  double in_sq = 0, out_sq = 0;
+  for (uint32_t n = 0; n < N; n++) {
+    rng = rng * 1664525u + 1013904223u;
+    int32_t noise = (int32_t)((rng >> 16) % 401) - 200;
+    int16_t y = f.process((int16_t)(1000 + noise));
+    if (n < N / 2)
+      continue;
+    in_sq += (double)noise * noise;
+    out_sq += (double)(y - 1000) * (y - 1000);
+  }
+
+  // 処理コスト (入力は事前に用意した正弦波 + ノイズ)
+  static int16_t input[4096];
+  for (uint32_t n = 0; n < 4096; n++)
+    input[n] = (int16_t)(8000.0 * sin(w * n) + (int32_t)(n * 37 % 401) - 200);
+  f = make();
+  const uint32_t ITER = 4000000;
+  uint32_t acc = 0;
+  uint64_t c0 = bench_cycles();
+  bench_clock::time_point t0 = bench_clock::now();
+  for (uint32_t n = 0; n < ITER; n++)
+    acc += (uint16_t)f.process(input[n & 4095]);
+  bench_clock::time_point t1 = bench_clock::now();
+  uint64_t c1 = bench_cycles();
+  bench_sink = acc;
+  double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  t1 - t0)
+                  .count() /
+              ITER;
+
+  printf("%-22s %5.1f cyc %5.2f ns/sample  delay %6.2f smp (%5.0f us)"
+         "  step50 %3lu  noise x%.3f\n",
+         name, (double)(c1 - c0) / ITER, ns, delay, delay * 1e6 / FILTER_FS,
+         (unsigned long)step50, sqrt(out_sq / in_sq));
+}
+
+/// @brief BiquadQ31 を int16_t -> int16_t で評価するための包み
+template <const biquad_coeffs_t &C> struct BiquadQ31Axis {
+  BiquadQ31<C> f;
+  int16_t process(int16_t x) { return f.process16(x); }
+};
+
+static void bench_filters(void) {
+  printf("\n[Fixed-point filters @ 4kHz]\n");
+  printf("(cyc = host TSC cycles; delay = group delay at 10Hz)\n");
+  filter_report("biquad Q15 LP 400Hz",
+                [] { return BiquadQ15<BENCH_LP_Q15>(); });
+  filter_report("biquad Q31 LP 400Hz",
+                [] { return BiquadQ31Axis<BENCH_LP_Q31>(); });
+  filter_report("biquad Q31 notch 50Hz",
+                [] { return BiquadQ31Axis<BENCH_NOTCH_Q31>(); });
+  filter_report("median 3", [] { return MedianFilter<int16_t, 3>(); });
+  filter_report("median 5", [] { return MedianFilter<int16_t, 5>(); });
+  filter_report("one-euro (pedal)",
+                [] { return OneEuroFilter<BENCH_EURO_PEDAL>(); });
+  filter_report("one-euro (steer)",
+                [] { return OneEuroFilter<BENCH_EURO_STEER>(); });
+}
+
+// --- テレメトリ (記録の積み込み / フレーム化して送信) ---
+static void bench_telemetry(void) {
+  printf("\n[Telemetry]\n");
+  const uint32_t N = 1000000;
+  static const tlm_pid_debug_t record = {0x05, 0, -1234, 255, 0, 1};
+
+  // 1ms 周期内で各コアが行う処理 (シリアルへは書き込まない)
+  double ns = bench_run(N, [](uint32_t) {
+    bench_sink = telemetry_emit(TLM_CORE0, TLM_TYPE_PID_DEBUG, &record,
+                                sizeof(record));
+    telemetry_drain(1);
+  });
+  bench_print("telemetry_emit + drain(1)", ns, 1, "frames");
+
+  tlm_stats_t stats;
+  telemetry_get_stats(TLM_CORE0, &stats);
+  printf("frames: %lu, dropped: %lu, high water: %u/%d, bytes: %lu\n",
+         (unsigned long)stats.frames_sent, (unsigned long)stats.dropped,
+         stats.high_water, TLM_RING_DEPTH,
+         (unsigned long)Serial.bytes_written);
+  bench_expect(stats.dropped == 0, "telemetry: %lu records dropped",
+               (unsigned long)stats.dropped);
+
+  // 送信した2フレームを PC 側と同じ手順でデコードし、内容と通し番号を確認
+  uint8_t raw[2][TLM_MAX_PAYLOAD + 5];
+  int16_t n[2];
+  for (uint8_t k = 0; k < 2; k++) {
+    telemetry_emit(TLM_CORE0, TLM_TYPE_PID_DEBUG, &record, sizeof(record));
+    Serial.last_write_len = 0;
+    telemetry_drain(1);
+    uint16_t len = (uint16_t)Serial.last_write_len;
+    n[k] = -1;
+    if (len >= 2 && len <= sizeof(raw[k]) + 1 &&
+        Serial.last_write[len - 1] == 0x00)
+      n[k] = cobs_decode(Serial.last_write, (uint16_t)(len - 1), raw[k]);
+    if (!bench_expect(n[k] == (int16_t)(3 + sizeof(record) + 2),
+                      "telemetry: frame %u decoded to %d bytes", k, n[k]))
+      return;
+    uint16_t crc = (uint16_t)(raw[k][n[k] - 2] | (raw[k][n[k] - 1] << 8));
+    bench_expect(crc16_ccitt(raw[k], (uint16_t)(n[k] - 2)) == crc &&
+                     raw[k][0] == TLM_TYPE_PID_DEBUG &&
+                     raw[k][1] == TLM_CORE0 &&
+                     memcmp(&raw[k][3], &record, sizeof(record)) == 0,
+                 "telemetry: frame %u CRC %04X, type %02X, core %u", k, crc,
+                 raw[k][0], raw[k][1]);
+  }
+  bench_expect(raw[1][2] == (uint8_t)(raw[0][2] + 1),
+               "telemetry: seq %u -> %u", raw[0][2], raw[1][2]);
+}
+
+// --- シリアルコマンド (HID 入力注入) ---
+/**
+ * @brief バイナリの HID 入力フレームを PC 側 (telemetry.py) と同じ手順で生成
+ * @param corrupt true の場合は CRC を壊す
+ * @return 先頭の区切りを含むフレーム長
+ */
+static uint16_t bench_serial_frame(const custom_gamepad_report_t &input,
+                                   bool corrupt, uint8_t *frame) {
+  uint8_t raw[1 + sizeof(custom_gamepad_report_t) + 2] = {
+      SERIAL_CMD_TYPE_HID_INPUT};
+  memcpy(&raw[1], &input, sizeof(input));
+  uint16_t crc = crc16_ccitt(raw, 1 + sizeof(input));
+  if (corrupt)
+    crc ^= 0x0001;
+  raw[1 + sizeof(input)] = (uint8_t)(crc & 0xFF);
+  raw[2 + sizeof(input)] = (uint8_t)(crc >> 8);
+  frame[0] = 0x00;
+  return (uint16_t)(1 + cobs_encode(raw, sizeof(raw), &frame[1]));
+}
+
+/// @brief バイト列を与え、最後に得られた NONE 以外の結果を返す
+static serial_cmd_result_t bench_serial_feed(SerialCommandParser &parser,
+                                             const uint8_t *data,
+                                             uint16_t len) {
+  serial_cmd_result_t last = SERIAL_CMD_NONE;
+  for (uint16_t i = 0; i < len; i++) {
+    serial_cmd_result_t r = parser.feed(data[i]);
+    if (r != SERIAL_CMD_NONE)
+      last = r;
+  }
+  return last;
+}
+
+static bool bench_same_input(const custom_gamepad_report_t &a,
+                             const custom_gamepad_report_t &b) {
+  return a.steer == b.steer && a.accel == b.accel && a.brake == b.brake &&
+         a.buttons == b.buttons;
+}
+
+static void bench_serial_command(void) {
+  printf("\n[Serial command parser]\n");
+  const uint32_t N = 200000;
+  static SerialCommandParser parser;
+  static const char text[] = "HID:S-12345,A32767,B-32767,BTN65535\n";
+  const custom_gamepad_report_t text_input = {-12345, 32767, -32767, 0xFFFF};
+  const custom_gamepad_report_t binary_input = {2345, -100, 500, 0x1234};
+  static uint8_t frame[COBS_ENCODED_MAX(11) + 2];
+  static uint16_t frame_len;
+  frame_len = bench_serial_frame(binary_input, false, frame);
+
+  double ns = bench_run(N, [](uint32_t) {
+    for (uint16_t i = 0; i < sizeof(text) - 1; i++)
+      bench_sink = parser.feed((uint8_t)text[i]);
+  });
+  bench_print("text HID: command", ns, 1, "cmds");
+  bench_expect(bench_same_input(parser.input(), text_input),
+               "serial: text input %d/%d/%d/%04X", parser.input().steer,
+               parser.input().accel, parser.input().brake,
+               parser.input().buttons);
+  ns = bench_run(N, [](uint32_t) {
+    for (uint16_t i = 0; i < frame_len; i++)
+      bench_sink = parser.feed(frame[i]);
+  });
+  bench_print("binary HID frame", ns, 1, "cmds");
+  bench_expect(bench_same_input(parser.input(), binary_input),
+               "serial: binary input %d/%d/%d/%04X", parser.input().steer,
+               parser.input().accel, parser.input().brake,
+               parser.input().buttons);
+  printf("errors: %lu, binary frame: %u bytes (1kHz = %u B/s)\n",
+         (unsigned long)parser.errorCount(), frame_len, frame_len * 1000u);
+  bench_expect(parser.errorCount() == 0, "serial: %lu errors on valid input",
+               (unsigned long)parser.errorCount());
+
+  // CRC 異常のフレームは破棄し、次のフレームで再同期する
+  uint8_t bad[COBS_ENCODED_MAX(11) + 2];
+  uint16_t bad_len = bench_serial_frame(text_input, true, bad);
+  serial_cmd_result_t r = bench_serial_feed(parser, bad, bad_len);
+  bench_expect(r == SERIAL_CMD_ERROR && parser.errorCount() == 1,
+               "serial: bad CRC result %d, errors %lu", r,
+               (unsigned long)parser.errorCount());
+  r = bench_serial_feed(parser, frame, frame_len);
+  bench_expect(r == SERIAL_CMD_HID_INPUT_BINARY &&
+                   bench_same_input(parser.input(), binary_input),
+               "serial: no resync after bad CRC (result %d)", r);
+
+  // 長すぎる行は改行まで読み捨て、次の行で再同期する
+  uint8_t line[SERIAL_CMD_LINE_MAX + 16];
+  memset(line, 'X', sizeof(line) - 1);
+  line[sizeof(line) - 1] = '\n';
+  r = bench_serial_feed(parser, line, sizeof(line));
+  bench_expect(r == SERIAL_CMD_ERROR && parser.errorCount() == 2,
+               "serial: long line result %d, errors %lu", r,
+               (unsigned long)parser.errorCount());
+  r = bench_serial_feed(parser, (const uint8_t *)text, sizeof(text) - 1);
+  bench_expect(r == SERIAL_CMD_HID_INPUT_TEXT &&
+                   bench_same_input(parser.input(), text_input),
+               "serial: no resync after long line (result %d)", r);
+  printf("bad CRC / long line: errors %lu, resynced\n",
+         (unsigned long)parser.errorCount());
+}
+
+// --- 遅延計測 (LATENCY_PROBE_ENABLE 時のみ) ---
+static void bench_latency_probe(void) {
+#ifdef LATENCY_PROBE_ENABLE
+  printf("\n[Latency probe]\n");
+  const uint32_t N = 1000000;
+  double ns = bench_run(N, [](uint32_t i) {
+    latency_record(LAT_LOOP1_BODY, i & 0x3FF, 1000);
+  });
+  bench_print("latency_record", ns, 0, "");
+
+  // 受信 -> Core1 取得までの各段階を記録させる
+  static FFB_Shared_State_t core1_effects[MAX_EFFECTS];
+  for (uint32_t i = 0; i < 1000; i++) {
+    native_shim_inject_report(HID_ID_SET_CONSTANT_FORCE,
+                              HID_REPORT_TYPE_OUTPUT,
+                              (const uint8_t *)&report_constant + 1,
+                              sizeof(report_constant) - 1);
+    hidwffb_process_reports(HID_RX_QUEUE_DEPTH);
+    ffb_core0_update_shared(NULL);
+    custom_gamepad_report_t input = {0, 0, 0, 0};
+    ffb_core1_update_shared(&input, core1_effects);
+    ffb_core0_get_input_report(&input);
+    hidwffb_send_report(&input);
+  }
+  latency_report_step(true);
+  for (uint8_t i = 0; i < LAT_PROBE_COUNT; i++)
+    latency_report_step(false);
+#endif
+}
+
+// --- 7. TripleBuffer 受け渡し (2スレッドで Core0/Core1 を模擬) ---
+typedef struct {
+  uint32_t sequence;
+  uint32_t written_us;
+  uint32_t words[MAX_EFFECTS * 2]; ///< すべて sequence と同値 (破損検出用)
+} bench_handoff_payload_t;
+
+/**
+ * @brief ライタ (period_us ごと、0 は連続) とリーダ (連続) のスレッドで
+ * 受け渡し、破損・逆行の無いこと、最後の公開を読めること、受け渡し遅延を判定
+ * @param max_handoff_us 受け渡し遅延の上限 (0: 判定しない)
+ */
+static void bench_handoff_threads(uint32_t period_us,
+                                  uint32_t max_handoff_us) {
+  static TripleBuffer<bench_handoff_payload_t> buffer;
+  std::atomic<bool> stop(false);
+  std::atomic<uint32_t> last_written(0);
+  const uint32_t RUN_MS = 300;
+  uint32_t retries_before = buffer.readRetries();
+  uint32_t seq_before = buffer.sequence();
+
+  std::thread writer([&]() {
+    uint32_t seq = buffer.sequence();
+    uint32_t next_us = micros();
+    while (!stop.load(std::memory_order_relaxed)) {
+      if (period_us != 0) {
+        if ((int32_t)(micros() - next_us) < 0)
+          continue;
+        next_us += period_us;
+      }
+      bench_handoff_payload_t *payload = buffer.beginWrite();
+      payload->sequence = ++seq;
+      payload->written_us = micros();
+      for (uint32_t &w : payload->words)
+        w = seq;
+      buffer.endWrite();
+      last_written.store(seq, std::memory_order_relaxed);
+    }
+  });
+
+  uint32_t reads = 0, torn = 0, backwards = 0, max_latency_us = 0;
+  uint32_t last_seq = buffer.read()->sequence;
+  uint32_t end_ms = millis() + RUN_MS;
+  while ((int32_t)(millis() - end_ms) < 0) {
+    // 読込は失敗しないため、バッファを直接検査する
+    const bench_handoff_payload_t *snapshot = buffer.read();
+    reads++;
+    for (uint32_t w : snapshot->words) {
+      if (w != snapshot->sequence) {
+        torn++;
+        break;
+      }
+    }
+    if (snapshot->sequence < last_seq)
+      backwards++;
+    if (snapshot->sequence > last_seq) {
+      uint32_t latency_us = micros() - snapshot->written_us;
+      if (latency_us > max_latency_us)
+        max_latency_us = latency_us;
+      last_seq = snapshot->sequence;
+    }
+  }
+  stop.store(true);
+  writer.join();
+  // ライタの停止後は、最後に公開した値を読めること
+  uint32_t final_seq = buffer.read()->sequence;
+  uint32_t retries = buffer.readRetries() - retries_before;
+
+  char name[32];
+  if (period_us == 0)
+    snprintf(name, sizeof(name), "writer continuous");
+  else
+    snprintf(name, sizeof(name), "writer every %u us", period_us);
+  printf("%-20s reads: %u, publishes: %u, reader retries: %u, torn: %u, "
+         "max handoff: %u us\n",
+         name, reads, final_seq - seq_before, retries, torn, max_latency_us);
+  bench_expect(torn == 0, "TripleBuffer (%s): %u torn reads", name, torn);
+  bench_expect(backwards == 0, "TripleBuffer (%s): %u stale reads", name,
+               backwards);
+  bench_expect(final_seq == last_written.load(),
+               "TripleBuffer (%s): last publish %u not readable (read %u)",
+               name, last_written.load(), final_seq);
+  bench_expect(max_handoff_us == 0 || max_latency_us <= max_handoff_us,
+               "TripleBuffer (%s): max handoff %u us > %u us", name,
+               max_latency_us, max_handoff_us);
+}
+
+static void bench_handoff(void) {
+  printf("\n[TripleBuffer handoff: writer/reader threads]\n");
+  // ホストのスレッドは時分割で動くため、遅延の上限はスケジューラの
+  // タイムスライスを含めた値とする (RP2040 では各コアが専有する)
+  bench_handoff_threads(0, 0);
+  bench_handoff_threads(250, 20000);
+}
+
+int main(void) {
+  printf("RP2040_USB_Gamepad native benchmark\n");
+  hidwffb_begin(1, true);
+  ffb_shared_memory_init();
+
+  bench_parse();
+  bench_core_sync();
+  bench_core1_tick();
+  bench_effect_pool();
+  bench_engine();
+  bench_waveform();
+  bench_envelope();
+  bench_timing();
+  bench_torque_mixer();
+  bench_effect_layout();
+  bench_device_control();
+  bench_custom_force();
+  bench_hires_input();
+  bench_interval();
+  bench_sof_sync();
+  bench_pedal_adc();
+  bench_steer_encoder();
+  bench_buttons();
+  bench_filters();
+  bench_telemetry();
+  bench_serial_command();
+  bench_latency_probe();
+  bench_handoff();
+
+  if (bench_failures != 0) {
+    printf("\n%u check(s) FAILED\n", bench_failures);
+    return 1;
+  }
+  printf("\nall checks passed\n");
+  return 0;
+}
+
+#endif // NATIVE_HOST
@@ -0,0 +1,145 @@
+/**
+ * @file pedal_adc.cpp
+ * @brief ペダルの ADC 取得 (DMA リングバッファ) の実装
+ */
+
+#include "pedal_adc.h"
+
+#ifndef NATIVE_HOST
+#include <hardware/adc.h>
+#include <hardware/dma.h>
+#endif
+
+#define PEDAL_ADC_FIRST_PIN 26 ///< ADC0 のピン (GP26..GP29 = ADC0..ADC3)
+#define PEDAL_ADC_CHANNELS 2   ///< リングに並ぶチャネル数
+
+static_assert(PEDAL_ADC_RING_LEN % PEDAL_ADC_CHANNELS == 0,
+              "リング長はチャネル数の倍数とすること");
+static_assert(PEDAL_ADC_RING_LEN >=
+                  (PEDAL_ADC_CHANNELS << PEDAL_OVERSAMPLE_LOG2) * 2,
+              "リングはデシメーションに使うサンプル数の2倍以上とすること");
+
+// DMA のリング (書込側のアドレスラップ) はリング長で整列している必要がある
+static volatile uint16_t pedal_ring[PEDAL_ADC_RING_LEN]
+    __attribute__((aligned(1u << PEDAL_ADC_RING_BITS)));
+static uint8_t pedal_slot[PEDAL_COUNT]; ///< ペダル -> リング内の並び順
+static PedalChannel pedal_channels[PEDAL_COUNT];
+static bool pedal_started = false;
+static bool pedal_primed = false; ///< デシメーションに必要な数が揃った
+
+#ifndef NATIVE_HOST
+static int pedal_dma_chan = -1;  ///< ADC FIFO -> リング
+static int pedal_ctrl_chan = -1; ///< 転送完了ごとに pedal_dma_chan を再始動
+static volatile uint16_t *pedal_ring_start = pedal_ring;
+
+/// @brief DMA の書込位置 (次に書き込まれるサンプルの番号)
+static inline uint16_t pedal_write_index(void) {
+  uintptr_t addr = (uintptr_t)dma_hw->ch[pedal_dma_chan].write_addr;
+  return (uint16_t)(((addr - (uintptr_t)pedal_ring) / sizeof(uint16_t)) &
+                    (PEDAL_ADC_RING_LEN - 1));
+}
+
+bool pedal_adc_begin(uint8_t accel_pin, uint8_t brake_pin) {
+  if (pedal_started || accel_pin == brake_pin ||
+      accel_pin < PEDAL_ADC_FIRST_PIN || accel_pin > PEDAL_ADC_FIRST_PIN + 3 ||
+      brake_pin < PEDAL_ADC_FIRST_PIN || brake_pin > PEDAL_ADC_FIRST_PIN + 3)
+    return false;
+  pedal_dma_chan = dma_claim_unused_channel(false);
+  pedal_ctrl_chan = dma_claim_unused_channel(false);
+  if (pedal_dma_chan < 0 || pedal_ctrl_chan < 0)
+    return false;
+
+  // ラウンドロビンは ADC チャネル番号の昇順に変換する
+  uint8_t accel_ch = accel_pin - PEDAL_ADC_FIRST_PIN;
+  uint8_t brake_ch = brake_pin - PEDAL_ADC_FIRST_PIN;
+  pedal_slot[PEDAL_ACCEL] = (accel_ch < brake_ch) ? 0 : 1;
+  pedal_slot[PEDAL_BRAKE] = (accel_ch < brake_ch) ? 1 : 0;
+
+  adc_init();
+  adc_gpio_init(accel_pin);
+  adc_gpio_init(brake_pin);
+  adc_select_input((accel_ch < brake_ch) ? accel_ch : brake_ch);
+  adc_set_round_robin((1u << accel_ch) | (1u << brake_ch));
+  adc_fifo_setup(true, true, 1, false, false); // DREQ 有効, 12bit のまま
+  adc_set_clkdiv(48000000.0f / PEDAL_ADC_SAMPLE_RATE_HZ - 1.0f);
+
+  // データ用: ADC FIFO -> リング (書込アドレスはリング長でラップ)
+  dma_channel_config data = dma_channel_get_default_config(pedal_dma_chan);
+  channel_config_set_transfer_data_size(&data, DMA_SIZE_16);
+  channel_config_set_read_increment(&data, false);
+  channel_config_set_write_increment(&data, true);
+  channel_config_set_ring(&data, true, PEDAL_ADC_RING_BITS);
+  channel_config_set_dreq(&data, DREQ_ADC);
+  channel_config_set_chain_to(&data, pedal_ctrl_chan);
+  dma_channel_configure(pedal_dma_chan, &data, pedal_ring, &adc_hw->fifo,
+                        PEDAL_ADC_RING_LEN, false);
+
+  // 制御用: データ用の書込先を再設定して再始動する (転送数は自動で再ロード)
+  dma_channel_config ctrl = dma_channel_get_default_config(pedal_ctrl_chan);
+  channel_config_set_transfer_data_size(&ctrl, DMA_SIZE_32);
+  channel_config_set_read_increment(&ctrl, false);
+  channel_config_set_write_increment(&ctrl, false);
+  dma_channel_configure(pedal_ctrl_chan, &ctrl,
+                        &dma_hw->ch[pedal_dma_chan].al2_write_addr_trig,
+                        &pedal_ring_start, 1, false);
+
+  adc_fifo_drain();
+  dma_channel_start(pedal_dma_chan);
+  adc_run(true);
+  pedal_started = true;
+  return true;
+}
+#else
+// ホスト上では pedal_adc_inject() が DMA の代わりにリングへ書き込む
+static uint16_t pedal_native_index = 0;
+
+static inline uint16_t pedal_write_index(void) { return pedal_native_index; }
+
+bool pedal_adc_begin(uint8_t accel_pin, uint8_t brake_pin) {
+  if (pedal_started || accel_pin == brake_pin)
+    return false;
+  pedal_slot[PEDAL_ACCEL] = (accel_pin < brake_pin) ? 0 : 1;
+  pedal_slot[PEDAL_BRAKE] = (accel_pin < brake_pin) ? 1 : 0;
+  pedal_started = true;
+  return true;
+}
+
+void pedal_adc_inject(const uint16_t *samples, uint16_t count) {
+  for (uint16_t i = 0; i < count; i++) {
+    pedal_ring[pedal_native_index] = samples[i];
+    pedal_native_index =
+        (uint16_t)((pedal_native_index + 1) & (PEDAL_ADC_RING_LEN - 1));
+  }
+}
+#endif
+
+bool pedal_adc_read_raw(uint16_t raw[PEDAL_COUNT]) {
+  if (!pedal_started)
+    return false;
+  uint16_t end = pedal_write_index();
+  if (!pedal_primed) {
+    // 起動直後はリングの先頭から書かれるため、位置で揃ったことを判定できる
+    if (end < (PEDAL_ADC_CHANNELS << PEDAL_OVERSAMPLE_LOG2))
+      return false;
+    pedal_primed = true;
+  }
+  for (uint8_t p = 0; p < PEDAL_COUNT; p++)
+    raw[p] = (uint16_t)pedal_decimate(pedal_ring, PEDAL_ADC_RING_LEN - 1, end,
+                                      pedal_slot[p], PEDAL_ADC_CHANNELS);
+  return true;
+}
+
+bool pedal_adc_read(int16_t out[PEDAL_COUNT]) {
+  uint16_t raw[PEDAL_COUNT];
+  if (!pedal_adc_read_raw(raw))
+    return false;
+  for (uint8_t p = 0; p < PEDAL_COUNT; p++)
+    out[p] = pedal_channels[p].scale(raw[p]);
+  return true;
+}
+
+void pedal_adc_set_calibration(pedal_id_t pedal,
+                               const pedal_calibration_t &calibration) {
+  if (pedal < PEDAL_COUNT)
+    pedal_channels[pedal].setCalibration(calibration);
+}
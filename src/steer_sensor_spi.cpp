@@ -0,0 +1,99 @@
+/**
+ * @file steer_sensor_spi.cpp
+ * @brief SPI 接続の操舵軸エンコーダの DMA 取得の実装
+ */
+
+#include "steer_sensor_spi.h"
+
+#ifndef NATIVE_HOST
+
+#include <hardware/dma.h>
+#include <hardware/gpio.h>
+#include <hardware/spi.h>
+#include <pico/platform.h>
+
+#define AS5047_CMD_READ_ANGLECOM 0xFFFF ///< 読出し + パリティ + 0x3FFF
+#define AS5047_ERROR_FLAG 0x4000        ///< 前フレームの異常
+#define AS5047_DATA_MASK 0x3FFF
+#define STEER_CS_SETUP_CYCLES 50 ///< CS 立下りから SCK まで (350ns 以上)
+#define STEER_CS_HIGH_CYCLES 50  ///< CS の High 期間 (tCSn 350ns 以上)
+
+bool SpiSteerSensor::begin() {
+  tx_chan = dma_claim_unused_channel(false);
+  rx_chan = dma_claim_unused_channel(false);
+  if (tx_chan < 0 || rx_chan < 0)
+    return false;
+
+  // 16bit フレーム, SPI モード1 (CPOL=0, CPHA=1)
+  spi_init(spi0, STEER_SPI_BAUD_HZ);
+  spi_set_format(spi0, 16, SPI_CPOL_0, SPI_CPHA_1, SPI_MSB_FIRST);
+  gpio_set_function(sck, GPIO_FUNC_SPI);
+  gpio_set_function(tx, GPIO_FUNC_SPI);
+  gpio_set_function(rx, GPIO_FUNC_SPI);
+  gpio_init(cs);
+  gpio_set_dir(cs, GPIO_OUT);
+  gpio_put(cs, 1);
+
+  tx_word = AS5047_CMD_READ_ANGLECOM;
+  dma_channel_config tx_cfg = dma_channel_get_default_config(tx_chan);
+  channel_config_set_transfer_data_size(&tx_cfg, DMA_SIZE_16);
+  channel_config_set_read_increment(&tx_cfg, false);
+  channel_config_set_write_increment(&tx_cfg, false);
+  channel_config_set_dreq(&tx_cfg, spi_get_dreq(spi0, true));
+  dma_channel_configure(tx_chan, &tx_cfg, &spi_get_hw(spi0)->dr, &tx_word, 1,
+                        false);
+
+  dma_channel_config rx_cfg = dma_channel_get_default_config(rx_chan);
+  channel_config_set_transfer_data_size(&rx_cfg, DMA_SIZE_16);
+  channel_config_set_read_increment(&rx_cfg, false);
+  channel_config_set_write_increment(&rx_cfg, false);
+  channel_config_set_dreq(&rx_cfg, spi_get_dreq(spi0, false));
+  dma_channel_configure(rx_chan, &rx_cfg, &rx_word, &spi_get_hw(spi0)->dr, 1,
+                        false);
+  return true;
+}
+
+void SpiSteerSensor::startRead() {
+  if (busy || tx_chan < 0)
+    return;
+  // poll() で CS を上げた直後に呼ばれるため、High 期間を確保してから下げる
+  busy_wait_at_least_cycles(STEER_CS_HIGH_CYCLES);
+  gpio_put(cs, 0);
+  busy_wait_at_least_cycles(STEER_CS_SETUP_CYCLES);
+  // 読出し/書込アドレスは固定のため、転送数を再設定して同時に起動する
+  dma_channel_set_trans_count(rx_chan, 1, false);
+  dma_channel_set_trans_count(tx_chan, 1, false);
+  dma_start_channel_mask((1u << rx_chan) | (1u << tx_chan));
+  busy = true;
+}
+
+bool SpiSteerSensor::poll(uint16_t *angle) {
+  if (!busy || dma_channel_is_busy(rx_chan))
+    return false; // 16bit @ 4MHz は 4us で完了するため、通常は前周期に完了済み
+  gpio_put(cs, 1);
+  busy = false;
+
+  uint16_t word = rx_word;
+  if (discard) { // 初回は要求前の内容が返るため使用しない
+    discard = false;
+    return false;
+  }
+  if (__builtin_parity(word) != 0 || (word & AS5047_ERROR_FLAG) != 0) {
+    errors++;
+    return false;
+  }
+  *angle = word & AS5047_DATA_MASK;
+  return true;
+}
+
+#else // NATIVE_HOST
+
+// ホスト上には SPI が無いため常に取得失敗とする (TraceSteerSensor を使用)
+bool SpiSteerSensor::begin() { return false; }
+void SpiSteerSensor::startRead() {}
+bool SpiSteerSensor::poll(uint16_t *angle) {
+  (void)angle;
+  return false;
+}
+
+#endif // NATIVE_HOST
@@ -0,0 +1,104 @@
+/**
+ * @file telemetry.cpp
+ * @brief デバッグ情報のバイナリ送信の実装
+ */
+
+#include "telemetry.h"
+#include "cobs.h"
+#include "spsc_ring.h"
+#include <Arduino.h>
+#include <string.h>
+
+// リングへ積む記録 (未エンコード。エンコードは送信側の Core0 で行う)
+typedef struct {
+  uint8_t type;
+  uint8_t len;
+  uint8_t seq;
+  uint8_t payload[TLM_MAX_PAYLOAD];
+} tlm_record_t;
+
+// フレーム: COBS 前 = type, core, seq, payload, crc16 (2)
+static constexpr uint16_t TLM_RAW_MAX = 3 + TLM_MAX_PAYLOAD + 2;
+// COBS のオーバーヘッドと区切りの 0x00
+static constexpr uint16_t TLM_FRAME_MAX = COBS_ENCODED_MAX(TLM_RAW_MAX) + 1;
+
+// コアごとの単一プロデューサ/単一コンシューマ (Core0 の送信処理)
+static SpscRing<tlm_record_t, TLM_RING_DEPTH> tlm_rings[TLM_CORE_COUNT];
+static uint8_t tlm_seq[TLM_CORE_COUNT];         ///< プロデューサ側のみ更新
+static uint32_t tlm_frames_sent[TLM_CORE_COUNT]; ///< Core0 のみ更新
+static uint8_t tlm_next_core = 0; ///< 送信の順番 (ラウンドロビン)
+
+bool telemetry_emit(tlm_core_t core, uint8_t type, const void *payload,
+                    uint8_t len) {
+  if (core >= TLM_CORE_COUNT)
+    return false;
+  // 破棄した場合も番号は進め、PC 側で欠落を検出できるようにする
+  uint8_t seq = tlm_seq[core]++;
+  tlm_record_t *rec = tlm_rings[core].acquireWrite();
+  if (rec == NULL)
+    return false;
+  if (len > TLM_MAX_PAYLOAD)
+    len = TLM_MAX_PAYLOAD;
+  rec->type = type;
+  rec->len = len;
+  rec->seq = seq;
+  memcpy(rec->payload, payload, len);
+  tlm_rings[core].commitWrite();
+  return true;
+}
+
+bool telemetry_text(tlm_core_t core, const char *text) {
+  size_t len = strlen(text);
+  return telemetry_emit(core, TLM_TYPE_TEXT, text,
+                        (uint8_t)((len < TLM_MAX_PAYLOAD) ? len
+                                                          : TLM_MAX_PAYLOAD));
+}
+
+static uint16_t tlm_encode_frame(uint8_t core, const tlm_record_t *rec,
+                                 uint8_t *frame) {
+  uint8_t raw[TLM_RAW_MAX];
+  raw[0] = rec->type;
+  raw[1] = core;
+  raw[2] = rec->seq;
+  memcpy(&raw[3], rec->payload, rec->len);
+  uint16_t n = (uint16_t)(3 + rec->len);
+  uint16_t crc = crc16_ccitt(raw, n);
+  raw[n++] = (uint8_t)(crc & 0xFF);
+  raw[n++] = (uint8_t)(crc >> 8);
+  return cobs_encode(raw, n, frame);
+}
+
+uint16_t telemetry_drain(uint16_t max_frames) {
+  uint16_t sent = 0;
+  uint8_t idle_cores = 0;
+  while (sent < max_frames && idle_cores < TLM_CORE_COUNT) {
+    uint8_t core = tlm_next_core;
+    tlm_next_core = (uint8_t)((tlm_next_core + 1) % TLM_CORE_COUNT);
+
+    const tlm_record_t *rec = tlm_rings[core].front();
+    if (rec == NULL) {
+      idle_cores++;
+      continue;
+    }
+    // 送信バッファに1フレーム分の空きが無ければ次の周期へ持ち越す
+    if (Serial.availableForWrite() < (int)TLM_FRAME_MAX)
+      break;
+
+    uint8_t frame[TLM_FRAME_MAX];
+    uint16_t n = tlm_encode_frame(core, rec, frame);
+    tlm_rings[core].popFront();
+    Serial.write(frame, n);
+    tlm_frames_sent[core]++;
+    sent++;
+    idle_cores = 0;
+  }
+  return sent;
+}
+
+void telemetry_get_stats(tlm_core_t core, tlm_stats_t *stats) {
+  if (core >= TLM_CORE_COUNT || stats == NULL)
+    return;
+  stats->high_water = tlm_rings[core].highWater();
+  stats->dropped = tlm_rings[core].overflowCount();
+  stats->frames_sent = tlm_frames_sent[core];
+}
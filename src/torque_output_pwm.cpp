@@ -0,0 +1,48 @@
+/**
+ * @file torque_output_pwm.cpp
+ * @brief PWM + 方向ピンによるトルク出力の実装
+ */
+
+#include "torque_output_pwm.h"
+
+#ifndef NATIVE_HOST
+
+#include <hardware/clocks.h>
+#include <hardware/gpio.h>
+#include <hardware/pwm.h>
+
+bool PwmTorqueOutput::begin() {
+  // 出力を有効にする前に方向ピンとデューティ比 0 を確定させる
+  gpio_init(dir);
+  gpio_set_dir(dir, GPIO_OUT);
+  gpio_put(dir, 0);
+
+  uint32_t top = clock_get_hz(clk_sys) / TORQUE_PWM_FREQ_HZ - 1;
+  wrap = (uint16_t)((top > 0xFFFF) ? 0xFFFF : top);
+  uint slice = pwm_gpio_to_slice_num(pwm);
+  pwm_config config = pwm_get_default_config();
+  pwm_config_set_wrap(&config, wrap);
+  pwm_init(slice, &config, false);
+  pwm_set_gpio_level(pwm, 0);
+  gpio_set_function(pwm, GPIO_FUNC_PWM);
+  pwm_set_enabled(slice, true);
+  started = true;
+  return true;
+}
+
+void PwmTorqueOutput::write(int16_t torque) {
+  if (!started)
+    return;
+  uint32_t magnitude = (uint32_t)((torque < 0) ? -(int32_t)torque : torque);
+  gpio_put(dir, torque > 0);
+  // |torque| (0..32767) -> 0..wrap。除算を避けるためシフトで換算する
+  pwm_set_gpio_level(pwm, (uint16_t)((magnitude * wrap) >> 15));
+}
+
+#else // NATIVE_HOST
+
+// ホスト上には PWM が無いため常に初期化失敗とする (CaptureTorqueOutput を使用)
+bool PwmTorqueOutput::begin() { return false; }
+void PwmTorqueOutput::write(int16_t torque) { (void)torque; }
+
+#endif // NATIVE_HOST
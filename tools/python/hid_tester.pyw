@@ -6,6 +6,7 @@ import serial.tools.list_ports
 import threading
 import struct
 import time
+from telemetry import TelemetryDecoder, encode_hid_input
 
 # UIのテーマ設定
 ctk.set_appearance_mode("Dark")
@@ -102,6 +103,10 @@ class HIDTesterApp(ctk.CTk):
             chk.grid(row=i//4, column=i%4, padx=5, pady=2, sticky="w")
             self.btn_vars.append(var)
 
+        # バイナリ形式 (COBS+CRC) で送信する
+        self.binary_var = tk.BooleanVar(value=True)
+        ctk.CTkCheckBox(frame, text="Binary command", variable=self.binary_var).pack(anchor="w", padx=5, pady=(5, 0))
+
     def setup_monitor_ui(self, parent):
         # リアルタイム数値表示
         mon_frame = self.create_section_frame(parent, "HID Input Monitor (Received from Device)")
@@ -213,18 +218,23 @@ class HIDTesterApp(ctk.CTk):
         for i, var in enumerate(self.btn_vars):
             if var.get(): btns |= (1 << i)
         
-        cmd = f"HID:S{s},A{a},B{b},BTN{btns}\n"
+        if self.binary_var.get():
+            cmd = encode_hid_input(s, a, b, btns)
+        else:
+            cmd = f"HID:S{s},A{a},B{b},BTN{btns}\n".encode()
         try:
-            self.serial_inst.write(cmd.encode())
+            self.serial_inst.write(cmd)
         except:
             pass
 
     def serial_read_task(self):
+        # デバイスのログはバイナリのテレメトリフレーム (telemetry.py でデコード)
+        decoder = TelemetryDecoder()
         while self.running:
             if self.serial_inst and self.serial_inst.is_open:
                 try:
-                    l = self.serial_inst.readline().decode('utf-8', errors='ignore').strip()
-                    if l: self.add_log(f"[DEV] {l}")
+                    data = self.serial_inst.read(self.serial_inst.in_waiting or 1)
+                    for l in decoder.feed(data): self.add_log(f"[DEV] {l}")
                 except: pass
             time.sleep(0.01)
 
@@ -6,6 +6,7 @@ import serial.tools.list_ports
 import threading
 import struct
 import time
+from telemetry import TelemetryDecoder
 
 # UIのテーマ設定
 ctk.set_appearance_mode("Dark")
@@ -296,11 +297,13 @@ class PIDTesterApp(ctk.CTk):
         self.add_log("Disconnected.")
 
     def serial_read_task(self):
+        # デバイスのログはバイナリのテレメトリフレーム (telemetry.py でデコード)
+        decoder = TelemetryDecoder()
         while self.running:
             if self.serial_inst and self.serial_inst.is_open:
                 try:
-                    line = self.serial_inst.readline().decode('utf-8', errors='ignore').strip()
-                    if line:
+                    data = self.serial_inst.read(self.serial_inst.in_waiting or 1)
+                    for line in decoder.feed(data):
                         self.add_log(f"  [DEVICE] {line}")
                 except:
                     pass
@@ -0,0 +1,174 @@
+"""
+デバイスのテレメトリ (バイナリ) ストリームのデコーダ、
+および HID 入力注入コマンド (バイナリ) のエンコーダ
+
+フレーム形式 (include/telemetry.h と同一):
+    COBS( type | core | seq | payload | crc16(LE) ) | 0x00
+  - crc16: CRC-16/CCITT-FALSE (多項式 0x1021, 初期値 0xFFFF)
+  - seq: コアごとの通し番号。欠落は破棄された記録を示す
+
+各記録は従来の Serial.print と同じ形式の文字列 ([PID_DEBUG] ...) に変換する。
+"""
+import struct
+
+TLM_TYPE_TEXT = 0x01
+TLM_TYPE_PID_DEBUG = 0x02
+TLM_TYPE_CORE1_DEBUG = 0x03
+TLM_TYPE_LATENCY = 0x04
+TLM_TYPE_SCHED = 0x05
+TLM_TYPE_SOF_LOCK = 0x06
+TLM_TYPE_MIXER = 0x07
+
+# include/serial_command.h の SERIAL_CMD_TYPE_HID_INPUT
+SERIAL_CMD_TYPE_HID_INPUT = 0x10
+
+# include/latency_probe.h の latency_probe_t と同じ順序
+LATENCY_PROBE_NAMES = [
+    "rx_to_dispatch", "dispatch_to_publish", "publish_to_core1",
+    "usb_to_core1", "sensor_to_host", "loop0_body", "loop1_body",
+]
+
+OP_NAMES = {1: "Start", 2: "Solo", 3: "Stop"}
+
+
+def crc16_ccitt(data, crc=0xFFFF):
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if (crc & 0x8000) else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_decode(data):
+    """COBS デコード (区切りの 0x00 を含まないこと)。不正な場合 None"""
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            return None
+        out += data[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def cobs_encode(data):
+    """COBS エンコード (区切りの 0x00 は含まない)"""
+    out = bytearray()
+    block = bytearray()
+    for b in data:
+        if b == 0:
+            out.append(len(block) + 1)
+            out += block
+            block = bytearray()
+        else:
+            block.append(b)
+            if len(block) == 0xFE:
+                out.append(0xFF)
+                out += block
+                block = bytearray()
+    out.append(len(block) + 1)
+    out += block
+    return bytes(out)
+
+
+def encode_hid_input(steer, accel, brake, buttons):
+    """HID 入力注入コマンド (バイナリ) を生成する: 0x00 | COBS(...) | 0x00"""
+    body = struct.pack("<BhhhH", SERIAL_CMD_TYPE_HID_INPUT, steer, accel, brake, buttons)
+    body += struct.pack("<H", crc16_ccitt(body))
+    return b"\x00" + cobs_encode(body) + b"\x00"
+
+
+def format_record(rtype, core, payload):
+    """記録を表示用の文字列に変換する"""
+    if rtype == TLM_TYPE_TEXT:
+        return payload.decode("utf-8", errors="replace")
+
+    if rtype == TLM_TYPE_PID_DEBUG and len(payload) >= 7:
+        rid, is_const, mag, dev_gain, op, idx = struct.unpack("<BBhBBB", payload[:7])
+        if rid == 0x01:
+            kind = "Constant" if is_const else "Unknown"
+            return f"[PID_DEBUG] ID:0x01, Type:{kind}, Mag:{mag}, Gain:{dev_gain}"
+        if rid == 0x05:
+            return f"[PID_DEBUG] ID:0x05, Mag:{mag}"
+        if rid == 0x0A:
+            return f"[PID_DEBUG] ID:0x0A, Index:{idx}, Op:{OP_NAMES.get(op, op)}"
+        if rid == 0x0D:
+            return f"[PID_DEBUG] ID:0x0D, G:{dev_gain}"
+        return f"[PID_DEBUG] ID:0x{rid:02X}"
+
+    if rtype == TLM_TYPE_CORE1_DEBUG and len(payload) >= 3:
+        mag, cool_back = struct.unpack("<hB", payload[:3])
+        return f"[CORE1_DEBUG] Mag:{mag}, CoolBack:{cool_back}"
+
+    if rtype == TLM_TYPE_LATENCY and len(payload) >= 21:
+        probe, n, max_us, p50, p99, over = struct.unpack("<BIIIII", payload[:21])
+        name = LATENCY_PROBE_NAMES[probe] if probe < len(LATENCY_PROBE_NAMES) else str(probe)
+        return f"[LAT] {name} n={n} max={max_us}us p50<={p50}us p99<={p99}us over={over}"
+
+    if rtype == TLM_TYPE_SCHED and len(payload) >= 22:
+        period, runs, overruns, skipped, late_max, late_mean = struct.unpack("<HIIIII", payload[:22])
+        return (f"[SCHED] core{core} period={period}us runs={runs} overruns={overruns} "
+                f"skipped={skipped} late max={late_max}us mean={late_mean}us")
+
+    if rtype == TLM_TYPE_SOF_LOCK and len(payload) >= 17:
+        locked, err, err_max, sofs, locked_sofs, age_mean, age_max = struct.unpack("<BhHIIHH", payload[:17])
+        return (f"[SOF] core{core} locked={locked} err={err}us err_max={err_max}us sof={sofs} "
+                f"locked_sof={locked_sofs} age mean={age_mean}us max={age_max}us")
+
+    if rtype == TLM_TYPE_MIXER and len(payload) >= 24:
+        ticks, overflow, soft, clipped, slew, peak, torque = struct.unpack("<IIIIIHh", payload[:24])
+        return (f"[MIXER] ticks={ticks} overflow={overflow} soft_clip={soft} clip={clipped} "
+                f"slew={slew} peak={peak} torque={torque}")
+
+    return f"[TLM] core{core} type=0x{rtype:02X} {payload.hex()}"
+
+
+class TelemetryDecoder:
+    """シリアルから読んだバイト列を順に与え、表示用の文字列を取り出す"""
+
+    def __init__(self):
+        self.buf = bytearray()
+        self.next_seq = {}
+        self.crc_errors = 0
+        self.dropped = 0
+
+    def feed(self, data):
+        """受信データを追加し、完成したフレームの文字列のリストを返す"""
+        self.buf += data
+        lines = []
+        while True:
+            end = self.buf.find(b"\x00")
+            if end < 0:
+                break
+            frame = bytes(self.buf[:end])
+            del self.buf[:end + 1]
+            if frame:
+                decoded = self.decode_frame(frame)
+                if decoded:
+                    lines.extend(decoded)
+        return lines
+
+    def decode_frame(self, frame):
+        raw = cobs_decode(frame)
+        if raw is None or len(raw) < 5:
+            self.crc_errors += 1
+            return None
+        body, crc = raw[:-2], struct.unpack("<H", raw[-2:])[0]
+        if crc16_ccitt(body) != crc:
+            self.crc_errors += 1
+            return None
+
+        rtype, core, seq = body[0], body[1], body[2]
+        lines = []
+        expected = self.next_seq.get(core)
+        if expected is not None and seq != expected:
+            lost = (seq - expected) & 0xFF
+            self.dropped += lost
+            lines.append(f"[TLM] core{core}: {lost} record(s) dropped")
+        self.next_seq[core] = (seq + 1) & 0xFF
+        lines.append(format_record(rtype, core, body[3:]))
+        return lines